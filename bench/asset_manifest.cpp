@@ -0,0 +1,178 @@
+#include <benchmark/benchmark.h>
+#include "asset_manifest.h"
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef HAVE_NLOHMANN_JSON
+
+#include "filefinder.h"
+#include "utils.h"
+#include <functional>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+// Tracks the live heap memory to compare the memory usage of the mappings
+static size_t allocated_bytes = 0;
+
+void* operator new(std::size_t size) {
+	// Keep the allocation size in front of the returned memory
+	auto* ptr = static_cast<std::max_align_t*>(std::malloc(size + sizeof(std::max_align_t)));
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	*reinterpret_cast<std::size_t*>(ptr) = size;
+	allocated_bytes += size;
+	return ptr + 1;
+}
+
+void operator delete(void* ptr) noexcept {
+	if (ptr) {
+		auto* base = static_cast<std::max_align_t*>(ptr) - 1;
+		allocated_bytes -= *reinterpret_cast<std::size_t*>(base);
+		std::free(base);
+	}
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	operator delete(ptr);
+}
+
+constexpr int num_dirs = 100;
+constexpr int num_files = 500;
+
+// An index.json (version 2) of a large game with 50000 files
+static std::string make_index_json() {
+	std::string out = R"({"metadata":{"version":2},"cache":{"_dirname":"","rpg_rt.ldb":"RPG_RT.ldb")";
+	for (int i = 0; i < num_dirs; ++i) {
+		auto dir = "Picture" + std::to_string(i);
+		out += ",\"" + Utils::LowerCase(dir) + "\":{\"_dirname\":\"" + dir + "\"";
+		for (int j = 0; j < num_files; ++j) {
+			auto file = "Image_" + std::to_string(j);
+			out += ",\"" + Utils::LowerCase(file) + "\":\"" + file + ".png\"";
+		}
+		out += "}";
+	}
+	out += "}}";
+	return out;
+}
+
+// The mapping that was built from the index.json before
+static std::unordered_map<std::string, std::string> parse_index_json(const std::string& data) {
+	using json = nlohmann::json;
+	std::unordered_map<std::string, std::string> file_mapping;
+
+	json j = json::parse(data, nullptr, false);
+
+	using fn = std::function<void(const json&, const std::string&)>;
+	fn parse = [&] (const json& obj, const std::string& path) {
+		std::string dirname;
+		if (obj.contains("_dirname") && obj["_dirname"].is_string()) {
+			dirname = obj["_dirname"].get<std::string>();
+		}
+		dirname = FileFinder::MakePath(path, dirname);
+
+		for (const auto& value : obj.items()) {
+			const auto& second = value.value();
+			if (second.is_object()) {
+				parse(second, dirname);
+			} else if (second.is_string()){
+				file_mapping[FileFinder::MakePath(Utils::LowerCase(dirname), value.key())] = FileFinder::MakePath(dirname, second.get<std::string>());
+			}
+		}
+	};
+	parse(j["cache"], "");
+
+	return file_mapping;
+}
+
+static void BM_IndexJsonLoad(benchmark::State& state) {
+	const auto data = make_index_json();
+	size_t memory = 0;
+
+	for (auto _: state) {
+		const size_t before = allocated_bytes;
+		auto file_mapping = parse_index_json(data);
+		memory = allocated_bytes - before;
+		benchmark::DoNotOptimize(file_mapping);
+	}
+
+	state.counters["memory_bytes"] = memory;
+}
+
+BENCHMARK(BM_IndexJsonLoad)->Unit(benchmark::kMillisecond);
+
+// Conversion on the client when only the index.json is deployed
+static void BM_ManifestFromJson(benchmark::State& state) {
+	const auto data = make_index_json();
+	size_t memory = 0;
+
+	for (auto _: state) {
+		const size_t before = allocated_bytes;
+		auto manifest = AssetManifest::FromJson(data);
+		memory = allocated_bytes - before;
+		benchmark::DoNotOptimize(manifest);
+	}
+
+	state.counters["memory_bytes"] = memory;
+}
+
+BENCHMARK(BM_ManifestFromJson)->Unit(benchmark::kMillisecond);
+
+// Loading a converted manifest
+static void BM_ManifestLoad(benchmark::State& state) {
+	const auto data = AssetManifest::FromJson(make_index_json())->GetData();
+	size_t memory = 0;
+
+	for (auto _: state) {
+		const size_t before = allocated_bytes;
+		auto manifest = AssetManifest::FromData(data);
+		memory = allocated_bytes - before;
+		benchmark::DoNotOptimize(manifest);
+	}
+
+	state.counters["memory_bytes"] = memory;
+}
+
+BENCHMARK(BM_ManifestLoad)->Unit(benchmark::kMillisecond);
+
+static std::vector<std::string> lookup_keys() {
+	std::vector<std::string> keys;
+	for (int i = 0; i < num_dirs; ++i) {
+		keys.push_back("picture" + std::to_string(i) + "/image_" + std::to_string(i * 3));
+	}
+	return keys;
+}
+
+static void BM_IndexJsonFind(benchmark::State& state) {
+	const auto file_mapping = parse_index_json(make_index_json());
+	const auto keys = lookup_keys();
+
+	for (auto _: state) {
+		for (const auto& key : keys) {
+			auto it = file_mapping.find(key);
+			benchmark::DoNotOptimize(it);
+		}
+	}
+}
+
+BENCHMARK(BM_IndexJsonFind);
+
+static void BM_ManifestFind(benchmark::State& state) {
+	const auto manifest = *AssetManifest::FromJson(make_index_json());
+	const auto keys = lookup_keys();
+
+	for (auto _: state) {
+		for (const auto& key : keys) {
+			auto value = manifest.Find(key);
+			benchmark::DoNotOptimize(value);
+		}
+	}
+}
+
+BENCHMARK(BM_ManifestFind);
+
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,289 @@
+#include <benchmark/benchmark.h>
+#include "audio_decoder.h"
+#include "audio_midi.h"
+#include "audio_offline.h"
+#include "audio_secache.h"
+#include "filesystem_stream.h"
+#include "output.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+
+// Real-time factor (rtf) is seconds of audio produced per second of wall time.
+// Allocations are reported per second of produced audio.
+//
+// WAV and MIDI input is generated, the other decoders need sample files
+// bench.ogg, bench.opus, bench.mp3 and bench.mod in the directory
+// passed through the EP_BENCH_AUDIO_DIR environment variable.
+
+static std::atomic<size_t> num_allocs { 0 };
+
+void* operator new(std::size_t size) {
+	++num_allocs;
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+constexpr int frequency = 44100;
+constexpr int block_frames = OfflineAudio::block_frames;
+
+static void PutLE(std::vector<uint8_t>& out, uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		out.push_back((value >> (i * 8)) & 0xFF);
+	}
+}
+
+static std::vector<uint8_t> MakeWav(int freq, int channels, double seconds) {
+	int frames = static_cast<int>(freq * seconds);
+	uint32_t data_size = frames * channels * 2;
+
+	std::vector<uint8_t> out;
+	out.insert(out.end(), { 'R', 'I', 'F', 'F' });
+	PutLE(out, 36 + data_size, 4);
+	out.insert(out.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+	PutLE(out, 16, 4);
+	PutLE(out, 1, 2);
+	PutLE(out, channels, 2);
+	PutLE(out, freq, 4);
+	PutLE(out, freq * channels * 2, 4);
+	PutLE(out, channels * 2, 2);
+	PutLE(out, 16, 2);
+	out.insert(out.end(), { 'd', 'a', 't', 'a' });
+	PutLE(out, data_size, 4);
+
+	for (int i = 0; i < frames; ++i) {
+		auto sample = static_cast<int16_t>(std::sin(i * 440.0 * 2 * M_PI / freq) * 12000);
+		for (int c = 0; c < channels; ++c) {
+			PutLE(out, static_cast<uint16_t>(sample), 2);
+		}
+	}
+	return out;
+}
+
+static void PutVarLen(std::vector<uint8_t>& out, uint32_t value) {
+	uint8_t bytes[4];
+	int n = 0;
+	do {
+		bytes[n++] = value & 0x7F;
+		value >>= 7;
+	} while (value);
+	while (n > 1) {
+		out.push_back(bytes[--n] | 0x80);
+	}
+	out.push_back(bytes[0]);
+}
+
+// 32 beats at 120 bpm: a chord, a bass line and a melody on three channels
+static std::vector<uint8_t> MakeMidi() {
+	std::vector<uint8_t> track;
+	auto event = [&](uint32_t delta, std::initializer_list<uint8_t> bytes) {
+		PutVarLen(track, delta);
+		track.insert(track.end(), bytes);
+	};
+
+	event(0, { 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20 });
+	event(0, { 0xC0, 0 });
+	event(0, { 0xC1, 33 });
+	event(0, { 0xC2, 73 });
+
+	const uint8_t roots[] = { 60, 65, 67, 60 };
+	for (int beat = 0; beat < 32; ++beat) {
+		uint8_t root = roots[(beat / 8) % 4];
+		uint8_t melody = root + 12 + (beat * 5) % 12;
+		event(0, { 0x90, root, 90 });
+		event(0, { 0x90, static_cast<uint8_t>(root + 4), 90 });
+		event(0, { 0x90, static_cast<uint8_t>(root + 7), 90 });
+		event(0, { 0x91, static_cast<uint8_t>(root - 24), 100 });
+		event(0, { 0x92, melody, 100 });
+		event(480, { 0x80, root, 0 });
+		event(0, { 0x80, static_cast<uint8_t>(root + 4), 0 });
+		event(0, { 0x80, static_cast<uint8_t>(root + 7), 0 });
+		event(0, { 0x81, static_cast<uint8_t>(root - 24), 0 });
+		event(0, { 0x82, melody, 0 });
+	}
+	event(0, { 0xFF, 0x2F, 0x00 });
+
+	std::vector<uint8_t> out = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0x01, 0xE0, 'M', 'T', 'r', 'k' };
+	for (int i = 3; i >= 0; --i) {
+		out.push_back((track.size() >> (i * 8)) & 0xFF);
+	}
+	out.insert(out.end(), track.begin(), track.end());
+	return out;
+}
+
+static std::vector<uint8_t> LoadSample(const char* name) {
+	const char* dir = std::getenv("EP_BENCH_AUDIO_DIR");
+	if (!dir) {
+		return {};
+	}
+	std::ifstream f(std::string(dir) + "/" + name, std::ios::binary);
+	return { std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+}
+
+static Filesystem_Stream::InputStream MakeStream(std::vector<uint8_t> data, std::string name) {
+	return Filesystem_Stream::InputStream(new Filesystem_Stream::InputMemoryStreamBuf(std::move(data)), std::move(name));
+}
+
+static void Report(benchmark::State& state, int64_t frames, size_t allocs) {
+	double seconds = static_cast<double>(frames) / frequency;
+	state.counters["rtf"] = benchmark::Counter(seconds, benchmark::Counter::kIsRate);
+	state.counters["allocs"] = benchmark::Counter(seconds > 0 ? allocs / seconds : 0);
+}
+
+static void DecodeLoop(benchmark::State& state, std::unique_ptr<AudioDecoderBase> dec, std::vector<uint8_t> data, const char* name) {
+	if (!dec || data.empty()) {
+		state.SkipWithError("Decoder or sample not available");
+		return;
+	}
+	if (!dec->Open(MakeStream(std::move(data), name))) {
+		state.SkipWithError("Open failed");
+		return;
+	}
+	dec->SetFormat(frequency, AudioDecoder::Format::S16, 2);
+	dec->SetLooping(true);
+	state.SetLabel(dec->GetType());
+
+	std::vector<uint8_t> buffer(block_frames * 4);
+	int64_t frames = 0;
+	size_t allocs = num_allocs;
+	for (auto _: state) {
+		int read = dec->Decode(buffer.data(), buffer.size());
+		benchmark::DoNotOptimize(buffer.data());
+		frames += read / 4;
+	}
+	Report(state, frames, num_allocs - allocs);
+}
+
+static void BM_DecodeFile(benchmark::State& state, const char* name) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto data = LoadSample(name);
+	std::unique_ptr<AudioDecoderBase> dec;
+	if (!data.empty()) {
+		auto is = MakeStream(data, name);
+		dec = AudioDecoder::Create(is);
+	}
+	DecodeLoop(state, std::move(dec), std::move(data), name);
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+static void BM_DecodeWav(benchmark::State& state) {
+	auto data = MakeWav(22050, 2, 10.0);
+	auto is = MakeStream(data, "bench.wav");
+	DecodeLoop(state, AudioDecoder::Create(is), std::move(data), "bench.wav");
+}
+
+BENCHMARK(BM_DecodeWav);
+
+BENCHMARK_CAPTURE(BM_DecodeFile, ogg, "bench.ogg");
+BENCHMARK_CAPTURE(BM_DecodeFile, opus, "bench.opus");
+BENCHMARK_CAPTURE(BM_DecodeFile, mp3, "bench.mp3");
+BENCHMARK_CAPTURE(BM_DecodeFile, xmp, "bench.mod");
+
+static void BM_DecodeMidi(benchmark::State& state, std::unique_ptr<AudioDecoderBase> (*create)(bool)) {
+	Output::SetLogLevel(LogLevel::Error);
+	DecodeLoop(state, create(true), MakeMidi(), "bench.mid");
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK_CAPTURE(BM_DecodeMidi, fmmidi, &MidiDecoder::CreateFmMidi);
+BENCHMARK_CAPTURE(BM_DecodeMidi, wildmidi, &MidiDecoder::CreateWildMidi);
+BENCHMARK_CAPTURE(BM_DecodeMidi, fluidsynth, &MidiDecoder::CreateFluidsynth);
+
+static void BM_MixSe(benchmark::State& state) {
+	const int num_se = state.range(0);
+	// Mono and 22050 Hz so that every channel goes through the resampler
+	const auto se_data = MakeWav(22050, 1, 10.0);
+	const int restart_frames = frequency * 5;
+
+	Game_ConfigAudio cfg;
+	OfflineAudio audio(cfg, frequency);
+
+	auto play = [&]() {
+		audio.SE_Stop();
+		std::vector<int16_t> flush(block_frames * 2);
+		audio.Render(flush.data(), block_frames);
+		for (int i = 0; i < num_se; ++i) {
+			auto se = AudioSeCache::GetCachedSe("bench_se");
+			if (!se) {
+				se = AudioSeCache::Create(MakeStream(se_data, "bench_se"), "bench_se");
+			}
+			audio.SE_Play(std::move(se), 100, 100 + i, 50);
+		}
+	};
+	play();
+
+	std::vector<int16_t> buffer(block_frames * 2);
+	int64_t frames = 0;
+	int played_frames = 0;
+	size_t allocs = 0;
+	size_t allocs_start = num_allocs;
+	for (auto _: state) {
+		if (played_frames >= restart_frames) {
+			state.PauseTiming();
+			allocs += num_allocs - allocs_start;
+			play();
+			played_frames = 0;
+			allocs_start = num_allocs;
+			state.ResumeTiming();
+		}
+		audio.Render(buffer.data(), block_frames);
+		benchmark::DoNotOptimize(buffer.data());
+		frames += block_frames;
+		played_frames += block_frames;
+	}
+	allocs += num_allocs - allocs_start;
+	Report(state, frames, allocs);
+}
+
+BENCHMARK(BM_MixSe)->Arg(1)->Arg(8)->Arg(31);
+
+static void BM_MixBgm(benchmark::State& state) {
+	Game_ConfigAudio cfg;
+	OfflineAudio audio(cfg, frequency);
+	audio.BGM_Play(MakeStream(MakeWav(22050, 2, 10.0), "bench.wav"), 100, 100, 0, 50);
+
+	std::vector<int16_t> buffer(block_frames * 2);
+	int64_t frames = 0;
+	size_t allocs = num_allocs;
+	for (auto _: state) {
+		audio.Render(buffer.data(), block_frames);
+		benchmark::DoNotOptimize(buffer.data());
+		frames += block_frames;
+	}
+	Report(state, frames, num_allocs - allocs);
+
+	if (const char* wav = std::getenv("EP_BENCH_AUDIO_WAV")) {
+		// Write the mixed output for listening tests
+		std::ofstream os(wav, std::ios::binary);
+		audio.RenderWav(os, std::chrono::seconds(5));
+	}
+}
+
+BENCHMARK(BM_MixBgm);
+
+BENCHMARK_MAIN();
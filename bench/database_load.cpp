@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "lazy_database.h"
+#include <lcf/data.h>
+#include <lcf/ldb/reader.h>
+#include <sstream>
+#include <vector>
+
+// A database with the size of a large fangame
+static std::string make_database(int num_commonevents) {
+	lcf::rpg::Database db;
+
+	db.actors.resize(50);
+	for (int i = 0; i < 50; ++i) {
+		db.actors[i].ID = i + 1;
+		db.actors[i].name = lcf::DBString("Actor" + std::to_string(i + 1));
+	}
+
+	db.commonevents.resize(num_commonevents);
+	for (int i = 0; i < num_commonevents; ++i) {
+		auto& ce = db.commonevents[i];
+		ce.ID = i + 1;
+		ce.name = lcf::DBString("CE" + std::to_string(i + 1));
+		for (int c = 0; c < 100; ++c) {
+			lcf::rpg::EventCommand com;
+			com.code = static_cast<int>(lcf::rpg::EventCommand::Code::ControlVars);
+			std::vector<int32_t> params = { 0, c, c, 0, 0, i };
+			com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+			ce.event_commands.push_back(com);
+		}
+	}
+
+	db.animations.resize(num_commonevents / 4);
+	for (size_t i = 0; i < db.animations.size(); ++i) {
+		auto& anim = db.animations[i];
+		anim.ID = i + 1;
+		anim.name = lcf::DBString("Animation" + std::to_string(i + 1));
+		anim.frames.resize(20);
+		for (auto& frame: anim.frames) {
+			frame.cells.resize(8);
+		}
+	}
+
+	std::stringstream ss;
+	lcf::LDB_Reader::Save(ss, db, "UTF-8");
+	return ss.str();
+}
+
+static void BM_DatabaseLoad(benchmark::State& state) {
+	const auto data = make_database(state.range(0));
+
+	for (auto _: state) {
+		std::istringstream is(data);
+		auto db = lcf::LDB_Reader::Load(is, "UTF-8");
+		benchmark::DoNotOptimize(db);
+	}
+}
+
+BENCHMARK(BM_DatabaseLoad)->Arg(500)->Arg(5000);
+
+static void BM_DatabaseLoadLazy(benchmark::State& state) {
+	const auto data = make_database(state.range(0));
+
+	for (auto _: state) {
+		std::istringstream is(data);
+		auto db = LazyDatabase::Load(is, "UTF-8");
+		benchmark::DoNotOptimize(db);
+	}
+
+	LazyDatabase::Clear();
+}
+
+BENCHMARK(BM_DatabaseLoadLazy)->Arg(500)->Arg(5000);
+
+static void BM_DatabaseLoadLazyAll(benchmark::State& state) {
+	const auto data = make_database(state.range(0));
+
+	for (auto _: state) {
+		std::istringstream is(data);
+		lcf::Data::data = std::move(*LazyDatabase::Load(is, "UTF-8"));
+		LazyDatabase::LoadPendingSections();
+		benchmark::DoNotOptimize(lcf::Data::data);
+	}
+
+	lcf::Data::Clear();
+}
+
+BENCHMARK(BM_DatabaseLoadLazyAll)->Arg(500)->Arg(5000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+#include "filefinder.h"
+#include "filesystem.h"
+#include "filesystem_stream.h"
+#include "output.h"
+#include <zlib.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+constexpr int num_entries = 4096;
+constexpr int large_size = 16 * 1024 * 1024;
+constexpr char zip_path[] = "bench_filesystem_zip.zip";
+
+template <typename T>
+static void put(std::string& out, T value) {
+	// ZIP is little endian
+	for (size_t i = 0; i < sizeof(T); ++i) {
+		out += static_cast<char>((value >> (i * 8)) & 0xFF);
+	}
+}
+
+static std::string deflate_raw(const std::string& data) {
+	std::string out(compressBound(data.size()), '\0');
+	z_stream zlib_stream = {};
+	deflateInit2(&zlib_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	zlib_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+	zlib_stream.avail_in = data.size();
+	zlib_stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+	zlib_stream.avail_out = out.size();
+	deflate(&zlib_stream, Z_FINISH);
+	out.resize(zlib_stream.total_out);
+	deflateEnd(&zlib_stream);
+	return out;
+}
+
+// An archive with many small files (like the ChipSet and CharSet folders of a game) and one large music file
+static void write_zip() {
+	std::string out;
+	std::string central;
+	int count = 0;
+
+	auto add = [&](const std::string& name, const std::string& data, bool compress) {
+		const std::string stored = compress ? deflate_raw(data) : data;
+		const uint32_t crc = crc32(0, reinterpret_cast<const Bytef*>(data.data()), data.size());
+		const uint32_t offset = out.size();
+		const uint16_t method = compress ? 8 : 0;
+
+		put<uint32_t>(out, 0x04034b50);
+		put<uint16_t>(out, 20);
+		put<uint16_t>(out, 0);
+		put<uint16_t>(out, method);
+		put<uint32_t>(out, 0);
+		put<uint32_t>(out, crc);
+		put<uint32_t>(out, stored.size());
+		put<uint32_t>(out, data.size());
+		put<uint16_t>(out, name.size());
+		put<uint16_t>(out, 0);
+		out += name;
+		out += stored;
+
+		put<uint32_t>(central, 0x02014b50);
+		put<uint16_t>(central, 20);
+		put<uint16_t>(central, 20);
+		put<uint16_t>(central, 0x800);
+		put<uint16_t>(central, method);
+		put<uint32_t>(central, 0);
+		put<uint32_t>(central, crc);
+		put<uint32_t>(central, stored.size());
+		put<uint32_t>(central, data.size());
+		put<uint16_t>(central, name.size());
+		put<uint16_t>(central, 0);
+		put<uint16_t>(central, 0);
+		put<uint16_t>(central, 0);
+		put<uint16_t>(central, 0);
+		put<uint32_t>(central, 0);
+		put<uint32_t>(central, offset);
+		central += name;
+		++count;
+	};
+
+	for (int i = 0; i < num_entries; ++i) {
+		add("game/Picture/pic" + std::to_string(i) + ".png", std::string(2048, static_cast<char>(i)), i % 2 == 0);
+	}
+
+	std::string large;
+	large.reserve(large_size);
+	while (large.size() < large_size) {
+		large += "music data " + std::to_string(large.size()) + "\n";
+	}
+	add("game/Music/large.ogg", large, true);
+
+	const uint32_t central_offset = out.size();
+	out += central;
+	put<uint32_t>(out, 0x06054b50);
+	put<uint16_t>(out, 0);
+	put<uint16_t>(out, 0);
+	put<uint16_t>(out, count);
+	put<uint16_t>(out, count);
+	put<uint32_t>(out, central.size());
+	put<uint32_t>(out, central_offset);
+	put<uint16_t>(out, 0);
+
+	std::ofstream(zip_path, std::ios_base::binary).write(out.data(), out.size());
+}
+
+static void BM_ZipCreate(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	write_zip();
+
+	for (auto _: state) {
+		auto fs = FileFinder::Root().Create(zip_path);
+		benchmark::DoNotOptimize(fs);
+	}
+
+	std::remove(zip_path);
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_ZipCreate);
+
+static void BM_ZipOpenEntries(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	write_zip();
+	auto fs = FileFinder::Root().Create(zip_path);
+
+	std::vector<std::string> names;
+	for (int i = 0; i < num_entries; ++i) {
+		names.push_back("game/Picture/pic" + std::to_string(i) + ".png");
+	}
+
+	char buf[64];
+	for (auto _: state) {
+		for (auto& name: names) {
+			auto is = fs.OpenInputStream(name);
+			is.read(buf, sizeof(buf));
+			benchmark::DoNotOptimize(buf);
+		}
+	}
+
+	std::remove(zip_path);
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_ZipOpenEntries);
+
+// Opening a large file and reading the header, e.g. to detect the audio format
+static void BM_ZipOpenLarge(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	write_zip();
+	auto fs = FileFinder::Root().Create(zip_path);
+
+	char buf[4096];
+	for (auto _: state) {
+		auto is = fs.OpenInputStream("game/Music/large.ogg");
+		is.read(buf, sizeof(buf));
+		is.seekg(0);
+		is.read(buf, sizeof(buf));
+		benchmark::DoNotOptimize(buf);
+	}
+
+	std::remove(zip_path);
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_ZipOpenLarge);
+
+BENCHMARK_MAIN();
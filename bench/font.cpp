@@ -53,4 +53,21 @@ static void BM_Render(benchmark::State& state) {
 
 BENCHMARK(BM_Render);
 
+static void BM_RenderManyGlyphs(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+	const int glyphs = state.range(0);
+
+	auto font = Font::Default();
+	for (auto _: state) {
+		for (char32_t ch = 0x4E00; ch < 0x4E00 + glyphs; ++ch) {
+			font->Render(*surface, 0, 0, *system, 0, ch);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * glyphs);
+}
+
+BENCHMARK(BM_RenderManyGlyphs)->Arg(100)->Arg(1000);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+#include "game_interpreter.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "maniac_patch.h"
+#include <lcf/data.h>
+
+constexpr int max_vars = 1024;
+
+static void setup() {
+	lcf::Data::variables.resize(max_vars);
+	lcf::Data::switches.resize(max_vars);
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_variables->SetRange(1, max_vars, 7);
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_switches->SetRange(1, max_vars, true);
+}
+
+// v[3] + 2
+static const std::vector<int32_t> var_plus_const = { 0x03010830, 0x00000201 };
+
+// (v[3] * 4 + v[v[5]] / (s[2] ? 3 : 9)) % max(v[7], 13) - abs(-100)
+static const std::vector<int32_t> large_expr = {
+	0x32303431, 0x01030108, 0x010D3304, 0x01094805, 0x01030102,
+	0x020D4E09, 0x01080D01, 0x010E4E07, 0x00640118
+};
+
+template <typename F>
+static void BM_Expression(benchmark::State& state, const std::vector<int32_t>& op_codes, F&& eval) {
+	setup();
+	Game_Interpreter interpreter;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(eval(MakeSpan(op_codes), interpreter));
+	}
+}
+
+static void BM_InterpretVarPlusConst(benchmark::State& state) {
+	BM_Expression(state, var_plus_const, ManiacPatch::InterpretExpression);
+}
+
+BENCHMARK(BM_InterpretVarPlusConst);
+
+static void BM_CompiledVarPlusConst(benchmark::State& state) {
+	BM_Expression(state, var_plus_const, ManiacPatch::ParseExpression);
+}
+
+BENCHMARK(BM_CompiledVarPlusConst);
+
+static void BM_InterpretLarge(benchmark::State& state) {
+	BM_Expression(state, large_expr, ManiacPatch::InterpretExpression);
+}
+
+BENCHMARK(BM_InterpretLarge);
+
+static void BM_CompiledLarge(benchmark::State& state) {
+	BM_Expression(state, large_expr, ManiacPatch::ParseExpression);
+}
+
+BENCHMARK(BM_CompiledLarge);
+
+BENCHMARK_MAIN();
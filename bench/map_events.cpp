@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "game_constants.h"
+#include "game_map.h"
+#include "game_party.h"
+#include "game_pictures.h"
+#include "game_player.h"
+#include "game_screen.h"
+#include "game_switches.h"
+#include "game_system.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "map_data.h"
+#include <lcf/data.h>
+#include <random>
+
+constexpr int map_size = 100;
+
+static std::unique_ptr<lcf::rpg::Map> make_map(int num_events) {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = map_size;
+	map->height = map_size;
+	map->upper_layer.resize(map_size * map_size, BLOCK_F);
+	map->lower_layer.resize(map_size * map_size, BLOCK_E);
+
+	std::mt19937 rng(1);
+	for (int i = 1; i <= num_events; ++i) {
+		map->events.push_back({});
+		auto& ev = map->events.back();
+		ev.ID = i;
+		ev.x = rng() % map_size;
+		ev.y = rng() % map_size;
+		ev.pages.push_back({});
+		ev.pages.back().ID = 1;
+		ev.pages.back().character_pattern = 1;
+	}
+	return map;
+}
+
+static void setup(int num_events) {
+	lcf::Data::data = {};
+	lcf::Data::terrains.push_back({});
+	lcf::Data::chipsets.push_back({});
+	auto& chipset = lcf::Data::chipsets.back();
+	chipset.passable_data_lower.resize(162, 0xF);
+	chipset.passable_data_upper.resize(162, 0xF);
+	chipset.terrain_data.resize(144, 1);
+
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_root;
+	lcf::Data::treemap.maps.push_back(lcf::rpg::MapInfo());
+	lcf::Data::treemap.maps.back().ID = 1;
+	lcf::Data::treemap.maps.back().type = lcf::rpg::TreeMap::MapType_map;
+
+	Main_Data::game_constants = std::make_unique<Game_Constants>();
+	Main_Data::game_party = std::make_unique<Game_Party>();
+	Game_Map::Init();
+	Main_Data::game_system = std::make_unique<Game_System>();
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_pictures = std::make_unique<Game_Pictures>();
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+	Main_Data::game_player = std::make_unique<Game_Player>();
+	Main_Data::game_player->SetMapId(1);
+
+	Game_Map::Setup(make_map(num_events));
+}
+
+static void BM_CheckWay(benchmark::State& state) {
+	setup(state.range(0));
+	auto& ev = Game_Map::GetEvents().front();
+	int x = 0;
+	for (auto _: state) {
+		x = (x + 1) % map_size;
+		benchmark::DoNotOptimize(Game_Map::CheckWay(ev, x, 50, x + 1, 50));
+	}
+}
+
+BENCHMARK(BM_CheckWay)->Arg(10)->Arg(1000);
+
+static void BM_RandomWalk(benchmark::State& state) {
+	setup(state.range(0));
+	std::mt19937 rng(1);
+	for (auto _: state) {
+		for (auto& ev: Game_Map::GetEvents()) {
+			ev.SetRemainingStep(0);
+			ev.Move(rng() % 4);
+		}
+	}
+}
+
+BENCHMARK(BM_RandomWalk)->Arg(10)->Arg(1000);
+
+static void BM_GetEventAt(benchmark::State& state) {
+	setup(state.range(0));
+	int i = 0;
+	for (auto _: state) {
+		i = (i + 1) % (map_size * map_size);
+		benchmark::DoNotOptimize(Game_Map::GetEventAt(i % map_size, i / map_size, true));
+	}
+}
+
+BENCHMARK(BM_GetEventAt)->Arg(10)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include "game_map.h"
+#include <lcf/lmu/reader.h>
+#include <random>
+#include <sstream>
+
+constexpr int map_size = 200;
+
+static lcf::rpg::Map make_map(int num_events) {
+	lcf::rpg::Map map;
+	map.width = map_size;
+	map.height = map_size;
+	map.upper_layer.resize(map_size * map_size, 10000);
+	map.lower_layer.resize(map_size * map_size, 5000);
+
+	std::mt19937 rng(1);
+	for (int i = 1; i <= num_events; ++i) {
+		map.events.push_back({});
+		auto& ev = map.events.back();
+		ev.ID = i;
+		ev.name = "EV" + std::to_string(i);
+		ev.x = rng() % map_size;
+		ev.y = rng() % map_size;
+		for (int p = 1; p <= 2; ++p) {
+			ev.pages.push_back({});
+			auto& page = ev.pages.back();
+			page.ID = p;
+			for (int c = 0; c < 20; ++c) {
+				lcf::rpg::EventCommand com;
+				com.code = static_cast<int>(lcf::rpg::EventCommand::Code::ShowMessage);
+				com.string = "A message line of the event";
+				page.event_commands.push_back(com);
+			}
+		}
+	}
+	return map;
+}
+
+static std::string save_map(const lcf::rpg::Map& map) {
+	std::stringstream ss;
+	lcf::LMU_Reader::Save(ss, map, lcf::EngineVersion::e2k, "UTF-8");
+	return ss.str();
+}
+
+static void BM_MapSwitchParse(benchmark::State& state) {
+	const auto data = save_map(make_map(state.range(0)));
+
+	for (auto _: state) {
+		std::istringstream is(data);
+		auto map = lcf::LMU_Reader::Load(is, "UTF-8");
+		benchmark::DoNotOptimize(map);
+	}
+}
+
+BENCHMARK(BM_MapSwitchParse)->Arg(50)->Arg(500);
+
+static void BM_MapSwitchCached(benchmark::State& state) {
+	Game_Map::MapFiles::Clear();
+	Game_Map::MapFiles::Insert("Map0001.lmu", std::make_shared<lcf::rpg::Map>(make_map(state.range(0))));
+
+	for (auto _: state) {
+		auto map = std::make_unique<lcf::rpg::Map>(*Game_Map::MapFiles::Find("Map0001.lmu"));
+		benchmark::DoNotOptimize(map);
+	}
+
+	Game_Map::MapFiles::Clear();
+}
+
+BENCHMARK(BM_MapSwitchCached)->Arg(50)->Arg(500);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include "filefinder.h"
+#include "filesystem.h"
+#include "filesystem_stream.h"
+#include "output.h"
+#include "utils.h"
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+constexpr int num_dirs = 50;
+constexpr int num_files = 200;
+constexpr char tree_path[] = "bench_path_index";
+
+static std::string dir_name(int i) {
+	return "Dir" + std::to_string(i);
+}
+
+static std::string file_name(int i) {
+	return "File" + std::to_string(i) + ".png";
+}
+
+// A game directory with many folders, like the Picture and CharSet folders of a large game
+static FilesystemView make_tree() {
+	auto root = FileFinder::Root();
+	root.MakeDirectory(tree_path, false);
+	for (int i = 0; i < num_dirs; ++i) {
+		root.MakeDirectory(FileFinder::MakePath(tree_path, dir_name(i)), false);
+		for (int j = 0; j < num_files; ++j) {
+			root.OpenOutputStream(FileFinder::MakePath(tree_path, FileFinder::MakePath(dir_name(i), file_name(j))));
+		}
+	}
+	return root.Subtree(tree_path);
+}
+
+static void remove_tree() {
+	for (int i = 0; i < num_dirs; ++i) {
+		const auto dir = FileFinder::MakePath(tree_path, dir_name(i));
+		for (int j = 0; j < num_files; ++j) {
+			std::remove(FileFinder::MakePath(dir, file_name(j)).c_str());
+		}
+		std::remove(dir.c_str());
+	}
+	std::remove(tree_path);
+}
+
+// Startup lookups: one file in every directory
+static void find_files(const FilesystemView& fs) {
+	for (int i = 0; i < num_dirs; ++i) {
+		auto path = fs.FindFile(FileFinder::MakePath(dir_name(i), "file0"), Utils::MakeSvArray(".bmp", ".png"));
+		benchmark::DoNotOptimize(path);
+	}
+}
+
+static void BM_FindFileScan(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto fs = make_tree();
+
+	for (auto _: state) {
+		state.PauseTiming();
+		fs.GetOwner().ClearCache("");
+		state.ResumeTiming();
+
+		find_files(fs);
+	}
+
+	remove_tree();
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_FindFileScan);
+
+static void BM_FindFileIndex(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto fs = make_tree();
+	find_files(fs);
+
+	std::stringstream ss;
+	fs.GetOwner().SaveIndex(ss);
+	const auto index = ss.str();
+
+	for (auto _: state) {
+		state.PauseTiming();
+		fs.GetOwner().ClearCache("");
+		std::istringstream is(index);
+		state.ResumeTiming();
+
+		fs.GetOwner().LoadIndex(is);
+		find_files(fs);
+	}
+
+	state.counters["index_bytes"] = index.size();
+
+	remove_tree();
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_FindFileIndex);
+
+// Lookups during gameplay, after every directory of the index was verified
+static void BM_FindFileIndexRepeated(benchmark::State& state) {
+	Output::SetLogLevel(LogLevel::Error);
+	auto fs = make_tree();
+	find_files(fs);
+
+	std::stringstream ss;
+	fs.GetOwner().SaveIndex(ss);
+	fs.GetOwner().ClearCache("");
+	fs.GetOwner().LoadIndex(ss);
+	find_files(fs);
+
+	for (auto _: state) {
+		find_files(fs);
+	}
+
+	remove_tree();
+	Output::SetLogLevel(LogLevel::Debug);
+}
+
+BENCHMARK(BM_FindFileIndexRepeated);
+
+BENCHMARK_MAIN();
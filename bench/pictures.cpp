@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include "game_pictures.h"
+
+// Allocates max_pics picture slots and shows num_shown of them
+static void make(Game_Pictures& pictures, int max_pics, int num_shown) {
+	pictures.GetPicture(max_pics);
+
+	Game_Pictures::ShowParams params;
+	params.effect_mode = lcf::rpg::SavePicture::Effect_wave;
+	params.effect_power = 5;
+	params.fixed_to_map = true;
+
+	Game_Pictures::MoveParams move;
+	move.duration = 10000;
+	move.position_x = 320;
+
+	for (int i = 0; i < num_shown; ++i) {
+		int id = 1 + i * (max_pics / num_shown);
+		pictures.Show(id, params);
+		pictures.Move(id, move);
+	}
+}
+
+static void BM_PicturesUpdate(benchmark::State& state) {
+	Game_Pictures pictures;
+	make(pictures, state.range(0), state.range(1));
+	pictures.Update(false);
+
+	for (auto _: state) {
+		pictures.Update(false);
+	}
+}
+
+BENCHMARK(BM_PicturesUpdate)->Args({1000, 10})->Args({1000, 1000});
+
+static void BM_PicturesMapScrolled(benchmark::State& state) {
+	Game_Pictures pictures;
+	make(pictures, state.range(0), state.range(1));
+	pictures.Update(false);
+
+	int dx = 1;
+	for (auto _: state) {
+		pictures.OnMapScrolled(dx, 0);
+		dx = -dx;
+	}
+}
+
+BENCHMARK(BM_PicturesMapScrolled)->Args({1000, 10})->Args({1000, 1000});
+
+BENCHMARK_MAIN();
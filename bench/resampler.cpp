@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include "audio_resampler_sinc.h"
+#include "system.h"
+#include <cmath>
+#include <vector>
+
+#ifdef HAVE_LIBSPEEXDSP
+#include <speex/speex_resampler.h>
+#endif
+
+// Compares the built-in resampler with libspeexdsp (when available).
+// "rtf" is seconds of output audio per second of wall time, "snr" the
+// signal to noise ratio in dB of a resampled 1 kHz sine.
+
+constexpr int out_rate = 44100;
+constexpr int channels = 2;
+constexpr int chunk_frames = 128;
+constexpr double freq = 1000.0;
+
+static std::vector<float> MakeSine(int rate) {
+	std::vector<float> out(rate * channels);
+	for (int i = 0; i < rate; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			out[i * channels + c] = 0.5f * std::sin(2 * M_PI * freq * i / rate);
+		}
+	}
+	return out;
+}
+
+static double Snr(const std::vector<float>& out) {
+	double err = 0.0;
+	double sig = 0.0;
+	int frames = out.size() / channels;
+	for (int i = 200; i < frames - 200; ++i) {
+		double ideal = 0.5 * std::sin(2 * M_PI * freq * i / out_rate);
+		double d = out[i * channels] - ideal;
+		err += d * d;
+		sig += ideal * ideal;
+	}
+	return 10 * std::log10(sig / err);
+}
+
+// Resampler interface: process(in, in_frames, out, out_frames), both counts in/out
+template <typename F>
+static std::vector<float> Run(const std::vector<float>& in, F&& process) {
+	std::vector<float> out;
+	std::vector<float> buf(chunk_frames * 8 * channels);
+	int frames = in.size() / channels;
+	int pos = 0;
+	while (pos < frames) {
+		int in_frames = std::min(chunk_frames, frames - pos);
+		int out_frames = chunk_frames * 8;
+		process(&in[pos * channels], in_frames, buf.data(), out_frames);
+		pos += in_frames;
+		out.insert(out.end(), buf.begin(), buf.begin() + out_frames * channels);
+		if (in_frames == 0 && out_frames == 0) {
+			break;
+		}
+	}
+	return out;
+}
+
+template <typename R, typename F>
+static void Measure(benchmark::State& state, int in_rate, R&& reset, F&& process) {
+	auto in = MakeSine(in_rate);
+	int64_t frames = 0;
+	std::vector<float> out;
+	for (auto _: state) {
+		reset();
+		out = Run(in, process);
+		frames += out.size() / channels;
+	}
+	state.counters["rtf"] = benchmark::Counter(static_cast<double>(frames) / out_rate, benchmark::Counter::kIsRate);
+	state.counters["snr"] = Snr(out);
+}
+
+static void BM_SincResampler(benchmark::State& state) {
+	auto quality = static_cast<SincResampler::Quality>(state.range(0));
+	int in_rate = state.range(1);
+	SincResampler r(channels, quality);
+	r.SetRate(in_rate, out_rate);
+
+	Measure(state, in_rate, [&]() { r.Reset(); }, [&](const float* in, int& in_frames, float* out, int& out_frames) {
+		r.Process(in, in_frames, out, out_frames);
+	});
+}
+
+BENCHMARK(BM_SincResampler)
+	->ArgsProduct({
+		{ static_cast<int>(SincResampler::Quality::Linear), static_cast<int>(SincResampler::Quality::Low),
+		static_cast<int>(SincResampler::Quality::Medium), static_cast<int>(SincResampler::Quality::High) },
+		{ 22050, 32000, 48000 }
+	});
+
+#ifdef HAVE_LIBSPEEXDSP
+static void BM_SpeexResampler(benchmark::State& state) {
+	int quality = state.range(0);
+	int in_rate = state.range(1);
+	int err = 0;
+	SpeexResamplerState* r = speex_resampler_init(channels, in_rate, out_rate, quality, &err);
+
+	auto reset = [&]() {
+		speex_resampler_reset_mem(r);
+		speex_resampler_skip_zeros(r);
+	};
+	Measure(state, in_rate, reset, [&](const float* in, int& in_frames, float* out, int& out_frames) {
+		spx_uint32_t in_len = in_frames;
+		spx_uint32_t out_len = out_frames;
+		speex_resampler_process_interleaved_float(r, in, &in_len, out, &out_len);
+		in_frames = in_len;
+		out_frames = out_len;
+	});
+
+	speex_resampler_destroy(r);
+}
+
+// The qualities used by AudioResampler for Low, Medium and High
+BENCHMARK(BM_SpeexResampler)->ArgsProduct({ { 0, 3, 5 }, { 22050, 32000, 48000 } });
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include "save_writer.h"
+#include <lcf/lsd/reader.h>
+#include <sstream>
+
+constexpr int num_vars = 50000;
+
+static lcf::rpg::Save make_save() {
+	lcf::rpg::Save save;
+	save.system.variables.resize(num_vars);
+	save.system.switches.resize(num_vars);
+	for (int i = 0; i < num_vars; ++i) {
+		save.system.variables[i] = i * 7;
+		save.system.switches[i] = (i % 3) == 0;
+	}
+	return save;
+}
+
+// Time the main thread spends on a synchronous save
+static void BM_SaveSync(benchmark::State& state) {
+	const auto save = make_save();
+
+	for (auto _: state) {
+		std::ostringstream os;
+		lcf::LSD_Reader::Save(os, save, lcf::EngineVersion::e2k3, "UTF-8");
+		benchmark::DoNotOptimize(os);
+	}
+}
+
+BENCHMARK(BM_SaveSync);
+
+// Time the main thread spends on a background save: snapshot and hand over
+static void BM_SaveAsync(benchmark::State& state) {
+	const auto save = make_save();
+
+	for (auto _: state) {
+		SaveWriter::Serialize(save, lcf::EngineVersion::e2k3, "UTF-8", {});
+
+		state.PauseTiming();
+		SaveWriter::Wait();
+		state.ResumeTiming();
+	}
+
+	SaveWriter::Quit();
+}
+
+BENCHMARK(BM_SaveAsync);
+
+BENCHMARK_MAIN();
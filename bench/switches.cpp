@@ -64,5 +64,37 @@ static void BM_SwitchFlipRange(benchmark::State& state) {
 
 BENCHMARK(BM_SwitchFlipRange);
 
+constexpr int large_range = 10000;
+
+static void BM_SwitchSetRangeLarge(benchmark::State& state) {
+	auto s = make(large_range);
+	bool val = false;
+	for (auto _: state) {
+		// Unaligned start to include the partial words
+		s.SetRange(3, large_range, val);
+		val = !val;
+	}
+}
+
+BENCHMARK(BM_SwitchSetRangeLarge);
+
+static void BM_SwitchFlipRangeLarge(benchmark::State& state) {
+	auto s = make(large_range);
+	for (auto _: state) {
+		s.FlipRange(3, large_range);
+	}
+}
+
+BENCHMARK(BM_SwitchFlipRangeLarge);
+
+static void BM_SwitchCountRangeLarge(benchmark::State& state) {
+	auto s = make(large_range);
+	s.SetRange(1, large_range / 2, true);
+	for (auto _: state) {
+		benchmark::DoNotOptimize(s.CountRange(3, large_range));
+	}
+}
+
+BENCHMARK(BM_SwitchCountRangeLarge);
 
 BENCHMARK_MAIN();
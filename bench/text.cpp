@@ -20,6 +20,7 @@ static void BM_TextDrawStrSystem(benchmark::State& state) {
 	for (auto _: state) {
 		Text::Draw(*surface, 0, 0, *font, *system, 0, text, Text::AlignLeft);
 	}
+	state.SetItemsProcessed(state.iterations() * text.size());
 }
 
 BENCHMARK(BM_TextDrawStrSystem);
@@ -32,10 +33,29 @@ static void BM_TextDrawStrColor(benchmark::State& state) {
 	for (auto _: state) {
 		Text::Draw(*surface, 0, 0, *font, Color(255,255,255,255), text);
 	}
+	state.SetItemsProcessed(state.iterations() * text.size());
 }
 
 BENCHMARK(BM_TextDrawStrColor);
 
+static void BM_TextDrawStrSolidColor(benchmark::State& state) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SysBlack();
+
+	Font::Style style = font->GetCurrentStyle();
+	style.draw_gradient = false;
+	auto guard = font->ApplyStyle(style);
+
+	for (auto _: state) {
+		Text::Draw(*surface, 0, 0, *font, *system, 0, text, Text::AlignLeft);
+	}
+	state.SetItemsProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_TextDrawStrSolidColor);
+
 void DrawCharSystemWrap(benchmark::State& state, char32_t ch, bool is_exfont) {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::Default();
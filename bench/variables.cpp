@@ -124,4 +124,57 @@ static void BM_VariableSetRangeRandom(benchmark::State& state) {
 
 BENCHMARK(BM_VariableSetRangeRandom);
 
+constexpr int large_range = 32768;
+
+template <typename F>
+static void BM_VariableLargeOp(benchmark::State& state, F&& op) {
+	auto v = make(large_range * 2);
+	for (auto _: state) {
+		op(v);
+	}
+	state.SetItemsProcessed(state.iterations() * large_range);
+}
+
+static void BM_VariableAddRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.AddRange(1, large_range, 3); });
+}
+
+BENCHMARK(BM_VariableAddRangeLarge);
+
+static void BM_VariableMultRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.MultRange(1, large_range, -1); });
+}
+
+BENCHMARK(BM_VariableMultRangeLarge);
+
+static void BM_VariableBitXorRangeLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.BitXorRange(1, large_range, 5); });
+}
+
+BENCHMARK(BM_VariableBitXorRangeLarge);
+
+static void BM_VariableSubRangeVariableLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.SubRangeVariable(1, large_range, large_range * 2); });
+}
+
+BENCHMARK(BM_VariableSubRangeVariableLarge);
+
+static void BM_VariableAddRangeVariableIndirectLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.AddRangeVariableIndirect(1, large_range, large_range * 2); });
+}
+
+BENCHMARK(BM_VariableAddRangeVariableIndirectLarge);
+
+static void BM_VariableAddArrayLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.AddArray(1, large_range, large_range + 1); });
+}
+
+BENCHMARK(BM_VariableAddArrayLarge);
+
+static void BM_VariableSetArrayLarge(benchmark::State& state) {
+	BM_VariableLargeOp(state, [](auto& v) { v.SetArray(1, large_range, large_range + 1); });
+}
+
+BENCHMARK(BM_VariableSetArrayLarge);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,398 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "asset_manifest.h"
+#include "filefinder.h"
+#include "output.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+
+#ifdef HAVE_NLOHMANN_JSON
+#  include <nlohmann/json.hpp>
+#endif
+
+/*
+ * Layout of the binary manifest (integers are little endian):
+ *
+ * char[4]  magic "EPAM"
+ * u32      format version
+ * u32      index.json version
+ * u32      number of entries
+ * u32      number of blocks
+ * u32      number of hash slots (power of two)
+ * u32[]    offset of every block, relative to the first entry
+ * u32[]    hash slots: 0 when unused, otherwise the top 8 bit of the key hash
+ *          and the entry index + 1 in the lower 24 bit
+ * entries  sorted by key, each is: varint shared key prefix length,
+ *          varint key suffix length, key suffix, varint shared value prefix
+ *          length, varint value suffix length, value suffix.
+ *          The shared lengths are 0 for the first entry of a block.
+ */
+
+namespace {
+	constexpr char manifest_magic[4] = { 'E', 'P', 'A', 'M' };
+	constexpr uint32_t manifest_version = 1;
+	constexpr size_t header_size = 24;
+	/** Entries per front-coded block, a lookup decodes up to this many entries */
+	constexpr uint32_t block_size = 16;
+	/** The entry index of a hash slot has 24 bit */
+	constexpr uint32_t max_entries = 0xFFFFFE;
+
+	uint32_t Hash(std::string_view key) {
+		// FNV-1a
+		uint32_t hash = 2166136261u;
+		for (unsigned char c : key) {
+			hash ^= c;
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	size_t SharedPrefix(std::string_view a, std::string_view b) {
+		size_t n = std::min(a.size(), b.size());
+		size_t i = 0;
+		while (i < n && a[i] == b[i]) {
+			++i;
+		}
+		return i;
+	}
+
+	void WriteU32(std::string& out, uint32_t value) {
+		Utils::SwapByteOrder(value);
+		out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void WriteVarint(std::string& out, size_t value) {
+		while (value >= 0x80) {
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	bool ReadVarint(std::string_view data, size_t& pos, size_t& value) {
+		value = 0;
+		for (int shift = 0; shift < 32; shift += 7) {
+			if (pos >= data.size()) {
+				return false;
+			}
+			auto byte = static_cast<unsigned char>(data[pos++]);
+			value |= static_cast<size_t>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void WriteFrontCoded(std::string& out, std::string_view prev, std::string_view str) {
+		size_t shared = SharedPrefix(prev, str);
+		WriteVarint(out, shared);
+		WriteVarint(out, str.size() - shared);
+		out.append(str.data() + shared, str.size() - shared);
+	}
+
+	bool ReadFrontCoded(std::string_view data, size_t& pos, std::string& str) {
+		size_t shared, suffix;
+		if (!ReadVarint(data, pos, shared) || !ReadVarint(data, pos, suffix)
+				|| shared > str.size() || suffix > data.size() - pos) {
+			return false;
+		}
+		str.resize(shared);
+		str.append(data.data() + pos, suffix);
+		pos += suffix;
+		return true;
+	}
+}
+
+AssetManifest::AssetManifest() : AssetManifest(Build({}, 1)) {
+}
+
+AssetManifest::AssetManifest(std::string data) : data(std::move(data)) {
+}
+
+AssetManifest AssetManifest::Build(Entries entries, int index_version) {
+	std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	// Keep the last value of duplicated keys
+	size_t num_unique = 0;
+	for (size_t i = 0; i < entries.size(); ++i) {
+		if (num_unique > 0 && entries[num_unique - 1].first == entries[i].first) {
+			entries[num_unique - 1].second = std::move(entries[i].second);
+		} else {
+			if (num_unique != i) {
+				entries[num_unique] = std::move(entries[i]);
+			}
+			++num_unique;
+		}
+	}
+	entries.resize(num_unique);
+
+	if (entries.size() > max_entries) {
+		Output::Warning("AssetManifest: Too many entries ({}), ignoring {}", entries.size(), entries.size() - max_entries);
+		entries.resize(max_entries);
+	}
+
+	const auto count = static_cast<uint32_t>(entries.size());
+	const uint32_t num_blocks = (count + block_size - 1) / block_size;
+	uint32_t num_slots = 1;
+	while (num_slots < count + count / 2 + 1) {
+		num_slots *= 2;
+	}
+
+	std::vector<uint32_t> block_offsets;
+	block_offsets.reserve(num_blocks);
+	std::vector<uint32_t> slots(num_slots);
+	const uint32_t mask = num_slots - 1;
+
+	std::string body;
+	std::string_view prev_key;
+	std::string_view prev_value;
+	for (uint32_t i = 0; i < count; ++i) {
+		const auto& key = entries[i].first;
+		const auto& value = entries[i].second;
+
+		if (i % block_size == 0) {
+			block_offsets.push_back(static_cast<uint32_t>(body.size()));
+			prev_key = {};
+			prev_value = {};
+		}
+		WriteFrontCoded(body, prev_key, key);
+		WriteFrontCoded(body, prev_value, value);
+		prev_key = key;
+		prev_value = value;
+
+		const uint32_t hash = Hash(key);
+		uint32_t slot = hash & mask;
+		while (slots[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		slots[slot] = (hash & 0xFF000000u) | (i + 1);
+	}
+
+	std::string data;
+	data.reserve(header_size + (block_offsets.size() + slots.size()) * sizeof(uint32_t) + body.size());
+	data.append(manifest_magic, sizeof(manifest_magic));
+	WriteU32(data, manifest_version);
+	WriteU32(data, static_cast<uint32_t>(index_version));
+	WriteU32(data, count);
+	WriteU32(data, num_blocks);
+	WriteU32(data, num_slots);
+	for (auto offset : block_offsets) {
+		WriteU32(data, offset);
+	}
+	for (auto slot : slots) {
+		WriteU32(data, slot);
+	}
+	data += body;
+
+	AssetManifest manifest(std::move(data));
+	manifest.Parse();
+	return manifest;
+}
+
+std::optional<AssetManifest> AssetManifest::FromJson(std::string_view json_data) {
+#ifdef HAVE_NLOHMANN_JSON
+	using json = nlohmann::json;
+
+	json j = json::parse(json_data.begin(), json_data.end(), nullptr, false);
+	if (j.is_discarded() || !j.is_object()) {
+		return {};
+	}
+
+	int index_version = 1;
+	if (j.contains("metadata") && j["metadata"].is_object()) {
+		const auto& metadata = j["metadata"];
+		if (metadata.contains("version") && metadata["version"].is_number()) {
+			index_version = metadata["version"].get<int>();
+		}
+	}
+
+	Entries entries;
+
+	if (index_version <= 1) {
+		// legacy format
+		for (const auto& value : j.items()) {
+			if (value.value().is_string()) {
+				entries.emplace_back(value.key(), value.value().get<std::string>());
+			}
+		}
+	} else {
+		using fn = std::function<void(const json&, const std::string&)>;
+		fn parse = [&] (const json& obj, const std::string& path) {
+			std::string dirname;
+			if (obj.contains("_dirname") && obj["_dirname"].is_string()) {
+				dirname = obj["_dirname"].get<std::string>();
+			}
+			dirname = FileFinder::MakePath(path, dirname);
+			const auto dirname_key = Utils::LowerCase(dirname);
+
+			for (const auto& value : obj.items()) {
+				const auto& second = value.value();
+				if (second.is_object()) {
+					parse(second, dirname);
+				} else if (second.is_string() && value.key() != "_dirname") {
+					entries.emplace_back(FileFinder::MakePath(dirname_key, value.key()), FileFinder::MakePath(dirname, second.get<std::string>()));
+				}
+			}
+		};
+
+		if (j.contains("cache") && j["cache"].is_object()) {
+			parse(j["cache"], "");
+		}
+	}
+
+	return Build(std::move(entries), index_version);
+#else
+	(void)json_data;
+	Output::Debug("AssetManifest: JSON support not compiled in");
+	return {};
+#endif
+}
+
+bool AssetManifest::ConvertJson(std::istream& is, std::ostream& os) {
+	std::string json_data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+	auto manifest = FromJson(json_data);
+	if (!manifest) {
+		return false;
+	}
+
+	const auto& data = manifest->GetData();
+	os.write(data.data(), data.size());
+	return os.good();
+}
+
+std::optional<AssetManifest> AssetManifest::FromData(std::string data) {
+	AssetManifest manifest(std::move(data));
+	if (!manifest.Parse()) {
+		return {};
+	}
+	return manifest;
+}
+
+bool AssetManifest::IsManifest(std::string_view data) {
+	return data.size() >= sizeof(manifest_magic) && std::memcmp(data.data(), manifest_magic, sizeof(manifest_magic)) == 0;
+}
+
+bool AssetManifest::Parse() {
+	header = {};
+	if (data.size() < header_size || !IsManifest(data) || ReadU32(4) != manifest_version) {
+		return false;
+	}
+
+	Header h;
+	h.index_version = ReadU32(8);
+	h.count = ReadU32(12);
+	h.num_blocks = ReadU32(16);
+	h.num_slots = ReadU32(20);
+
+	if (h.count > max_entries || h.num_blocks != (h.count + block_size - 1) / block_size
+			|| h.num_slots == 0 || (h.num_slots & (h.num_slots - 1)) != 0 || h.num_slots <= h.count) {
+		return false;
+	}
+
+	const uint64_t tables_size = (static_cast<uint64_t>(h.num_blocks) + h.num_slots) * sizeof(uint32_t);
+	if (header_size + tables_size > data.size()) {
+		return false;
+	}
+
+	header = h;
+	blocks_offset = header_size;
+	slots_offset = blocks_offset + header.num_blocks * sizeof(uint32_t);
+	entries_offset = slots_offset + header.num_slots * sizeof(uint32_t);
+	return true;
+}
+
+uint32_t AssetManifest::ReadU32(size_t offset) const {
+	uint32_t value;
+	std::memcpy(&value, data.data() + offset, sizeof(value));
+	Utils::SwapByteOrder(value);
+	return value;
+}
+
+size_t AssetManifest::DecodeEntry(size_t pos, std::string& key, std::string& value) const {
+	if (!ReadFrontCoded(data, pos, key) || !ReadFrontCoded(data, pos, value)) {
+		return 0;
+	}
+	return pos;
+}
+
+std::optional<std::string> AssetManifest::Find(std::string_view key) const {
+	if (header.count == 0) {
+		return {};
+	}
+
+	const uint32_t hash = Hash(key);
+	const uint32_t mask = header.num_slots - 1;
+
+	std::string entry_key;
+	std::string entry_value;
+	uint32_t slot = hash & mask;
+	for (uint32_t probe = 0; probe < header.num_slots; ++probe, slot = (slot + 1) & mask) {
+		const uint32_t slot_value = ReadU32(slots_offset + slot * sizeof(uint32_t));
+		if (slot_value == 0) {
+			break;
+		}
+		if ((slot_value & 0xFF000000u) != (hash & 0xFF000000u)) {
+			continue;
+		}
+
+		const uint32_t index = (slot_value & 0xFFFFFFu) - 1;
+		if (index >= header.count) {
+			return {};
+		}
+
+		// Decode the block up to the entry
+		const uint32_t block = index / block_size;
+		size_t pos = entries_offset + ReadU32(blocks_offset + block * sizeof(uint32_t));
+		entry_key.clear();
+		entry_value.clear();
+		for (uint32_t i = block * block_size; i <= index; ++i) {
+			pos = DecodeEntry(pos, entry_key, entry_value);
+			if (pos == 0) {
+				return {};
+			}
+		}
+
+		if (entry_key == key) {
+			return entry_value;
+		}
+	}
+
+	return {};
+}
+
+void AssetManifest::ForEach(const std::function<void(std::string_view key, std::string_view value)>& func) const {
+	std::string key;
+	std::string value;
+	size_t pos = entries_offset;
+	for (uint32_t i = 0; i < header.count; ++i) {
+		pos = DecodeEntry(pos, key, value);
+		if (pos == 0) {
+			return;
+		}
+		func(key, value);
+	}
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_ASSET_MANIFEST_H
+#define EP_ASSET_MANIFEST_H
+
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "string_view.h"
+
+/**
+ * Compact mapping of asset paths to download paths for the web player.
+ *
+ * Replaces the map built from index.json. The entries are sorted by key and
+ * stored front-coded in blocks: the first entry of a block is stored fully,
+ * all others only store the suffix that differs from the previous entry.
+ * An open addressing hash table points at the entries, so a lookup decodes
+ * at most one block and no strings are materialized while loading.
+ */
+class AssetManifest {
+public:
+	using Entries = std::vector<std::pair<std::string, std::string>>;
+
+	/** Creates an empty manifest */
+	AssetManifest();
+
+	/**
+	 * Creates a manifest from a list of entries.
+	 * When a key occurs multiple times the last value is used.
+	 *
+	 * @param entries key and value pairs
+	 * @param index_version version of the index the entries were read from
+	 * @return manifest
+	 */
+	static AssetManifest Build(Entries entries, int index_version);
+
+	/**
+	 * Converts the index.json of a web deployment (version 1 or 2).
+	 * Only available when compiled with JSON support.
+	 *
+	 * @param json_data content of the index.json
+	 * @return manifest, empty when the JSON is invalid
+	 */
+	static std::optional<AssetManifest> FromJson(std::string_view json_data);
+
+	/**
+	 * Converts an index.json to the binary manifest format.
+	 * Web deployments serve the result instead of the index.json, under the
+	 * same name, AsyncHandler detects the format. Used by --convert-index.
+	 *
+	 * @param is content of the index.json
+	 * @param os stream the manifest is written to
+	 * @return whether the conversion succeeded
+	 */
+	static bool ConvertJson(std::istream& is, std::ostream& os);
+
+	/**
+	 * Uses the binary data written by GetData as a manifest.
+	 *
+	 * @param data manifest data
+	 * @return manifest, empty when the data is invalid
+	 */
+	static std::optional<AssetManifest> FromData(std::string data);
+
+	/**
+	 * @param data content of a file
+	 * @return whether the data starts like a binary manifest
+	 */
+	static bool IsManifest(std::string_view data);
+
+	/** @return binary representation of the manifest, see FromData */
+	const std::string& GetData() const;
+
+	/** @return version of the index.json the manifest was created from */
+	int GetIndexVersion() const;
+
+	/** @return number of entries */
+	size_t size() const;
+
+	/** @return whether the manifest has no entries */
+	bool empty() const;
+
+	/**
+	 * Looks up the value of a key.
+	 *
+	 * @param key key to search
+	 * @return value, empty when the key does not exist
+	 */
+	std::optional<std::string> Find(std::string_view key) const;
+
+	/**
+	 * Calls a function for every entry in key order.
+	 * The views are only valid during the call.
+	 *
+	 * @param func function receiving key and value
+	 */
+	void ForEach(const std::function<void(std::string_view key, std::string_view value)>& func) const;
+
+private:
+	explicit AssetManifest(std::string data);
+
+	struct Header {
+		uint32_t index_version = 0;
+		uint32_t count = 0;
+		uint32_t num_blocks = 0;
+		uint32_t num_slots = 0;
+	};
+
+	bool Parse();
+	uint32_t ReadU32(size_t offset) const;
+	size_t DecodeEntry(size_t pos, std::string& key, std::string& value) const;
+
+	std::string data;
+	Header header;
+	/** Offset of the block offset table in data */
+	size_t blocks_offset = 0;
+	/** Offset of the hash table in data */
+	size_t slots_offset = 0;
+	/** Offset of the first entry in data */
+	size_t entries_offset = 0;
+};
+
+inline const std::string& AssetManifest::GetData() const {
+	return data;
+}
+
+inline int AssetManifest::GetIndexVersion() const {
+	return static_cast<int>(header.index_version);
+}
+
+inline size_t AssetManifest::size() const {
+	return header.count;
+}
+
+inline bool AssetManifest::empty() const {
+	return header.count == 0;
+}
+
+#endif
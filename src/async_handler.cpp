@@ -23,10 +23,9 @@
 #ifdef __EMSCRIPTEN__
 #  include <emscripten.h>
 #  include <lcf/reader_util.h>
-#  include <nlohmann/json.hpp>
-   using json = nlohmann::json;
 #endif
 
+#include "asset_manifest.h"
 #include "async_handler.h"
 #include "cache.h"
 #include "filefinder.h"
@@ -44,7 +43,7 @@
 
 namespace {
 	std::unordered_map<std::string, std::shared_ptr<FileRequestAsync>> async_requests;
-	std::unordered_map<std::string, std::string> file_mapping;
+	AssetManifest file_mapping;
 	int next_id = 0;
 #ifdef __EMSCRIPTEN__
 	int index_version = 1;
@@ -156,64 +155,47 @@ void AsyncHandler::CreateRequestMapping(const std::string& file) {
 		return;
 	}
 
-	json j = json::parse(f, nullptr, false);
-	if (j.is_discarded()) {
-		Output::Error("Emscripten: index.json is not a valid JSON file");
-		return;
-	}
-
-	if (j.contains("metadata") && j["metadata"].is_object()) {
-		const auto& metadata = j["metadata"];
-		if (metadata.contains("version") && metadata["version"].is_number()) {
-			index_version = metadata["version"].get<int>();
+	// Either the index.json or a manifest converted from it by AssetManifest::FromJson
+	std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	std::optional<AssetManifest> manifest;
+	if (AssetManifest::IsManifest(data)) {
+		manifest = AssetManifest::FromData(std::move(data));
+		if (!manifest) {
+			Output::Error("Emscripten: index.json is not a valid asset manifest");
+			return;
+		}
+	} else {
+		manifest = AssetManifest::FromJson(data);
+		if (!manifest) {
+			Output::Error("Emscripten: index.json is not a valid JSON file");
+			return;
 		}
 	}
 
-	Output::Debug("Parsing index.json version {}", index_version);
-
-	if (index_version <= 1) {
-		// legacy format
-		for (const auto& value : j.items()) {
-			file_mapping[value.key()] = value.value().get<std::string>();
-		}
-	} else {
-		using fn = std::function<void(const json&, const std::string&)>;
-		fn parse = [&] (const json& obj, const std::string& path) {
-			std::string dirname;
-			if (obj.contains("_dirname") && obj["_dirname"].is_string()) {
-				dirname = obj["_dirname"].get<std::string>();
-			}
-			dirname = FileFinder::MakePath(path, dirname);
-
-			for (const auto& value : obj.items()) {
-				const auto& second = value.value();
-				if (second.is_object()) {
-					parse(second, dirname);
-				} else if (second.is_string()){
-					file_mapping[FileFinder::MakePath(Utils::LowerCase(dirname), value.key())] = FileFinder::MakePath(dirname, second.get<std::string>());
-				}
-			}
-		};
+	file_mapping = std::move(*manifest);
+	index_version = file_mapping.GetIndexVersion();
 
-		if (j.contains("cache") && j["cache"].is_object()) {
-			parse(j["cache"], "");
-		}
+	Output::Debug("Parsed index.json version {} ({} files)", index_version, file_mapping.size());
 
+	if (index_version >= 2) {
 		// Create some empty DLL files. Engine & patch detection depend on them.
 		for (const auto& s : {"harmony.dll", "ultimate_rt_eb.dll", "dynloader.dll", "accord.dll"}) {
-			auto it = file_mapping.find(s);
-			if (it != file_mapping.end()) {
+			if (file_mapping.Find(s)) {
 				FileFinder::Game().OpenOutputStream(s);
 			}
 		}
 
 		// Look for Meta.ini files and fetch them. They are required for detecting the translations.
-		for (const auto& item: file_mapping) {
-			if (EndsWith(item.first, "meta.ini")) {
-				auto* request = AsyncHandler::RequestFile(item.second);
-				request->SetImportantFile(true);
-				request->Start();
+		std::vector<std::string> meta_files;
+		file_mapping.ForEach([&](std::string_view key, std::string_view value) {
+			if (EndsWith(key, "meta.ini")) {
+				meta_files.emplace_back(value);
 			}
+		});
+		for (const auto& meta_file : meta_files) {
+			auto* request = AsyncHandler::RequestFile(meta_file);
+			request->SetImportantFile(true);
+			request->Start();
 		}
 	}
 #else
@@ -363,25 +345,21 @@ void FileRequestAsync::Start() {
 		modified_path = Utils::LowerCase(path);
 		if (directory != ".") {
 			modified_path = FileFinder::MakeCanonical(modified_path, 1);
-		} else {
-			auto it = file_mapping.find(modified_path);
-			if (it == file_mapping.end()) {
-				modified_path = FileFinder::MakeCanonical(modified_path, 1);
-			}
+		} else if (!file_mapping.Find(modified_path)) {
+			modified_path = FileFinder::MakeCanonical(modified_path, 1);
 		}
 	}
 
 	if (graphic && Tr::HasActiveTranslation()) {
 		std::string modified_path_trans = FileFinder::MakePath(lcf::ReaderUtil::Normalize(Tr::GetCurrentTranslationFilesystem().GetFullPath()), modified_path);
-		auto it = file_mapping.find(modified_path_trans);
-		if (it != file_mapping.end()) {
+		if (file_mapping.Find(modified_path_trans)) {
 			modified_path = modified_path_trans;
 		}
 	}
 
-	auto it = file_mapping.find(modified_path);
-	if (it != file_mapping.end()) {
-		request_path += it->second;
+	auto mapped_path = file_mapping.Find(modified_path);
+	if (mapped_path) {
+		request_path += *mapped_path;
 	} else {
 		if (file_mapping.empty()) {
 			// index.json not fetched yet, fallthrough and fetch
@@ -399,7 +377,7 @@ void FileRequestAsync::Start() {
 	request_path = Utils::ReplaceAll(request_path, "#", "%23");
 	request_path = Utils::ReplaceAll(request_path, "+", "%2B");
 
-	auto request_file = (it != file_mapping.end() ? it->second : path);
+	auto request_file = (mapped_path ? *mapped_path : path);
 	async_wget_with_retry(request_path, std::move(request_file), "", this);
 #else
 #  ifdef EM_GAME_URL
@@ -33,8 +33,10 @@ struct FileRequestResult;
  */
 namespace AsyncHandler {
 	/**
-	 * Parses the specified JSON file. The file mapping read from this file
+	 * Parses the specified index file. The file mapping read from this file
 	 * will be used for further ajax requests.
+	 * The file is either an index.json or a binary manifest converted from
+	 * it with --convert-index, which loads faster (see AssetManifest).
 	 */
 	void CreateRequestMapping(const std::string& file);
 
@@ -135,6 +135,14 @@ void AudioInterface::SetNativeMidiEnabled(bool enable) {
 	cfg.native_midi.Set(enable);
 }
 
+bool AudioInterface::GetMidiPrerenderEnabled() const {
+	return cfg.midi_prerender.Get();
+}
+
+void AudioInterface::SetMidiPrerenderEnabled(bool enable) {
+	cfg.midi_prerender.Set(enable);
+}
+
 std::string AudioInterface::GetFluidsynthSoundfont() const {
 	return cfg.soundfont.Get();
 }
@@ -139,6 +139,36 @@ struct AudioInterface {
 	 */
 	virtual void SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance) = 0;
 
+	/**
+	 * Plays a sound effect that can be adjusted with SE_Adjust while playing.
+	 * Backends without support play the sound effect like SE_Play.
+	 *
+	 * @param se se to play.
+	 * @param volume volume.
+	 * @param pitch pitch.
+	 * @param balance balance (0 - 100)
+	 * @param tag identifies the sound effect, must be larger than 0
+	 */
+	virtual void SE_PlayTagged(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance, int tag) {
+		(void)tag;
+		SE_Play(std::move(se), volume, pitch, balance);
+	}
+
+	/**
+	 * Changes volume and balance of all playing sound effects with the tag.
+	 *
+	 * @param tag tag passed to SE_PlayTagged
+	 * @param volume volume.
+	 * @param balance balance (0 - 100)
+	 */
+	virtual void SE_Adjust(int tag, int volume, int balance) { (void)tag; (void)volume; (void)balance; }
+
+	/**
+	 * @param tag tag passed to SE_PlayTagged
+	 * @return whether a sound effect with the tag is playing, always false when tags are unsupported
+	 */
+	virtual bool SE_IsPlaying(int tag) const { (void)tag; return false; }
+
 	/**
 	 * Stops the currently playing sound effect.
 	 */
@@ -159,6 +189,9 @@ struct AudioInterface {
 	bool GetNativeMidiEnabled() const;
 	void SetNativeMidiEnabled(bool enable);
 
+	bool GetMidiPrerenderEnabled() const;
+	void SetMidiPrerenderEnabled(bool enable);
+
 	std::string GetFluidsynthSoundfont() const;
 	void SetFluidsynthSoundfont(std::string_view sf);
 
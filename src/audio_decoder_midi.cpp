@@ -332,6 +332,18 @@ int AudioDecoderMidi::GetTicks() const {
 	return tempo.back().GetTicks(mtime);
 }
 
+std::chrono::microseconds AudioDecoderMidi::GetTotalTime() const {
+	return seq->get_total_time();
+}
+
+std::chrono::microseconds AudioDecoderMidi::GetLoopTime() const {
+	return seq->get_loop_time();
+}
+
+bool AudioDecoderMidi::SupportsMidiMessages() const {
+	return mididec->SupportsMidiMessages();
+}
+
 void AudioDecoderMidi::Reset() {
 	// Placed here to avoid reloading of a soundfont on shutdown
 	mididec->OnNewMidi();
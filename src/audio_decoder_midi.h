@@ -145,6 +145,22 @@ public:
 	 */
 	int GetTicks() const override;
 
+	/**
+	 * @return Time of the last MIDI event
+	 */
+	std::chrono::microseconds GetTotalTime() const;
+
+	/**
+	 * @return Time where playback continues after the end was reached
+	 */
+	std::chrono::microseconds GetLoopTime() const;
+
+	/**
+	 * @return Whether the volume is applied by the synthesizer through
+	 *         MIDI messages instead of by GetVolume
+	 */
+	bool SupportsMidiMessages() const;
+
 	/**
 	 * Generate a MIDI reset event so the device doesn't
 	 * leave notes playing or keeps any state.
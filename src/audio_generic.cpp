@@ -21,6 +21,7 @@
 #include <cassert>
 #include <memory>
 #include "audio_generic.h"
+#include "audio_midi_cache.h"
 #include "output.h"
 
 GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
@@ -180,6 +181,10 @@ std::string GenericAudio::BGM_GetType() const {
 }
 
 void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance) {
+	SE_PlayTagged(std::move(se), volume, pitch, balance, 0);
+}
+
+void GenericAudio::SE_PlayTagged(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance, int tag) {
 	if (!se) {
 		Output::Warning("SE_Play: AudioSeCache data is NULL");
 		return;
@@ -188,7 +193,7 @@ void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pit
 	for (auto& SE_Channel : SE_Channels) {
 		if (!SE_Channel.decoder) {
 			//If there is an unused se channel
-			PlayOnChannel(SE_Channel, std::move(se), volume, pitch, balance);
+			PlayOnChannel(SE_Channel, std::move(se), volume, pitch, balance, tag);
 			return;
 		}
 	}
@@ -196,6 +201,32 @@ void GenericAudio::SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pit
 	Output::Debug("Couldn't play {} SE. No free channel available", se->GetName());
 }
 
+void GenericAudio::SE_Adjust(int tag, int volume, int balance) {
+	LockMutex();
+	for (auto& SE_Channel : SE_Channels) {
+		if (SE_Channel.decoder && SE_Channel.tag == tag) {
+			SE_Channel.decoder->SetVolume(volume);
+			SE_Channel.decoder->SetBalance(balance);
+		}
+	}
+	UnlockMutex();
+}
+
+bool GenericAudio::SE_IsPlaying(int tag) const {
+	bool playing = false;
+
+	LockMutex();
+	for (auto& SE_Channel : SE_Channels) {
+		if (SE_Channel.decoder && !SE_Channel.stopped && SE_Channel.tag == tag) {
+			playing = true;
+			break;
+		}
+	}
+	UnlockMutex();
+
+	return playing;
+}
+
 void GenericAudio::SE_Stop() {
 	for (auto& SE_Channel : SE_Channels) {
 		SE_Channel.stopped = true; //Stop all running sound effects
@@ -203,7 +234,8 @@ void GenericAudio::SE_Stop() {
 }
 
 void GenericAudio::Update() {
-	// no-op, handled by the Decode function called through a thread
+	// Decoding is handled by the Decode function called through a thread
+	AudioMidiCache::Update();
 }
 
 GenericAudioMidiOut* GenericAudio::CreateAndGetMidiOut() {
@@ -270,7 +302,13 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 		midi_thread->GetMidiOut().Reset();
 	}
 
-	chan.decoder = AudioDecoder::Create(filestream);
+	chan.decoder.reset();
+	if (Audio().GetMidiPrerenderEnabled()) {
+		chan.decoder = AudioMidiCache::Create(filestream, pitch);
+	}
+	if (!chan.decoder) {
+		chan.decoder = AudioDecoder::Create(filestream);
+	}
 	chan.midi_out_used = false;
 	if (chan.decoder && chan.decoder->Open(std::move(filestream))) {
 		chan.decoder->SetPitch(pitch);
@@ -289,9 +327,10 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 	return false;
 }
 
-bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance) {
+bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance, int tag) {
 	chan.paused = true; // Pause channel so the audio thread doesn't work on it
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
+	chan.tag = tag;
 
 	chan.decoder = se->CreateSeDecoder();
 	chan.decoder->SetPitch(pitch);
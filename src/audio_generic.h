@@ -57,6 +57,9 @@ public:
 	std::string BGM_GetType() const override;
 
 	void SE_Play(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance) override;
+	void SE_PlayTagged(std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance, int tag) override;
+	void SE_Adjust(int tag, int volume, int balance) override;
+	bool SE_IsPlaying(int tag) const override;
 	void SE_Stop() override;
 	virtual void Update() override;
 
@@ -94,6 +97,7 @@ private:
 		GenericAudio* instance = nullptr;
 		bool paused;
 		bool stopped;
+		int tag = 0;
 	};
 	struct Format {
 		int frequency;
@@ -103,7 +107,7 @@ private:
 	Format output_format = {};
 
 	bool PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStream stream, int volume, int pitch, int fadein, int balance);
-	bool PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance);
+	bool PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache> se, int volume, int pitch, int balance, int tag);
 
 	static constexpr unsigned nr_of_se_channels = 31;
 	static constexpr unsigned nr_of_bgm_channels = 2;
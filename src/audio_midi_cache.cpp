@@ -0,0 +1,396 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include "audio.h"
+#include "audio_decoder_midi.h"
+#include "audio_midi.h"
+#include "audio_midi_cache.h"
+#include "audio_resampler.h"
+#include "output.h"
+#include "utils.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+	constexpr int bytes_per_frame = sizeof(int16_t) * 2;
+	constexpr int render_chunk_bytes = AudioMidiData::tick_interval * bytes_per_frame;
+
+	// ~64 MB of PCM, a single track may use at most half of it (~3 minutes)
+	constexpr size_t cache_limit = 64 * 1024 * 1024;
+	constexpr size_t track_limit = cache_limit / 2;
+
+	// Main thread time spent rendering per frame at most. Less is used when
+	// the frame is already busy.
+	constexpr auto render_budget = 2ms;
+
+	typedef std::map<std::string, AudioMidiRef> cache_type;
+
+	cache_type cache;
+	size_t cache_size = 0;
+
+	struct RenderJob {
+		std::string key;
+		std::string name;
+		std::vector<uint8_t> file;
+		int pitch = 100;
+		std::unique_ptr<AudioDecoderBase> decoder;
+		AudioMidiRef data;
+		size_t end_bytes = 0;
+	};
+
+	std::deque<RenderJob> jobs;
+
+	// Tracks that failed to render or are too long, not retried
+	std::set<std::string> rejected;
+
+	std::string MakeKey(std::string_view name, int pitch) {
+		return fmt::format("{}:{}:{}:{}:{}", name, pitch,
+			Audio().GetFluidsynthEnabled(), Audio().GetWildMidiEnabled(), Audio().GetFluidsynthSoundfont());
+	}
+
+	void FreeCacheMemory() {
+		while (cache_size > cache_limit) {
+			// Evict the least recently used track that is not playing
+			auto lru = cache.end();
+			for (auto it = cache.begin(); it != cache.end(); ++it) {
+				if (it->second.use_count() > 1) {
+					continue;
+				}
+				if (lru == cache.end() || it->second->last_access < lru->second->last_access) {
+					lru = it;
+				}
+			}
+
+			if (lru == cache.end()) {
+				break;
+			}
+
+#ifdef CACHE_DEBUG
+			Output::Debug("MIDI: Freeing memory of {}", lru->first);
+#endif
+
+			cache_size -= lru->second->buffer.size();
+			cache.erase(lru);
+		}
+	}
+
+	void Reject(RenderJob& job) {
+		Output::Debug("MIDI: Not pre-rendering {}", job.key);
+		rejected.insert(job.key);
+		jobs.pop_front();
+	}
+
+	void Finish(RenderJob& job) {
+		auto& data = *job.data;
+		auto* midi = static_cast<AudioDecoderMidi*>(job.decoder.get());
+
+		// Cut the overshoot of the last chunk
+		if (data.buffer.size() > job.end_bytes) {
+			data.buffer.resize(job.end_bytes);
+		}
+		data.buffer.shrink_to_fit();
+
+		double loop_frames = midi->GetLoopTime().count() / 1'000'000.0 * EP_MIDI_FREQ * 100.0 / data.pitch;
+		data.loop_start = std::min<size_t>(static_cast<size_t>(loop_frames) * bytes_per_frame, data.buffer.size());
+		data.last_access = Game_Clock::GetFrameTime();
+
+		cache_size += data.buffer.size();
+		cache[job.key] = std::move(job.data);
+
+#ifdef CACHE_DEBUG
+		Output::Debug("MIDI cache size (Add): {}", cache_size / 1024.0 / 1024.0);
+#endif
+
+		jobs.pop_front();
+		FreeCacheMemory();
+	}
+
+	void Schedule(std::string key, Filesystem_Stream::InputStream& stream, int pitch) {
+		for (auto& job: jobs) {
+			if (job.key == key) {
+				return;
+			}
+		}
+
+		// Render from a private copy, the stream is still needed for live playback
+		RenderJob job;
+		job.key = std::move(key);
+		job.name = ToString(stream.GetName());
+		job.file = Utils::ReadStream(stream);
+		job.pitch = pitch;
+		stream.clear();
+		stream.seekg(0, std::ios::beg);
+
+		jobs.push_back(std::move(job));
+	}
+
+	bool Start(RenderJob& job) {
+		// Created on the first Update instead of in Create so that the decoder
+		// used for live playback is allocated first (FluidSynth shares its
+		// synth with the first instance only)
+		job.decoder = MidiDecoder::Create(false);
+		if (!job.decoder) {
+			return false;
+		}
+
+		Filesystem_Stream::InputStream is(new Filesystem_Stream::InputMemoryStreamBuf(std::move(job.file)), job.name);
+		if (!job.decoder->Open(std::move(is)) || !job.decoder->SetPitch(job.pitch)) {
+			return false;
+		}
+
+		auto* midi = static_cast<AudioDecoderMidi*>(job.decoder.get());
+		job.decoder->SetFormat(EP_MIDI_FREQ, AudioDecoderBase::Format::S16, 2);
+		job.decoder->SetVolume(100);
+
+		job.data = std::make_shared<AudioMidiData>();
+		job.data->pitch = job.pitch;
+		job.data->midi_volume = midi->SupportsMidiMessages();
+
+		double end_frames = midi->GetTotalTime().count() / 1'000'000.0 * EP_MIDI_FREQ * 100.0 / job.pitch;
+		job.end_bytes = static_cast<size_t>(end_frames) * bytes_per_frame;
+		if (job.end_bytes > track_limit) {
+			return false;
+		}
+		job.data->buffer.reserve(job.end_bytes + render_chunk_bytes);
+
+		return true;
+	}
+}
+
+std::unique_ptr<AudioDecoderBase> AudioMidiCache::Create(Filesystem_Stream::InputStream& stream, int pitch) {
+	char magic[4] = { 0 };
+	if (!stream.ReadIntoObj(magic)) {
+		return nullptr;
+	}
+	stream.seekg(0, std::ios::beg);
+	if (strncmp(magic, "MThd", 4) != 0) {
+		return nullptr;
+	}
+
+	std::string key = MakeKey(stream.GetName(), pitch);
+
+	auto it = cache.find(key);
+	if (it == cache.end()) {
+		if (rejected.find(key) == rejected.end()) {
+			Schedule(std::move(key), stream, pitch);
+		}
+		return nullptr;
+	}
+
+	it->second->last_access = Game_Clock::GetFrameTime();
+
+	std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioMidiDecoder>(it->second);
+#ifdef USE_AUDIO_RESAMPLER
+	dec = std::make_unique<AudioResampler>(std::move(dec));
+#endif
+	return dec;
+}
+
+void AudioMidiCache::Update() {
+	if (jobs.empty()) {
+		return;
+	}
+
+	// Stay in the idle part of the frame, the scene and drawing come first
+	auto start = Game_Clock::now();
+	auto deadline = std::min(start + render_budget, Game_Clock::GetFrameTime() + Game_Clock::GetTargetGameTimeStep() / 2);
+
+	do {
+		auto& job = jobs.front();
+		if (!job.decoder && !Start(job)) {
+			Reject(job);
+			continue;
+		}
+
+		auto& buffer = job.data->buffer;
+		auto* midi = static_cast<AudioDecoderMidi*>(job.decoder.get());
+
+		if (midi->IsFinished() || buffer.size() >= job.end_bytes) {
+			Finish(job);
+			continue;
+		}
+
+		if (buffer.size() >= track_limit) {
+			Reject(job);
+			continue;
+		}
+
+		job.data->ticks.push_back(midi->GetTicks());
+
+		size_t offset = buffer.size();
+		buffer.resize(offset + render_chunk_bytes);
+		if (job.decoder->Decode(buffer.data() + offset, render_chunk_bytes) < 0) {
+			Reject(job);
+			continue;
+		}
+	} while (!jobs.empty() && Game_Clock::now() < deadline);
+}
+
+void AudioMidiCache::Clear() {
+	jobs.clear();
+	rejected.clear();
+	cache.clear();
+	cache_size = 0;
+}
+
+AudioMidiDecoder::AudioMidiDecoder(const AudioMidiRef& data) :
+	data(data) {
+	music_type = "midi";
+	data->last_access = Game_Clock::GetFrameTime();
+}
+
+void AudioMidiDecoder::Pause() {
+	paused = true;
+}
+
+void AudioMidiDecoder::Resume() {
+	paused = false;
+}
+
+StereoVolume AudioMidiDecoder::GetVolume() const {
+	float base_gain;
+	if (data->midi_volume) {
+		// Same as AudioDecoderMidi: The volume scales CC7, the synthesizers
+		// apply it squared (FmMidi explicitly, FluidSynth and MIDI devices
+		// through the GM volume curve of 40 log10(CC7 / 127) dB).
+		// CC7 is rounded down like a channel volume of 127 would be.
+		float cc7 = std::floor(127.0f * volume / 100.0f) / 127.0f;
+		base_gain = 100.0f * cc7 * cc7;
+	} else {
+		base_gain = AdjustVolume(volume);
+	}
+
+	// Same balance curve as AudioDecoderMidi::ApplyLogVolume
+	int balance = GetBalance();
+	float left_gain = 1.f, right_gain = 1.f;
+	constexpr float pan_exp = 0.5012f;
+	if (balance <= 50) {
+		right_gain = std::pow(pan_exp, (50 - balance) / 10.f);
+	} else {
+		left_gain = std::pow(pan_exp, (balance - 50) / 10.f);
+	}
+	return { base_gain * left_gain, base_gain * right_gain };
+}
+
+void AudioMidiDecoder::SetVolume(int new_volume) {
+	// cancel any pending fades
+	fade_time = 0us;
+
+	volume = Utils::Clamp(static_cast<float>(new_volume), 0.0f, 100.0f);
+}
+
+void AudioMidiDecoder::SetFade(int end, std::chrono::milliseconds duration) {
+	fade_time = 0us;
+
+	if (duration <= 0ms) {
+		SetVolume(end);
+		return;
+	}
+
+	fade_time = duration;
+	delta_volume_step = (static_cast<float>(end) - volume) / fade_time.count();
+}
+
+void AudioMidiDecoder::Update(std::chrono::microseconds delta) {
+	if (paused || fade_time <= 0us) {
+		return;
+	}
+
+	fade_time -= delta;
+
+	volume += static_cast<float>(delta.count()) * delta_volume_step;
+	volume = Utils::Clamp(volume, 0.0f, 100.0f);
+}
+
+bool AudioMidiDecoder::IsFinished() const {
+	if (loops_to_end) {
+		return false;
+	}
+
+	return offset >= data->buffer.size();
+}
+
+void AudioMidiDecoder::GetFormat(int& frequency, AudioDecoderBase::Format& format, int& channels) const {
+	frequency = EP_MIDI_FREQ;
+	format = AudioDecoderBase::Format::S16;
+	channels = 2;
+}
+
+int AudioMidiDecoder::GetPitch() const {
+	return data->pitch;
+}
+
+bool AudioMidiDecoder::SetPitch(int pitch) {
+	// The tempo is baked into the rendered track, other pitches are handled by the resampler
+	return pitch == data->pitch;
+}
+
+bool AudioMidiDecoder::Seek(std::streamoff offset, std::ios_base::seekdir origin) {
+	if (offset == 0 && origin == std::ios_base::beg) {
+		// Same as AudioDecoderMidi: Rewinding jumps to the loop point
+		this->offset = data->loop_start;
+
+		// When the loop points to the end of the track keep it alive to match
+		// RPG_RT behaviour.
+		loops_to_end = this->offset >= data->buffer.size();
+		return true;
+	}
+
+	return false;
+}
+
+int AudioMidiDecoder::GetTicks() const {
+	auto& ticks = data->ticks;
+	if (ticks.empty()) {
+		return 0;
+	}
+
+	size_t frame = std::min(offset, data->buffer.size()) / bytes_per_frame;
+	size_t idx = frame / AudioMidiData::tick_interval;
+	if (idx + 1 >= ticks.size()) {
+		return ticks.back();
+	}
+
+	// Interpolate between the sampled positions
+	int frac = frame % AudioMidiData::tick_interval;
+	return ticks[idx] + (ticks[idx + 1] - ticks[idx]) * frac / AudioMidiData::tick_interval;
+}
+
+int AudioMidiDecoder::FillBuffer(uint8_t* buffer, int size) {
+	if (loops_to_end) {
+		memset(buffer, '\0', size);
+		return size;
+	}
+
+	int real_size = size;
+
+	if (offset + size > data->buffer.size()) {
+		real_size = data->buffer.size() - offset;
+	}
+
+	memcpy(buffer, data->buffer.data() + offset, real_size);
+	offset += real_size;
+
+	return real_size;
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_MIDI_CACHE_H
+#define EP_AUDIO_MIDI_CACHE_H
+
+// Headers
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "audio_decoder_base.h"
+#include "game_clock.h"
+
+/**
+ * AudioMidiData contains a MIDI track rendered to PCM (S16, stereo,
+ * EP_MIDI_FREQ).
+ */
+class AudioMidiData {
+public:
+	std::vector<uint8_t> buffer;
+	/** Byte offset where playback continues after the end was reached */
+	size_t loop_start = 0;
+	/** Pitch (tempo) the track was rendered with */
+	int pitch = 100;
+	/** Whether the synthesizer applied the volume through MIDI messages */
+	bool midi_volume = true;
+	/** MIDI ticks at the start of every tick_interval frames, for GetTicks */
+	std::vector<int> ticks;
+	Game_Clock::time_point last_access;
+
+	static constexpr int tick_interval = 1024;
+};
+
+typedef std::shared_ptr<AudioMidiData> AudioMidiRef;
+
+/**
+ * AudioMidiDecoder plays a pre-rendered MIDI track and mimics the loop,
+ * tick and volume behaviour of AudioDecoderMidi.
+ */
+class AudioMidiDecoder : public AudioDecoderBase {
+public:
+	explicit AudioMidiDecoder(const AudioMidiRef& data);
+
+	bool Open(Filesystem_Stream::InputStream) override { return true; };
+	void Pause() override;
+	void Resume() override;
+
+	/**
+	 * Gets the volume of the rendered track.
+	 * Uses the same volume curve as live playback: When the synthesizer
+	 * supports MIDI messages the volume scales the channel volume (CC7),
+	 * which the synthesizers apply squared. Otherwise the RPG_RT curve of
+	 * AdjustVolume is used.
+	 *
+	 * @return current volume (from 0 - 100)
+	 */
+	StereoVolume GetVolume() const override;
+	void SetVolume(int volume) override;
+	void SetFade(int end, std::chrono::milliseconds duration) override;
+	void Update(std::chrono::microseconds delta) override;
+	bool IsFinished() const override;
+	void GetFormat(int& frequency, Format& format, int& channels) const override;
+	int GetPitch() const override;
+	bool SetPitch(int pitch) override;
+	bool Seek(std::streamoff offset, std::ios_base::seekdir origin) override;
+	int GetTicks() const override;
+
+private:
+	int FillBuffer(uint8_t* buffer, int size) override;
+
+	AudioMidiRef data;
+	size_t offset = 0;
+	bool loops_to_end = false;
+	bool paused = false;
+	float volume = 0.0f;
+
+	std::chrono::microseconds fade_time = std::chrono::microseconds(0);
+	float delta_volume_step = 0.0f;
+};
+
+/**
+ * AudioMidiCache renders MIDI BGM to PCM once and serves later plays of
+ * the same track from memory.
+ * Rendering is time-sliced in Update on the main thread so the audio
+ * thread never synthesizes a cached track. It uses the idle part of the
+ * frame and at most a few ms per frame. Entries are keyed by file,
+ * pitch and MIDI synthesizer settings. The least recently used entries
+ * are dropped when the memory budget is exceeded.
+ */
+namespace AudioMidiCache {
+	/**
+	 * Returns a decoder for the pre-rendered track when it is cached.
+	 * On a cache miss a render job is scheduled and null is returned, the
+	 * caller is expected to play the MIDI live in the meantime.
+	 *
+	 * @param stream Stream to the audio file, points at the beginning on return
+	 * @param pitch Pitch (tempo) of the BGM
+	 * @return decoder of the cached track or null
+	 */
+	std::unique_ptr<AudioDecoderBase> Create(Filesystem_Stream::InputStream& stream, int pitch);
+
+	/**
+	 * Advances pending render jobs within a small time budget.
+	 * Renders at least one chunk per call, then stops when the budget is
+	 * used up or half of the frame time has passed.
+	 * Must be called once per frame.
+	 */
+	void Update();
+
+	/**
+	 * Drops all cached tracks and pending render jobs.
+	 */
+	void Clear();
+}
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "audio_offline.h"
+#include "game_clock.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+
+OfflineAudio::OfflineAudio(const Game_ConfigAudio& cfg, int frequency) :
+	GenericAudio(cfg), frequency(frequency) {
+	block.resize(block_frames * 2);
+	SetFormat(frequency, AudioDecoder::Format::S16, 2);
+}
+
+void OfflineAudio::Render(int16_t* output, int frames) {
+	while (frames > 0) {
+		if (block_pos == block_frames) {
+			// Decode is always called with the same length, otherwise the mixer
+			// reallocates its buffers
+			Decode(reinterpret_cast<uint8_t*>(block.data()), block_frames * 2 * sizeof(int16_t));
+			block_pos = 0;
+		}
+		int chunk = std::min(frames, block_frames - block_pos);
+		std::memcpy(output, block.data() + block_pos * 2, chunk * 2 * sizeof(int16_t));
+		output += chunk * 2;
+		frames -= chunk;
+		block_pos += chunk;
+	}
+}
+
+namespace {
+	void WriteLE(std::ostream& os, uint32_t value, int bytes) {
+		for (int i = 0; i < bytes; ++i) {
+			os.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+		}
+	}
+}
+
+int OfflineAudio::RenderWav(std::ostream& os, std::chrono::microseconds duration) {
+	const int channels = 2;
+	const int bytes_per_frame = channels * sizeof(int16_t);
+	const int frames = static_cast<int>(static_cast<int64_t>(frequency) * duration.count() / 1000000);
+	const uint32_t data_size = static_cast<uint32_t>(frames) * bytes_per_frame;
+
+	os.write("RIFF", 4);
+	WriteLE(os, 36 + data_size, 4);
+	os.write("WAVE", 4);
+	os.write("fmt ", 4);
+	WriteLE(os, 16, 4);
+	WriteLE(os, 1, 2); // PCM
+	WriteLE(os, channels, 2);
+	WriteLE(os, frequency, 4);
+	WriteLE(os, frequency * bytes_per_frame, 4);
+	WriteLE(os, bytes_per_frame, 2);
+	WriteLE(os, 16, 2);
+	os.write("data", 4);
+	WriteLE(os, data_size, 4);
+
+	const int frames_per_update = std::max(1, static_cast<int>(frequency / Game_Clock::GetTargetGameFps()));
+	std::vector<int16_t> samples(frames_per_update * channels);
+
+	int remaining = frames;
+	while (remaining > 0) {
+		int chunk = std::min(remaining, frames_per_update);
+		Update();
+		Render(samples.data(), chunk);
+		for (int i = 0; i < chunk * channels; ++i) {
+			uint16_t s = static_cast<uint16_t>(samples[i]);
+			Utils::SwapByteOrder(s);
+			samples[i] = static_cast<int16_t>(s);
+		}
+		os.write(reinterpret_cast<const char*>(samples.data()), chunk * bytes_per_frame);
+		remaining -= chunk;
+	}
+
+	return frames;
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_AUDIO_OFFLINE_H
+#define EP_AUDIO_OFFLINE_H
+
+#include "audio_generic.h"
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * A headless GenericAudio that is driven by the caller instead of by the
+ * callback of an audio device.
+ * Audio is mixed as fast as possible, this is used for benchmarking the
+ * decoders and the mixer and for rendering audio to a WAV file.
+ *
+ * The output format is always signed 16 bit stereo.
+ */
+class OfflineAudio : public GenericAudio {
+public:
+	/**
+	 * @param cfg audio configuration
+	 * @param frequency output sample rate
+	 */
+	OfflineAudio(const Game_ConfigAudio& cfg, int frequency = 44100);
+
+	void LockMutex() const override {}
+	void UnlockMutex() const override {}
+
+	/**
+	 * Mixes the next frames of all playing channels.
+	 *
+	 * @param output buffer receiving frames * 2 interleaved samples
+	 * @param frames amount of stereo frames to render
+	 */
+	void Render(int16_t* output, int frames);
+
+	/**
+	 * Renders the next duration of audio as a complete WAV file.
+	 * Update is invoked once per rendered game frame so that fades and
+	 * the MIDI cache progress like during normal playback.
+	 *
+	 * @param os stream receiving the WAV file
+	 * @param duration length of the rendered audio
+	 * @return amount of stereo frames written
+	 */
+	int RenderWav(std::ostream& os, std::chrono::microseconds duration);
+
+	/** @return output sample rate */
+	int GetFrequency() const;
+
+	/** Amount of frames mixed per call of GenericAudio::Decode */
+	static constexpr int block_frames = 1024;
+
+private:
+	int frequency;
+	std::vector<int16_t> block;
+	int block_pos = block_frames;
+};
+
+inline int OfflineAudio::GetFrequency() const {
+	return frequency;
+}
+
+#endif
@@ -195,6 +195,7 @@ AudioResampler::AudioResampler(std::unique_ptr<AudioDecoderBase> wrapped, AudioR
 	#if defined(HAVE_LIBSPEEXDSP)
 		switch (quality) {
 			case Quality::Low:
+			case Quality::Linear:
 				sampling_quality = 0;
 				break;
 			case Quality::Medium:
@@ -207,6 +208,7 @@ AudioResampler::AudioResampler(std::unique_ptr<AudioDecoderBase> wrapped, AudioR
 	#elif defined(HAVE_LIBSAMPLERATE)
 		switch (quality) {
 			case Quality::Low:
+			case Quality::Linear:
 				sampling_quality = SRC_SINC_FASTEST;
 				break;
 			case Quality::Medium:
@@ -216,6 +218,21 @@ AudioResampler::AudioResampler(std::unique_ptr<AudioDecoderBase> wrapped, AudioR
 				sampling_quality = SRC_SINC_BEST_QUALITY;
 				break;
 		}
+	#elif defined(WANT_BUILTIN_RESAMPLER)
+		switch (quality) {
+			case Quality::Linear:
+				sampling_quality = static_cast<int>(SincResampler::Quality::Linear);
+				break;
+			case Quality::Low:
+				sampling_quality = static_cast<int>(SincResampler::Quality::Low);
+				break;
+			case Quality::Medium:
+				sampling_quality = static_cast<int>(SincResampler::Quality::Medium);
+				break;
+			case Quality::High:
+				sampling_quality = static_cast<int>(SincResampler::Quality::High);
+				break;
+		}
 	#endif
 
 	finished = false;
@@ -261,6 +278,8 @@ bool AudioResampler::Open(Filesystem_Stream::InputStream stream) {
 			speex_resampler_skip_zeros(conversion_state);
 		#elif defined(HAVE_LIBSAMPLERATE)
 			conversion_state = src_new(sampling_quality, nr_of_channels, &lasterror);
+		#elif defined(WANT_BUILTIN_RESAMPLER)
+			conversion_state = std::make_unique<SincResampler>(nr_of_channels, static_cast<SincResampler::Quality>(sampling_quality));
 		#endif
 
 		//Init the conversion data structure
@@ -306,6 +325,8 @@ bool AudioResampler::Seek(std::streamoff offset, std::ios_base::seekdir origin)
 			speex_resampler_reset_mem(conversion_state);
 		#elif defined(HAVE_LIBSAMPLERATE)
 			src_reset(conversion_state);
+		#elif defined(WANT_BUILTIN_RESAMPLER)
+			conversion_state->Reset();
 		#endif
 		return true;
 	}
@@ -419,9 +440,11 @@ int AudioResampler::FillBuffer(uint8_t* buffer, int length) {
 	int sample_size = AudioDecoder::GetSamplesizeForFormat(output_format);
 
 	// Duplicate data from the back, allows writing to the buffer directly
-	for (int i = amount_filled - sample_size; i > 0; i -= sample_size) {
-		// left channel
-		memcpy(&buffer[i * 2], &buffer[i], sample_size);
+	for (int i = amount_filled - sample_size; i >= 0; i -= sample_size) {
+		// left channel, the first sample is already in place
+		if (i > 0) {
+			memcpy(&buffer[i * 2], &buffer[i], sample_size);
+		}
 		// right channel
 		memcpy(&buffer[i * 2 + sample_size], &buffer[i], sample_size);
 	}
@@ -466,9 +489,7 @@ int AudioResampler::FillBufferSameRate(uint8_t* buffer, int length) {
 			}
 
 			//Copy the converted samples
-			for (int i = 0; i < amount_of_data_read*output_samplesize; i++) {
-				buffer[i] = internal_buffer[i];
-			}
+			memcpy(buffer, internal_buffer, amount_of_data_read*output_samplesize);
 			//Prepare next loop
 			total_output_frames -= amount_of_data_read;
 			decoded += amount_of_data_read;
@@ -529,13 +550,10 @@ int AudioResampler::FillBufferDifferentRate(uint8_t* buffer, int length) {
 		unused_frames = conversion_data.input_frames - conversion_data.input_frames_used;
 		empty_buffer_space = buffer_size / output_samplesize - unused_frames*nr_of_channels;
 
-		advanced_input_buffer = internal_buffer;
-
 		//If there is still unused data in the input_buffer order it to the front
-		for (int i = 0; i < unused_frames*nr_of_channels*output_samplesize; i++) {
-			*advanced_input_buffer = *(advanced_input_buffer + empty_buffer_space*output_samplesize);
-			advanced_input_buffer++;
-		}
+		//The unused data starts after the used frames of the last cycle (the buffer is not full at the end of the stream)
+		memmove(internal_buffer, internal_buffer + conversion_data.input_frames_used*nr_of_channels*output_samplesize, unused_frames*nr_of_channels*output_samplesize);
+		advanced_input_buffer = internal_buffer + unused_frames*nr_of_channels*output_samplesize;
 		//advanced_input_buffer is now offset to the first frame of new data!
 
 		//ensure that the input buffer is not able to overrun
@@ -613,6 +631,17 @@ int AudioResampler::FillBufferDifferentRate(uint8_t* buffer, int length) {
 				error_message = src_strerror(error);
 				return ERROR;
 			}
+		#elif defined(WANT_BUILTIN_RESAMPLER)
+			(void)error;
+			if (pitch_handled_by_decoder) {
+				conversion_state->SetRate(input_rate, output_rate);
+			} else {
+				conversion_state->SetRate(input_rate*pitch, output_rate*STANDARD_PITCH);
+			}
+
+			conversion_data.input_frames_used = conversion_data.input_frames;
+			conversion_data.output_frames_gen = conversion_data.output_frames;
+			conversion_state->Process((float*)internal_buffer, conversion_data.input_frames_used, (float*)buffer, conversion_data.output_frames_gen);
 		#endif
 
 		total_output_frames -= conversion_data.output_frames_gen;
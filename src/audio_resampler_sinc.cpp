@@ -0,0 +1,290 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Headers
+#include "audio_resampler_sinc.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  include <xmmintrin.h>
+#  define EP_RESAMPLER_SSE
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define EP_RESAMPLER_NEON
+#elif defined(__wasm_simd128__)
+#  include <wasm_simd128.h>
+#  define EP_RESAMPLER_WASM
+#endif
+
+namespace {
+	/** Largest table (in floats) that is built with one phase per output position */
+	constexpr int max_exact_table = 32768;
+	/** Phases of the interpolated table */
+	constexpr int interpolated_phases = 256;
+
+	/**
+	 * Dot product of two float arrays.
+	 *
+	 * @param a first array
+	 * @param b second array
+	 * @param n length, a multiple of 4
+	 */
+	inline float Dot(const float* a, const float* b, int n) {
+#if defined(EP_RESAMPLER_SSE)
+		__m128 sum = _mm_setzero_ps();
+		for (int i = 0; i < n; i += 4) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		}
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+		return _mm_cvtss_f32(sum);
+#elif defined(EP_RESAMPLER_NEON)
+		float32x4_t sum = vdupq_n_f32(0.0f);
+		for (int i = 0; i < n; i += 4) {
+			sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+		}
+		float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+		return vget_lane_f32(vpadd_f32(half, half), 0);
+#elif defined(EP_RESAMPLER_WASM)
+		v128_t sum = wasm_f32x4_splat(0.0f);
+		for (int i = 0; i < n; i += 4) {
+			sum = wasm_f32x4_add(sum, wasm_f32x4_mul(wasm_v128_load(a + i), wasm_v128_load(b + i)));
+		}
+		return wasm_f32x4_extract_lane(sum, 0) + wasm_f32x4_extract_lane(sum, 1) +
+			wasm_f32x4_extract_lane(sum, 2) + wasm_f32x4_extract_lane(sum, 3);
+#else
+		float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+		for (int i = 0; i < n; i += 4) {
+			s0 += a[i] * b[i];
+			s1 += a[i + 1] * b[i + 1];
+			s2 += a[i + 2] * b[i + 2];
+			s3 += a[i + 3] * b[i + 3];
+		}
+		return (s0 + s1) + (s2 + s3);
+#endif
+	}
+
+	/** Zeroth order modified Bessel function of the first kind */
+	double BesselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+		for (int k = 1; k < 32; ++k) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+			if (term < sum * 1e-12) {
+				break;
+			}
+		}
+		return sum;
+	}
+}
+
+SincResampler::SincResampler(int channels, Quality quality) :
+	channels(channels), quality(quality) {
+	assert(channels > 0);
+
+	switch (quality) {
+		case Quality::Linear:
+			taps = 2;
+			cutoff_scale = 1.0f;
+			kaiser_beta = 0.0f;
+			break;
+		case Quality::Low:
+			taps = 16;
+			cutoff_scale = 0.90f;
+			kaiser_beta = 5.0f;
+			break;
+		case Quality::Medium:
+			taps = 32;
+			cutoff_scale = 0.94f;
+			kaiser_beta = 7.0f;
+			break;
+		case Quality::High:
+			taps = 64;
+			cutoff_scale = 0.97f;
+			kaiser_beta = 9.0f;
+			break;
+	}
+
+	row.resize(taps);
+	BuildFilter();
+	Reset();
+}
+
+void SincResampler::SetRate(uint32_t new_num, uint32_t new_den) {
+	assert(new_num > 0 && new_den > 0);
+
+	uint32_t g = std::gcd(new_num, new_den);
+	new_num /= g;
+	new_den /= g;
+
+	if (new_num == num && new_den == den) {
+		return;
+	}
+
+	// Keep the position between two input frames
+	frac = static_cast<uint32_t>(static_cast<uint64_t>(frac) * new_den / den);
+	num = new_num;
+	den = new_den;
+	BuildFilter();
+}
+
+void SincResampler::Reset() {
+	// Half a filter of silence, the first output frame is centered on the
+	// first input frame
+	history_frames = taps / 2 - 1;
+	position = 0;
+	frac = 0;
+	if (history_capacity < history_frames) {
+		history_capacity = history_frames;
+		history.resize(history_capacity * channels);
+	}
+	std::fill(history.begin(), history.end(), 0.0f);
+}
+
+void SincResampler::BuildFilter() {
+	if (quality == Quality::Linear) {
+		phases = 0;
+		exact = false;
+		filter.clear();
+		return;
+	}
+
+	exact = static_cast<int64_t>(den) * taps <= max_exact_table;
+	phases = exact ? static_cast<int>(den) : interpolated_phases;
+	// Interpolated tables have an additional row for the phase 1.0
+	const int rows = exact ? phases : phases + 1;
+
+	// Lower the cutoff frequency when downsampling to prevent aliasing
+	const double cutoff = cutoff_scale * std::min(1.0, static_cast<double>(den) / num);
+	const double half = taps / 2;
+	const double i0_beta = BesselI0(kaiser_beta);
+
+	filter.resize(static_cast<size_t>(rows) * taps);
+	for (int p = 0; p < rows; ++p) {
+		float* coeffs = &filter[static_cast<size_t>(p) * taps];
+		const double phase = static_cast<double>(p) / phases;
+		double sum = 0.0;
+		for (int k = 0; k < taps; ++k) {
+			double x = k - (half - 1) - phase;
+			double t = x / half;
+			double window = (std::abs(t) < 1.0) ? BesselI0(kaiser_beta * std::sqrt(1.0 - t * t)) / i0_beta : 0.0;
+			double sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			double h = cutoff * sinc * window;
+			coeffs[k] = static_cast<float>(h);
+			sum += h;
+		}
+		// Normalize to unity gain at DC
+		for (int k = 0; k < taps; ++k) {
+			coeffs[k] = static_cast<float>(coeffs[k] / sum);
+		}
+	}
+}
+
+void SincResampler::Process(const float* input, int& input_frames, float* output, int& output_frames) {
+	const int out_capacity = output_frames;
+	output_frames = 0;
+
+	// Only consume the input that is needed for the requested output
+	int consumed = 0;
+	if (out_capacity > 0) {
+		int64_t last = position + (static_cast<uint64_t>(frac) + static_cast<uint64_t>(out_capacity - 1) * num) / den;
+		int64_t needed = last + taps - history_frames;
+		consumed = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(needed, input_frames)));
+	}
+	input_frames = consumed;
+
+	if (history_frames + consumed > history_capacity) {
+		int new_capacity = std::max(history_frames + consumed, history_capacity * 2);
+		std::vector<float> new_history(static_cast<size_t>(new_capacity) * channels);
+		for (int ch = 0; ch < channels; ++ch) {
+			std::copy_n(&history[static_cast<size_t>(ch) * history_capacity], history_frames, &new_history[static_cast<size_t>(ch) * new_capacity]);
+		}
+		history.swap(new_history);
+		history_capacity = new_capacity;
+	}
+
+	// Deinterleave, the filter runs on contiguous samples of a channel
+	for (int ch = 0; ch < channels; ++ch) {
+		float* dst = &history[static_cast<size_t>(ch) * history_capacity + history_frames];
+		const float* src = input + ch;
+		for (int i = 0; i < consumed; ++i) {
+			dst[i] = src[i * channels];
+		}
+	}
+	history_frames += consumed;
+
+	const uint32_t step = num / den;
+	const uint32_t step_frac = num % den;
+
+	int out = 0;
+	while (out < out_capacity && position + taps <= history_frames) {
+		const float* base = &history[position];
+		float* dst = output + out * channels;
+
+		if (quality == Quality::Linear) {
+			const float a = static_cast<float>(frac) / den;
+			for (int ch = 0; ch < channels; ++ch) {
+				const float* s = base + static_cast<size_t>(ch) * history_capacity;
+				dst[ch] = s[0] + a * (s[1] - s[0]);
+			}
+		} else {
+			const float* coeffs;
+			if (exact) {
+				coeffs = &filter[static_cast<size_t>(frac) * taps];
+			} else {
+				uint64_t scaled = static_cast<uint64_t>(frac) * phases;
+				int p = static_cast<int>(scaled / den);
+				float a = static_cast<float>(scaled % den) / den;
+				const float* r0 = &filter[static_cast<size_t>(p) * taps];
+				const float* r1 = r0 + taps;
+				for (int k = 0; k < taps; ++k) {
+					row[k] = r0[k] + a * (r1[k] - r0[k]);
+				}
+				coeffs = row.data();
+			}
+			for (int ch = 0; ch < channels; ++ch) {
+				dst[ch] = Dot(coeffs, base + static_cast<size_t>(ch) * history_capacity, taps);
+			}
+		}
+
+		++out;
+		position += step;
+		frac += step_frac;
+		if (frac >= den) {
+			frac -= den;
+			++position;
+		}
+	}
+	output_frames = out;
+
+	// Drop the history that is not needed anymore
+	int drop = static_cast<int>(std::min<int64_t>(position, history_frames));
+	if (drop > 0) {
+		for (int ch = 0; ch < channels; ++ch) {
+			float* h = &history[static_cast<size_t>(ch) * history_capacity];
+			std::memmove(h, h + drop, (history_frames - drop) * sizeof(float));
+		}
+		history_frames -= drop;
+		position -= drop;
+	}
+}
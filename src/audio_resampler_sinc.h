@@ -0,0 +1,120 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_AUDIO_RESAMPLER_SINC_H
+#define EP_AUDIO_RESAMPLER_SINC_H
+
+// Headers
+#include <cstdint>
+#include <vector>
+
+/**
+ * Built-in windowed-sinc polyphase resampler.
+ * Used by the AudioResampler when neither libspeexdsp nor libsamplerate
+ * are available.
+ *
+ * Operates on interleaved float samples. The rate is given as a fraction
+ * input/output. When the reduced denominator is small enough the filter
+ * table contains one phase per output position and no phase interpolation
+ * is needed, this covers integer ratios and the common 11025/22050/32000
+ * to 44100 Hz conversions. Other ratios interpolate linearly between
+ * neighbouring phases of an oversampled table.
+ */
+class SincResampler {
+public:
+	/** Resampling quality */
+	enum class Quality {
+		/** Linear interpolation without filter, intended for SE */
+		Linear,
+		/** 16 taps */
+		Low,
+		/** 32 taps */
+		Medium,
+		/** 64 taps */
+		High
+	};
+
+	/**
+	 * @param channels Amount of interleaved channels
+	 * @param quality Filter quality
+	 */
+	SincResampler(int channels, Quality quality);
+
+	/**
+	 * Sets the conversion ratio. The filter table is only rebuilt when the
+	 * ratio changed.
+	 *
+	 * @param num input rate (e.g. input frequency * pitch)
+	 * @param den output rate (e.g. output frequency * 100)
+	 */
+	void SetRate(uint32_t num, uint32_t den);
+
+	/**
+	 * Clears the sample history, e.g. after seeking.
+	 */
+	void Reset();
+
+	/**
+	 * Resamples interleaved input.
+	 * Only the input that is needed to produce output_frames is consumed,
+	 * the remaining input must be passed again in the next call.
+	 *
+	 * @param[in] input Interleaved input samples
+	 * @param[in,out] input_frames Available input frames, receives consumed frames
+	 * @param[out] output Interleaved output samples
+	 * @param[in,out] output_frames Capacity of output in frames, receives generated frames
+	 */
+	void Process(const float* input, int& input_frames, float* output, int& output_frames);
+
+	/** @return Amount of filter taps (2 for linear interpolation) */
+	int GetTaps() const;
+
+private:
+	void BuildFilter();
+
+	int channels;
+	Quality quality;
+	int taps;
+	float cutoff_scale;
+	float kaiser_beta;
+
+	uint32_t num = 1;
+	uint32_t den = 1;
+	/** Amount of filter phases in the table */
+	int phases = 0;
+	/** Whether phases == den and phases are used directly */
+	bool exact = true;
+	std::vector<float> filter;
+	/** Blended filter row when phases are interpolated */
+	std::vector<float> row;
+
+	/** Planar history, one block of history_capacity samples per channel */
+	std::vector<float> history;
+	int history_capacity = 0;
+	int history_frames = 0;
+	/** History frame of the first filter tap of the next output frame */
+	int64_t position = 0;
+	/** Fractional part of the position in units of 1/den */
+	uint32_t frac = 0;
+};
+
+inline int SincResampler::GetTaps() const {
+	return taps;
+}
+
+#endif
@@ -143,7 +143,7 @@ std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
 
 		std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
 #ifdef USE_AUDIO_RESAMPLER
-		dec = std::make_unique<AudioResampler>(std::move(dec));
+		dec = std::make_unique<AudioResampler>(std::move(dec), AudioResampler::Quality::Linear);
 #endif
 		Filesystem_Stream::InputStream is;
 		dec->Open(std::move(is));
@@ -173,7 +173,7 @@ std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
 
 	std::unique_ptr<AudioDecoderBase> dec = std::unique_ptr<AudioDecoderBase>(new AudioSeDecoder(se));
 #ifdef USE_AUDIO_RESAMPLER
-	dec = std::unique_ptr<AudioDecoderBase>(new AudioResampler(std::move(dec)));
+	dec = std::unique_ptr<AudioDecoderBase>(new AudioResampler(std::move(dec), AudioResampler::Quality::Linear));
 #endif
 	Filesystem_Stream::InputStream is;
 	dec->Open(std::move(is));
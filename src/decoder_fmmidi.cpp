@@ -26,9 +26,17 @@
 #include "output.h"
 #include "decoder_fmmidi.h"
 
+namespace {
+	// Upper bound of simultaneous FM voices. An excess note steals a voice that is
+	// fading out, otherwise a released one, otherwise a held one; the oldest of
+	// these is taken.
+	constexpr int max_polyphony = 64;
+}
+
 FmMidiDecoder::FmMidiDecoder() {
 	note_factory.reset(new midisynth::fm_note_factory());
 	synth.reset(new midisynth::synthesizer(note_factory.get()));
+	synth->set_polyphony(max_polyphony);
 
 	load_programs();
 }
@@ -21,7 +21,11 @@
 #include "output.h"
 #include "platform.h"
 #include "player.h"
+#include "utils.h"
 #include <lcf/reader_util.h>
+#include <algorithm>
+#include <istream>
+#include <ostream>
 
 //#define EP_DEBUG_DIRECTORYTREE
 #ifdef EP_DEBUG_DIRECTORYTREE
@@ -38,6 +42,37 @@ namespace {
 	std::string make_key(std::string_view n) {
 		return lcf::ReaderUtil::Normalize(n);
 	};
+
+	constexpr std::string_view index_magic = "EasyRPG-PathIndex";
+	constexpr uint32_t index_version = 1;
+	// Upper limit for names in the index, protects against corrupted files
+	constexpr uint32_t index_max_name_length = 0xFFFF;
+
+	void write_u32(std::ostream& os, uint32_t value) {
+		Utils::SwapByteOrder(value);
+		os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	void write_string(std::ostream& os, std::string_view str) {
+		write_u32(os, static_cast<uint32_t>(str.size()));
+		os.write(str.data(), str.size());
+	}
+
+	bool read_u32(std::istream& is, uint32_t& value) {
+		is.read(reinterpret_cast<char*>(&value), sizeof(value));
+		Utils::SwapByteOrder(value);
+		return is.good();
+	}
+
+	bool read_string(std::istream& is, std::string& str) {
+		uint32_t size;
+		if (!read_u32(is, size) || size > index_max_name_length) {
+			return false;
+		}
+		str.resize(size);
+		is.read(&str[0], size);
+		return is.gcount() == static_cast<std::streamsize>(size);
+	}
 }
 
 std::unique_ptr<DirectoryTree> DirectoryTree::Create() {
@@ -185,6 +220,12 @@ DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(std::string_view
 	DebugLog("ListDirectory Content: {}", ss.str());
 #endif
 
+	// The enumerated content replaces the content of the index
+	auto index_it = Find(index_cache, dir_key);
+	if (index_it != index_cache.end()) {
+		index_cache.erase(index_it);
+	}
+
 	InsertSorted(fs_cache, dir_key, std::move(fs_cache_entry));
 
 	return &Find(fs_cache, dir_key)->second;
@@ -197,6 +238,7 @@ void DirectoryTree::ClearCache(std::string_view path) const {
 		fs_cache.clear();
 		dir_cache.clear();
 		dir_missing_cache.clear();
+		index_cache.clear();
 		return;
 	}
 
@@ -209,6 +251,10 @@ void DirectoryTree::ClearCache(std::string_view path) const {
 	if (dir_it != dir_cache.end()) {
 		dir_cache.erase(dir_it);
 	}
+	auto index_it = Find(index_cache, dir_key);
+	if (index_it != index_cache.end()) {
+		index_cache.erase(index_it);
+	}
 	dir_missing_cache.erase(std::remove_if(dir_missing_cache.begin(), dir_missing_cache.end(), [&path] (const auto& dir) {
 		return StartsWith(dir, path);
 	}), dir_missing_cache.end());
@@ -232,6 +278,28 @@ std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 
 	DebugLog("FindFile: {} | {} | {} | {}", args.path, canonical_path, dir, name);
 
+	std::string dir_key = make_key(dir);
+	std::string name_key = make_key(name);
+
+	if (!args.process_wildcards) {
+		// Directories of the path index are used until a lookup in them fails.
+		// The first hit of a directory is checked for existence instead of
+		// enumerating the directory, afterwards it is trusted like the fs_cache.
+		auto index_it = Find(index_cache, dir_key);
+		if (index_it != index_cache.end()) {
+			auto& index_entry = index_it->second;
+			auto full_path = FindEntry(index_entry.entries, index_entry.path, name_key, args);
+			if (!full_path.empty() && (index_entry.verified || fs->Exists(full_path))) {
+				DebugLog("FindFile Found in Index: {} | {} | {}", dir, name, full_path);
+				index_entry.verified = true;
+				return full_path;
+			}
+			DebugLog("FindFile Not in Index or removed: {} | {}", dir, name);
+			// Enumerated again below
+			index_cache.erase(index_it);
+		}
+	}
+
 	auto* entries = ListDirectory(dir);
 	if (!entries) {
 		if (args.file_not_found_warning) {
@@ -241,34 +309,130 @@ std::string DirectoryTree::FindFile(const DirectoryTree::Args& args) const {
 		return "";
 	}
 
-	std::string dir_key = make_key(dir);
 	auto dir_it = Find(dir_cache, dir_key, args.process_wildcards);
 	assert(dir_it != dir_cache.end());
 
-	std::string name_key = make_key(name);
+	auto full_path = FindEntry(*entries, dir_it->second, name_key, args);
+	if (!full_path.empty()) {
+		DebugLog("FindFile Found: {} | {} | {}", dir, name, full_path);
+		return full_path;
+	}
+
+	if (args.file_not_found_warning) {
+		Output::Debug("Cannot find: {}/{}", dir, name);
+	}
+	DebugLog("FindFile Not Found: {} | {}", dir, name);
+
+	return "";
+}
+
+std::string DirectoryTree::FindEntry(const DirectoryListType& entries, std::string_view dir, const std::string& name_key, const DirectoryTree::Args& args) const {
 	if (args.exts.empty()) {
-		auto entry_it = Find(*entries, name_key, args.process_wildcards);
-		if (entry_it != entries->end() && entry_it->second.type == FileType::Regular) {
-			auto full_path = FileFinder::MakePath(dir_it->second, entry_it->second.name);
-			DebugLog("FindFile Found: {} | {} | {}", dir, name, full_path);
-			return full_path;
+		auto entry_it = Find(entries, name_key, args.process_wildcards);
+		if (entry_it != entries.end() && entry_it->second.type == FileType::Regular) {
+			return FileFinder::MakePath(dir, entry_it->second.name);
 		}
 	} else {
 		for (const auto& ext : args.exts) {
 			auto full_name_key = name_key + ToString(ext);
-			auto entry_it = Find(*entries, full_name_key, args.process_wildcards);
-			if (entry_it != entries->end() && entry_it->second.type == FileType::Regular) {
-				auto full_path = FileFinder::MakePath(dir_it->second, entry_it->second.name);
-				DebugLog("FindFile Found: {} | {} | {}", dir, name, full_path);
-				return full_path;
+			auto entry_it = Find(entries, full_name_key, args.process_wildcards);
+			if (entry_it != entries.end() && entry_it->second.type == FileType::Regular) {
+				return FileFinder::MakePath(dir, entry_it->second.name);
 			}
 		}
 	}
 
-	if (args.file_not_found_warning) {
-		Output::Debug("Cannot find: {}/{}", dir, name);
+	return "";
+}
+
+bool DirectoryTree::SaveIndex(std::ostream& os) const {
+	// Enumerated directories and directories of a previous index that were not enumerated yet
+	std::vector<std::tuple<std::string_view, std::string_view, const DirectoryListType*>> dirs;
+	for (const auto& it : fs_cache) {
+		auto dir_it = Find(dir_cache, it.first);
+		assert(dir_it != dir_cache.end());
+		dirs.emplace_back(it.first, dir_it->second, &it.second);
 	}
-	DebugLog("FindFile Not Found: {} | {}", dir, name);
+	for (const auto& it : index_cache) {
+		dirs.emplace_back(it.first, it.second.path, &it.second.entries);
+	}
+	std::sort(dirs.begin(), dirs.end(), [](const auto& a, const auto& b) {
+		return std::get<0>(a) < std::get<0>(b);
+	});
 
-	return "";
+	os.write(index_magic.data(), index_magic.size());
+	write_u32(os, index_version);
+	write_u32(os, static_cast<uint32_t>(dirs.size()));
+
+	for (const auto& dir : dirs) {
+		write_string(os, std::get<0>(dir));
+		write_string(os, std::get<1>(dir));
+
+		const auto& entries = *std::get<2>(dir);
+		write_u32(os, static_cast<uint32_t>(entries.size()));
+		for (const auto& entry : entries) {
+			write_string(os, entry.first);
+			write_string(os, entry.second.name);
+			os.put(static_cast<char>(entry.second.type));
+		}
+	}
+
+	return os.good();
+}
+
+bool DirectoryTree::LoadIndex(std::istream& is) const {
+	std::string magic(index_magic.size(), '\0');
+	is.read(&magic[0], magic.size());
+
+	uint32_t version = 0;
+	uint32_t num_dirs = 0;
+	if (magic != index_magic || !read_u32(is, version) || version != index_version || !read_u32(is, num_dirs)) {
+		return false;
+	}
+
+	auto by_key = [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	};
+
+	std::vector<index_cache_pair> index;
+	for (uint32_t i = 0; i < num_dirs; ++i) {
+		std::string dir_key;
+		IndexEntry index_entry;
+		uint32_t num_entries;
+		if (!read_string(is, dir_key) || !read_string(is, index_entry.path) || !read_u32(is, num_entries)) {
+			return false;
+		}
+
+		for (uint32_t j = 0; j < num_entries; ++j) {
+			std::string key;
+			std::string name;
+			if (!read_string(is, key) || !read_string(is, name)) {
+				return false;
+			}
+
+			auto type = is.get();
+			if (type < 0 || type > static_cast<int>(FileType::Other)) {
+				return false;
+			}
+			index_entry.entries.emplace_back(std::move(key), Entry(std::move(name), static_cast<FileType>(type)));
+		}
+
+		if (!std::is_sorted(index_entry.entries.begin(), index_entry.entries.end(), by_key)) {
+			return false;
+		}
+
+		// Directories that were already enumerated are more recent than the index
+		if (Find(dir_cache, dir_key) == dir_cache.end()) {
+			index.emplace_back(std::move(dir_key), std::move(index_entry));
+		}
+	}
+
+	if (!std::is_sorted(index.begin(), index.end(), by_key)) {
+		return false;
+	}
+
+	DebugLog("LoadIndex: {} directories", index.size());
+	index_cache = std::move(index);
+
+	return true;
 }
@@ -18,6 +18,7 @@
 #ifndef EP_DIRECTORY_TREE_H
 #define EP_DIRECTORY_TREE_H
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -132,6 +133,27 @@ public:
 
 	void ClearCache(std::string_view path) const;
 
+	/**
+	 * Writes all directories enumerated so far to a path index.
+	 * Loading the index on the next start skips the enumeration of these directories.
+	 *
+	 * @param os stream to write to
+	 * @return true on success
+	 */
+	bool SaveIndex(std::ostream& os) const;
+
+	/**
+	 * Loads a path index written by SaveIndex.
+	 * The index is only used by FindFile: The first file found in a directory
+	 * of the index is checked for existence. A directory of the index is
+	 * enumerated again when a file is not found in it or the first one was
+	 * removed, this way outdated indices are harmless.
+	 *
+	 * @param is stream to read from
+	 * @return true when the index is valid
+	 */
+	bool LoadIndex(std::istream& is) const;
+
 private:
 	Filesystem* fs = nullptr;
 
@@ -149,6 +171,18 @@ private:
 	/** lowered dir (full path from root) of missing directories */
 	mutable std::vector<std::string> dir_missing_cache;
 
+	/** lowered dir (full path from root) -> real dir and entries loaded from a path index */
+	struct IndexEntry {
+		std::string path;
+		DirectoryListType entries;
+		/** A file of the directory was found on disk, further hits are not checked */
+		bool verified = false;
+	};
+	using index_cache_pair = std::pair<std::string, IndexEntry>;
+	mutable std::vector<index_cache_pair> index_cache;
+
+	std::string FindEntry(const DirectoryListType& entries, std::string_view dir, const std::string& name_key, const DirectoryTree::Args& args) const;
+
 	static bool WildcardMatch(const std::string_view& pattern, const std::string_view& text);
 
 	template<class T>
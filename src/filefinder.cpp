@@ -62,6 +62,7 @@ namespace {
 	FilesystemView game_fs;
 	FilesystemView save_fs;
 	FilesystemView lang_fs;
+	bool path_index_loaded = false;
 }
 
 FilesystemView FileFinder::Game() {
@@ -139,6 +140,52 @@ void FileFinder::SetLanguageFilesystem(FilesystemView filesystem) {
 	lang_fs = filesystem;
 }
 
+bool FileFinder::LoadPathIndex() {
+	path_index_loaded = false;
+
+	auto fs = Save();
+	if (!game_fs || !fs) {
+		return false;
+	}
+
+	// Written on exit, also when no index exists yet
+	path_index_loaded = true;
+
+	auto is = fs.OpenFile(PATH_INDEX_NAME);
+	if (!is) {
+		return false;
+	}
+
+	if (!game_fs.GetOwner().LoadIndex(is)) {
+		Output::Debug("Path index {} is invalid, ignoring it", PATH_INDEX_NAME);
+		return false;
+	}
+
+	Output::Debug("Loaded path index {}", PATH_INDEX_NAME);
+	return true;
+}
+
+bool FileFinder::SavePathIndex() {
+	if (!path_index_loaded || !game_fs) {
+		return false;
+	}
+	path_index_loaded = false;
+
+	auto fs = Save();
+	if (!fs) {
+		return false;
+	}
+
+	auto found_file = fs.FindFile(PATH_INDEX_NAME);
+	auto os = fs.OpenOutputStream(found_file.empty() ? PATH_INDEX_NAME : found_file);
+	if (!os || !game_fs.GetOwner().SaveIndex(os)) {
+		Output::Warning("Failed to write path index {}", PATH_INDEX_NAME);
+		return false;
+	}
+
+	return true;
+}
+
 FilesystemView FileFinder::Root() {
 	if (!root_fs) {
 		root_fs = std::make_unique<RootFilesystem>();
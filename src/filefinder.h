@@ -145,6 +145,23 @@ namespace FileFinder {
 	 */
 	void SetLanguageFilesystem(FilesystemView filesystem);
 
+	/**
+	 * Loads the path index of the game filesystem from the save directory.
+	 * The index makes the directory enumeration on startup unnecessary.
+	 * It is only used for lookups of files and refreshed when a lookup fails.
+	 *
+	 * @return Whether an index was loaded
+	 */
+	bool LoadPathIndex();
+
+	/**
+	 * Writes the path index of the game filesystem to the save directory.
+	 * Does nothing when LoadPathIndex was not called for this game.
+	 *
+	 * @return Whether the index was written
+	 */
+	bool SavePathIndex();
+
 	/**
 	 * Finds an image file in the current RPG Maker game.
 	 *
@@ -46,7 +46,9 @@ public:
 	/** Features provided by the filesystem */
 	enum class Feature {
 		/** Filesystem supports Write operations */
-		Write = 1
+		Write = 1,
+		/** Paths of the filesystem are paths of the operating system */
+		NativePath = 2
 	};
 
 	virtual ~Filesystem() = default;
@@ -127,6 +129,24 @@ public:
 	 */
 	void ClearCache(std::string_view path) const;
 
+	/**
+	 * Writes the directories enumerated so far to a path index.
+	 * See DirectoryTree::SaveIndex.
+	 *
+	 * @param os Stream to write the index to
+	 * @return Whether the index was written
+	 */
+	bool SaveIndex(std::ostream& os) const;
+
+	/**
+	 * Loads a path index that was written by SaveIndex.
+	 * See DirectoryTree::LoadIndex.
+	 *
+	 * @param is Stream to read the index from
+	 * @return Whether the index was valid
+	 */
+	bool LoadIndex(std::istream& is) const;
+
 	/**
 	 * Creates a new appropriate filesystem from the specified path.
 	 * The path is processed to initialize the proper virtual filesystem handler.
@@ -514,6 +534,14 @@ inline DirectoryTree::DirectoryListType* Filesystem::ListDirectory(std::string_v
 	return tree->ListDirectory(path);
 }
 
+inline bool Filesystem::SaveIndex(std::ostream& os) const {
+	return tree->SaveIndex(os);
+}
+
+inline bool Filesystem::LoadIndex(std::istream& is) const {
+	return tree->LoadIndex(is);
+}
+
 inline Filesystem::operator FilesystemView() { return Subtree(""); }
 
 #endif
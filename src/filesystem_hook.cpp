@@ -107,6 +107,10 @@ bool HookFilesystem::MakeDirectory(std::string_view dir, bool follow_symlinks) c
 }
 
 bool HookFilesystem::IsFeatureSupported(Feature f) const {
+	// Paths are relative to the parent and the content can be altered by the hook
+	if (f == Feature::NativePath) {
+		return false;
+	}
 	return GetParent().IsFeatureSupported(f);
 }
 
@@ -27,16 +27,348 @@
 #include <iostream>
 #include <sstream>
 #include <cassert>
+#include <cstring>
 #include <algorithm>
+#include <limits>
 #include <fmt/format.h>
 
+#ifdef USE_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
 constexpr char end_of_central_directory[] = "\x50\x4b\x05\x06";
 constexpr int32_t end_of_central_directory_size = 18;
 
+constexpr uint32_t end_of_central_directory64 = 0x06064b50;
+constexpr uint32_t end_of_central_directory64_locator = 0x07064b50;
+constexpr int32_t end_of_central_directory64_locator_size = 20;
+
 constexpr uint32_t central_directory_entry = 0x02014b50;
 constexpr uint32_t local_header = 0x04034b50;
 constexpr uint32_t local_header_size = 30;
 
+constexpr uint16_t zip64_extra_field = 0x0001;
+constexpr uint32_t zip64_marker = 0xffffffff;
+
+// Deflated entries larger than this are inflated on demand while reading
+constexpr uint64_t inflate_stream_threshold = 256 * 1024;
+// Distance (in uncompressed bytes) between the decoder states kept for seeking
+constexpr uint64_t inflate_checkpoint_interval = 1024 * 1024;
+constexpr size_t inflate_buffer_size = 32 * 1024;
+
+template <typename T>
+static T read_le(const char* data) {
+	T value;
+	memcpy(&value, data, sizeof(T));
+	Utils::SwapByteOrder(value);
+	return value;
+}
+
+class ZipFilesystem::MappedFile {
+public:
+	MappedFile(const uint8_t* data, size_t size) : data(data), size(size) {}
+	MappedFile(MappedFile const& other) = delete;
+	MappedFile const& operator=(MappedFile const& other) = delete;
+	~MappedFile();
+
+	/**
+	 * Maps the file at the native path into memory.
+	 *
+	 * @param path native path of the file
+	 * @return mapping or nullptr when not supported by the platform or on error
+	 */
+	static std::shared_ptr<const MappedFile> Open(const std::string& path);
+
+	const uint8_t* const data;
+	const size_t size;
+};
+
+std::shared_ptr<const ZipFilesystem::MappedFile> ZipFilesystem::MappedFile::Open(const std::string& path) {
+#ifdef USE_MMAP
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return nullptr;
+	}
+	auto fd_sg = lcf::makeScopeGuard([&]() {
+		close(fd);
+	});
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0 || static_cast<uint64_t>(st.st_size) > std::numeric_limits<size_t>::max()) {
+		return nullptr;
+	}
+
+	const auto size = static_cast<size_t>(st.st_size);
+	void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (addr == MAP_FAILED) {
+		Output::Debug("ZipFS: mmap of {} failed", path);
+		return nullptr;
+	}
+
+	return std::make_shared<MappedFile>(static_cast<const uint8_t*>(addr), size);
+#else
+	(void)path;
+	return nullptr;
+#endif
+}
+
+ZipFilesystem::MappedFile::~MappedFile() {
+#ifdef USE_MMAP
+	munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
+
+class ZipFilesystem::MappedStreamBuf : public Filesystem_Stream::InputMemoryStreamBufView {
+public:
+	MappedStreamBuf(std::shared_ptr<const MappedFile> mapping, uint64_t offset, uint64_t size) :
+		InputMemoryStreamBufView(Span<uint8_t>(const_cast<uint8_t*>(mapping->data) + offset, static_cast<size_t>(size))),
+		mapping(std::move(mapping)) {}
+
+private:
+	std::shared_ptr<const MappedFile> mapping;
+};
+
+class ZipFilesystem::InflateStreamBuf : public std::streambuf {
+public:
+	/**
+	 * @param mapping mapping of the archive, when nullptr the data is read from the stream
+	 * @param stream handle on the archive, only used when there is no mapping
+	 * @param offset offset of the compressed data in the archive
+	 * @param compressed_size size of the compressed data
+	 * @param uncompressed_size size of the inflated data
+	 * @param name entry name used for error reporting
+	 */
+	InflateStreamBuf(std::shared_ptr<const MappedFile> mapping, Filesystem_Stream::InputStream stream,
+		uint64_t offset, uint64_t compressed_size, uint64_t uncompressed_size, std::string name);
+	InflateStreamBuf(InflateStreamBuf const& other) = delete;
+	InflateStreamBuf const& operator=(InflateStreamBuf const& other) = delete;
+	~InflateStreamBuf() override;
+
+protected:
+	int_type underflow() override;
+	std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+	std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
+
+private:
+	struct Checkpoint {
+		/** Copy of the decoder, zlib does not allow moving it in memory */
+		std::unique_ptr<z_stream> zlib_stream;
+		uint64_t in_pos;
+		uint64_t out_pos;
+	};
+
+	void FillInput();
+	size_t Inflate(char* out, size_t size);
+	bool MoveTo(uint64_t pos);
+	void AddCheckpoint();
+
+	std::shared_ptr<const MappedFile> mapping;
+	Filesystem_Stream::InputStream stream;
+	uint64_t offset;
+	uint64_t compressed_size;
+	uint64_t uncompressed_size;
+	std::string name;
+
+	z_stream zlib_stream = {};
+	bool failed = false;
+	bool stream_seek = true;
+	/** Compressed bytes passed to zlib */
+	uint64_t in_pos = 0;
+	/** Uncompressed bytes returned by zlib */
+	uint64_t out_pos = 0;
+	/** Uncompressed position of the start of the get area */
+	uint64_t buffer_pos = 0;
+	std::vector<char> in_buffer;
+	std::vector<char> buffer;
+	std::vector<Checkpoint> checkpoints;
+};
+
+ZipFilesystem::InflateStreamBuf::InflateStreamBuf(std::shared_ptr<const MappedFile> mapping, Filesystem_Stream::InputStream stream,
+		uint64_t offset, uint64_t compressed_size, uint64_t uncompressed_size, std::string name) :
+		mapping(std::move(mapping)), stream(std::move(stream)), offset(offset), compressed_size(compressed_size),
+		uncompressed_size(uncompressed_size), name(std::move(name)), buffer(inflate_buffer_size) {
+	if (!this->mapping) {
+		in_buffer.resize(inflate_buffer_size);
+	}
+
+	if (inflateInit2(&zlib_stream, -MAX_WBITS) != Z_OK) {
+		Output::Warning("ZipFS: zlib init failed for {}", this->name);
+		failed = true;
+	}
+
+	setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+ZipFilesystem::InflateStreamBuf::~InflateStreamBuf() {
+	inflateEnd(&zlib_stream);
+	for (auto& checkpoint : checkpoints) {
+		inflateEnd(checkpoint.zlib_stream.get());
+	}
+}
+
+ZipFilesystem::InflateStreamBuf::int_type ZipFilesystem::InflateStreamBuf::underflow() {
+	assert(gptr() == egptr());
+
+	// Seeking only moves the get area, the decoder follows when data is requested
+	const uint64_t pos = buffer_pos + (gptr() - eback());
+	if (failed || pos >= uncompressed_size) {
+		return traits_type::eof();
+	}
+
+	if (pos != out_pos && !MoveTo(pos)) {
+		return traits_type::eof();
+	}
+
+	auto size = Inflate(buffer.data(), buffer.size());
+	AddCheckpoint();
+	if (size == 0) {
+		return traits_type::eof();
+	}
+
+	buffer_pos = pos;
+	setg(buffer.data(), buffer.data(), buffer.data() + size);
+
+	return traits_type::to_int_type(*gptr());
+}
+
+std::streambuf::pos_type ZipFilesystem::InflateStreamBuf::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	std::streambuf::off_type off;
+	if (dir == std::ios_base::beg) {
+		off = offset;
+	} else if (dir == std::ios_base::cur) {
+		off = static_cast<std::streambuf::off_type>(buffer_pos + (gptr() - eback())) + offset;
+	} else {
+		off = static_cast<std::streambuf::off_type>(uncompressed_size) + offset;
+	}
+	return seekpos(off, mode);
+}
+
+std::streambuf::pos_type ZipFilesystem::InflateStreamBuf::seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) {
+	const auto target = static_cast<uint64_t>(Utils::Clamp<std::streambuf::off_type>(pos, 0, uncompressed_size));
+
+	if (target >= buffer_pos && target <= buffer_pos + (egptr() - eback())) {
+		setg(eback(), eback() + (target - buffer_pos), egptr());
+	} else {
+		buffer_pos = target;
+		setg(buffer.data(), buffer.data(), buffer.data());
+	}
+
+	return static_cast<std::streambuf::off_type>(target);
+}
+
+void ZipFilesystem::InflateStreamBuf::FillInput() {
+	const uint64_t remaining = compressed_size - in_pos;
+	if (remaining == 0) {
+		return;
+	}
+
+	if (mapping) {
+		// zlib reads directly from the mapping
+		auto size = static_cast<uInt>(std::min<uint64_t>(remaining, std::numeric_limits<uInt>::max()));
+		zlib_stream.next_in = const_cast<Bytef*>(mapping->data + offset + in_pos);
+		zlib_stream.avail_in = size;
+		in_pos += size;
+		return;
+	}
+
+	if (stream_seek) {
+		stream.clear();
+		stream.seekg(offset + in_pos);
+		stream_seek = false;
+	}
+
+	stream.read(in_buffer.data(), static_cast<std::streamsize>(std::min<uint64_t>(remaining, in_buffer.size())));
+	auto size = static_cast<uInt>(stream.gcount());
+	zlib_stream.next_in = reinterpret_cast<Bytef*>(in_buffer.data());
+	zlib_stream.avail_in = size;
+	in_pos += size;
+}
+
+size_t ZipFilesystem::InflateStreamBuf::Inflate(char* out, size_t size) {
+	size = static_cast<size_t>(std::min<uint64_t>(size, uncompressed_size - out_pos));
+	zlib_stream.next_out = reinterpret_cast<Bytef*>(out);
+	zlib_stream.avail_out = static_cast<uInt>(size);
+
+	while (zlib_stream.avail_out > 0) {
+		if (zlib_stream.avail_in == 0) {
+			FillInput();
+		}
+
+		int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
+		if (zlib_error == Z_STREAM_END) {
+			break;
+		} else if (zlib_error == Z_BUF_ERROR) {
+			Output::Warning("ZipFS: zlib failed for {}: Unexpected end of data (Archive corrupted?)", name);
+			failed = true;
+			break;
+		} else if (zlib_error != Z_OK) {
+			Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+			failed = true;
+			break;
+		}
+	}
+
+	const size_t produced = size - zlib_stream.avail_out;
+	out_pos += produced;
+	return produced;
+}
+
+bool ZipFilesystem::InflateStreamBuf::MoveTo(uint64_t pos) {
+	// Resume from the closest checkpoint in front of the position when seeking backwards
+	// or when the checkpoint is ahead of the decoder
+	auto it = std::find_if(checkpoints.rbegin(), checkpoints.rend(), [&](const auto& checkpoint) {
+		return checkpoint.out_pos <= pos;
+	});
+
+	if (it != checkpoints.rend() && (pos < out_pos || it->out_pos > out_pos)) {
+		inflateEnd(&zlib_stream);
+		if (inflateCopy(&zlib_stream, it->zlib_stream.get()) != Z_OK) {
+			Output::Warning("ZipFS: zlib failed for {}: Seek failed", name);
+			failed = true;
+			return false;
+		}
+		in_pos = it->in_pos;
+		out_pos = it->out_pos;
+		zlib_stream.next_in = nullptr;
+		zlib_stream.avail_in = 0;
+		stream_seek = true;
+	} else if (pos < out_pos) {
+		inflateReset(&zlib_stream);
+		in_pos = 0;
+		out_pos = 0;
+		zlib_stream.next_in = nullptr;
+		zlib_stream.avail_in = 0;
+		stream_seek = true;
+	}
+
+	// Inflate and discard the data in front of the position
+	while (out_pos < pos) {
+		auto size = Inflate(buffer.data(), static_cast<size_t>(std::min<uint64_t>(buffer.size(), pos - out_pos)));
+		AddCheckpoint();
+		if (size == 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void ZipFilesystem::InflateStreamBuf::AddCheckpoint() {
+	if (failed || out_pos >= uncompressed_size || out_pos < (checkpoints.size() + 1) * inflate_checkpoint_interval) {
+		return;
+	}
+
+	auto zlib_copy = std::make_unique<z_stream>();
+	if (inflateCopy(zlib_copy.get(), &zlib_stream) != Z_OK) {
+		return;
+	}
+
+	checkpoints.push_back({ std::move(zlib_copy), in_pos - zlib_stream.avail_in, out_pos });
+}
+
 static std::string normalize_path(std::string_view path) {
 	if (path == "." || path == "/" || path.empty()) {
 		return "";
@@ -65,9 +397,19 @@ ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, st
 		return;
 	}
 
-	uint16_t central_directory_entries = 0;
-	uint32_t central_directory_size = 0;
-	uint32_t central_directory_offset = 0;
+	if (parent_fs.IsFeatureSupported(Feature::NativePath)) {
+		// Read the archive through a memory mapping: Parsing the headers needs no system calls
+		// and stored entries are returned as views into the mapping
+		zip_mapping = MappedFile::Open(parent_fs.MakePath(GetPath()));
+		if (zip_mapping) {
+			zip_is.Close();
+			zip_is = Filesystem_Stream::InputStream(new MappedStreamBuf(zip_mapping, 0, zip_mapping->size), GetPath());
+		}
+	}
+
+	uint64_t central_directory_entries = 0;
+	uint64_t central_directory_size = 0;
+	uint64_t central_directory_offset = 0;
 
 	ZipEntry entry = {};
 	entry.is_directory = false;
@@ -211,19 +553,35 @@ ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, st
 		return a.first == b.first;
 	});
 	zip_entries_cp437.erase(zip_entries_cp437.begin(), entries_del_it.base());
+
+	// Entries in the detected encoding take precedence over CP437 entries with the same name
+	zip_index.reserve(zip_entries.size() + zip_entries_cp437.size());
+	for (const auto& it : zip_entries) {
+		zip_index.emplace(it.first, &it.second);
+	}
+	for (const auto& it : zip_entries_cp437) {
+		zip_index.emplace(it.first, &it.second);
+	}
 }
 
-bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint32_t& offset, uint32_t& size, uint16_t& num_entries) const {
+bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint64_t& offset, uint64_t& size, uint64_t& num_entries) const {
 	uint32_t magic = 0;
 	bool found = false;
 
-	// seek to the first position where the end_of_central_directory Signature may occur
-	zipfile.seekg(-end_of_central_directory_size - UINT16_MAX, std::ios_base::end);
 	zipfile.clear();
+	zipfile.seekg(0, std::ios_base::end);
+	const int64_t file_size = zipfile.tellg();
+	if (file_size < 0) {
+		return false;
+	}
 
+	// seek to the first position where the end_of_central_directory Signature may occur
 	// The only variable length field in the end of central directory is the comment which
 	// has a maximum length of UINT16_MAX - so if we seek longer, this is no zip file
-	std::vector<char> items(UINT16_MAX);
+	const int64_t search_offset = std::max<int64_t>(0, file_size - end_of_central_directory_size - UINT16_MAX);
+	zipfile.seekg(search_offset);
+
+	std::vector<char> items(file_size - search_offset);
 	zipfile.read(items.data(), items.size());
 	zipfile.clear();
 
@@ -241,25 +599,66 @@ bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint32_t& offset
 		}
 	}
 
-	if (found) {
-		zipfile.seekg(-(static_cast<int>(items.size()) - i - 4), std::ios_base::cur); // Move right after the magic
-		zipfile.seekg(6, std::ios_base::cur); // Jump over multiarchive related fields
-		zipfile.read(reinterpret_cast<char*>(&num_entries), sizeof(uint16_t));
-		Utils::SwapByteOrder(num_entries);
-		zipfile.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
-		Utils::SwapByteOrder(size);
-		zipfile.read(reinterpret_cast<char*>(&offset), sizeof(uint32_t));
-		Utils::SwapByteOrder(offset);
+	if (!found) {
+		return false;
+	}
+
+	const int64_t end_of_central_directory_offset = search_offset + i;
+	uint16_t num_entries16;
+	uint32_t size32;
+	uint32_t offset32;
+	zipfile.seekg(end_of_central_directory_offset + 4 + 6); // Jump over magic and multiarchive related fields
+	zipfile.read(reinterpret_cast<char*>(&num_entries16), sizeof(uint16_t));
+	Utils::SwapByteOrder(num_entries16);
+	zipfile.read(reinterpret_cast<char*>(&size32), sizeof(uint32_t));
+	Utils::SwapByteOrder(size32);
+	zipfile.read(reinterpret_cast<char*>(&offset32), sizeof(uint32_t));
+	Utils::SwapByteOrder(offset32);
+	num_entries = num_entries16;
+	size = size32;
+	offset = offset32;
+
+	// Zip64: The locator of the Zip64 end of central directory is directly in front of the end of central directory
+	if (end_of_central_directory_offset < end_of_central_directory64_locator_size) {
+		return true;
+	}
+
+	zipfile.seekg(end_of_central_directory_offset - end_of_central_directory64_locator_size);
+	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	Utils::SwapByteOrder(magic);
+	if (magic != end_of_central_directory64_locator) {
 		return true;
 	}
-	else {
+
+	uint64_t end_of_central_directory64_offset;
+	zipfile.seekg(4, std::ios_base::cur); // Jump over multiarchive related fields
+	zipfile.read(reinterpret_cast<char*>(&end_of_central_directory64_offset), sizeof(uint64_t));
+	Utils::SwapByteOrder(end_of_central_directory64_offset);
+
+	zipfile.seekg(end_of_central_directory64_offset);
+	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	Utils::SwapByteOrder(magic);
+	if (magic != end_of_central_directory64) {
+		Output::Debug("ZipFS: Zip64 end of central directory not found");
 		return false;
 	}
+
+	zipfile.seekg(28, std::ios_base::cur); // Jump over record size, versions and multiarchive related fields
+	zipfile.read(reinterpret_cast<char*>(&num_entries), sizeof(uint64_t));
+	Utils::SwapByteOrder(num_entries);
+	zipfile.read(reinterpret_cast<char*>(&size), sizeof(uint64_t));
+	Utils::SwapByteOrder(size);
+	zipfile.read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
+	Utils::SwapByteOrder(offset);
+	return zipfile.good();
 }
 
 bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string& filename, ZipEntry& entry, bool& is_utf8) const {
 	uint32_t magic = 0;
 	uint16_t flags;
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
+	uint32_t fileoffset;
 	uint16_t filepath_length;
 	uint16_t extra_field_length;
 	uint16_t comment_length;
@@ -272,10 +671,10 @@ bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string
 	Utils::SwapByteOrder(flags);
 	is_utf8 = (flags & 0x800) == 0x800;
 	zipfile.seekg(10, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.compressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.compressed_size);
-	zipfile.read(reinterpret_cast<char*>(&entry.uncompressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.uncompressed_size);
+	zipfile.read(reinterpret_cast<char*>(&compressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(compressed_size);
+	zipfile.read(reinterpret_cast<char*>(&uncompressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(uncompressed_size);
 	zipfile.read(reinterpret_cast<char*>(&filepath_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(filepath_length);
 	zipfile.read(reinterpret_cast<char*>(&extra_field_length), sizeof(uint16_t));
@@ -283,15 +682,23 @@ bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string
 	zipfile.read(reinterpret_cast<char*>(&comment_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(comment_length);
 	zipfile.seekg(8, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.fileoffset), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.fileoffset);
+	zipfile.read(reinterpret_cast<char*>(&fileoffset), sizeof(uint32_t));
+	Utils::SwapByteOrder(fileoffset);
 	if (filename_buffer.capacity() < filepath_length + 1u) {
 		filename_buffer.resize(filepath_length + 1u);
 	}
 	zipfile.read(reinterpret_cast<char*>(filename_buffer.data()), filepath_length);
 	filename = std::string(filename_buffer.data(), filepath_length);
+
+	entry.compressed_size = compressed_size;
+	entry.uncompressed_size = uncompressed_size;
+	entry.fileoffset = fileoffset;
+	if (!ReadExtraField(zipfile, extra_field_length, entry, true)) {
+		return false;
+	}
+
 	// Jump over currently not needed entries
-	zipfile.seekg(comment_length + extra_field_length, std::ios_base::cur);
+	zipfile.seekg(comment_length, std::ios_base::cur);
 	return true;
 }
 
@@ -301,6 +708,8 @@ bool ZipFilesystem::ReadLocalHeader(std::istream& zipfile, StorageMethod& method
 	uint16_t extra_field_length;
 	uint16_t flags;
 	uint16_t compression;
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
 
 	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
 	Utils::SwapByteOrder(magic); // Take care of big endian systems
@@ -311,10 +720,10 @@ bool ZipFilesystem::ReadLocalHeader(std::istream& zipfile, StorageMethod& method
 	zipfile.read(reinterpret_cast<char*>(&compression), sizeof(uint16_t));
 	Utils::SwapByteOrder(compression);
 	zipfile.seekg(8, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.compressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.compressed_size);
-	zipfile.read(reinterpret_cast<char*>(&entry.uncompressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.uncompressed_size);
+	zipfile.read(reinterpret_cast<char*>(&compressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(compressed_size);
+	zipfile.read(reinterpret_cast<char*>(&uncompressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(uncompressed_size);
 	zipfile.read(reinterpret_cast<char*>(&filepath_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(filepath_length);
 	zipfile.read(reinterpret_cast<char*>(&extra_field_length), sizeof(uint16_t));
@@ -331,10 +740,73 @@ bool ZipFilesystem::ReadLocalHeader(std::istream& zipfile, StorageMethod& method
 		method = StorageMethod::Unknown;
 		break;
 	}
+
+	entry.compressed_size = compressed_size;
+	entry.uncompressed_size = uncompressed_size;
+	zipfile.seekg(filepath_length, std::ios_base::cur);
+	if (!ReadExtraField(zipfile, extra_field_length, entry, false)) {
+		return false;
+	}
+
 	entry.fileoffset = local_header_size + filepath_length + extra_field_length;
 	return true;
 }
 
+bool ZipFilesystem::ReadExtraField(std::istream& zipfile, uint16_t length, ZipEntry& entry, bool central) const {
+	if (entry.compressed_size != zip64_marker && entry.uncompressed_size != zip64_marker &&
+			(!central || entry.fileoffset != zip64_marker)) {
+		// No Zip64 values: Jump over the field
+		zipfile.seekg(length, std::ios_base::cur);
+		return true;
+	}
+
+	if (filename_buffer.size() < length) {
+		filename_buffer.resize(length);
+	}
+	zipfile.read(filename_buffer.data(), length);
+	if (zipfile.gcount() != length) {
+		return false;
+	}
+
+	size_t pos = 0;
+	while (pos + 4 <= length) {
+		const auto id = read_le<uint16_t>(filename_buffer.data() + pos);
+		const auto size = read_le<uint16_t>(filename_buffer.data() + pos + 2);
+		pos += 4;
+
+		if (pos + size > length) {
+			break;
+		}
+
+		if (id == zip64_extra_field) {
+			// Only the values that do not fit in the header are stored, in this order
+			const size_t end = pos + size;
+			auto read_value = [&](uint64_t& value) {
+				if (value != zip64_marker) {
+					return true;
+				}
+				if (pos + sizeof(uint64_t) > end) {
+					return false;
+				}
+				value = read_le<uint64_t>(filename_buffer.data() + pos);
+				pos += sizeof(uint64_t);
+				return true;
+			};
+
+			if (read_value(entry.uncompressed_size) && read_value(entry.compressed_size) &&
+					(!central || read_value(entry.fileoffset))) {
+				return true;
+			}
+			break;
+		}
+
+		pos += size;
+	}
+
+	Output::Debug("ZipFS: Invalid Zip64 extra field");
+	return false;
+}
+
 bool ZipFilesystem::IsFile(std::string_view path) const {
 	std::string path_normalized = normalize_path(path);
 	auto entry = Find(path);
@@ -395,24 +867,52 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(std::string_view path, st
 				}
 			}
 
-			if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
-				Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
-				return nullptr;
+			const uint64_t data_offset = central_entry->fileoffset + local_entry.fileoffset;
+			if (zip_mapping) {
+				const uint64_t data_size = method == StorageMethod::Plain ? local_entry.uncompressed_size : local_entry.compressed_size;
+				if (data_offset > zip_mapping->size || data_size > zip_mapping->size - data_offset) {
+					Output::Warning("ZipFS: {} exceeds the archive size (Archive corrupted?)", path_normalized);
+					return nullptr;
+				}
 			}
 
-			zip_is.seekg(central_entry->fileoffset + local_entry.fileoffset);
 			if (method == StorageMethod::Plain) {
+				if (zip_mapping) {
+					return new MappedStreamBuf(zip_mapping, data_offset, local_entry.uncompressed_size);
+				}
+				zip_is.seekg(data_offset);
 				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
 				zip_is.read(reinterpret_cast<char*>(data.data()), data.size());
 				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
 			} else if (method == StorageMethod::Deflate) {
+				if (local_entry.uncompressed_size > inflate_stream_threshold) {
+					// Large entries (music, movies) are inflated while reading
+					Filesystem_Stream::InputStream is;
+					if (!zip_mapping) {
+						// The stream is owned by the streambuf, zip_is cannot be shared
+						is = GetParent().OpenInputStream(GetPath());
+						if (!is) {
+							return nullptr;
+						}
+					}
+					return new InflateStreamBuf(zip_mapping, std::move(is), data_offset,
+						local_entry.compressed_size, local_entry.uncompressed_size, path_normalized);
+				}
+
 				std::vector<uint8_t> comp_buf;
-				comp_buf.resize(local_entry.compressed_size);
-				zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+				const uint8_t* comp_data;
+				if (zip_mapping) {
+					comp_data = zip_mapping->data + data_offset;
+				} else {
+					zip_is.seekg(data_offset);
+					comp_buf.resize(local_entry.compressed_size);
+					zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+					comp_data = comp_buf.data();
+				}
 				auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
 				z_stream zlib_stream = {};
-				zlib_stream.next_in = reinterpret_cast<Bytef*>(comp_buf.data());
-				zlib_stream.avail_in = static_cast<uInt>(comp_buf.size());
+				zlib_stream.next_in = const_cast<Bytef*>(comp_data);
+				zlib_stream.avail_in = static_cast<uInt>(local_entry.compressed_size);
 				zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
 				zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
 				inflateInit2(&zlib_stream, -MAX_WBITS);
@@ -476,20 +976,10 @@ bool ZipFilesystem::GetDirectoryContent(std::string_view path, std::vector<Direc
 }
 
 const ZipFilesystem::ZipEntry* ZipFilesystem::Find(std::string_view what) const {
-	auto it = std::lower_bound(zip_entries.begin(), zip_entries.end(), what, [](const auto& e, const auto& w) {
-		return e.first < w;
-	});
-	if (it != zip_entries.end() && it->first == what) {
-		return &it->second;
+	auto it = zip_index.find(what);
+	if (it != zip_index.end()) {
+		return it->second;
 	}
-
-	it = std::lower_bound(zip_entries_cp437.begin(), zip_entries_cp437.end(), what, [](const auto& e, const auto& w) {
-		return e.first < w;
-	});
-	if (it != zip_entries_cp437.end() && it->first == what) {
-		return &it->second;
-	}
-
 	return nullptr;
 }
 
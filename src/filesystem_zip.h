@@ -56,20 +56,31 @@ protected:
 private:
 	enum class StorageMethod {Unknown, Plain, Deflate};
 	struct ZipEntry {
-		uint32_t compressed_size;
-		uint32_t uncompressed_size;
-		uint32_t fileoffset;
+		uint64_t compressed_size;
+		uint64_t uncompressed_size;
+		uint64_t fileoffset;
 		bool is_directory;
 	};
 
-	bool FindCentralDirectory(std::istream& stream, uint32_t& offset, uint32_t& size, uint16_t& num_entries) const;
+	/** Read-only memory mapping of the archive, shared with the streams created from it */
+	class MappedFile;
+	/** Zero-copy stream over a stored entry of a memory mapped archive */
+	class MappedStreamBuf;
+	/** Inflates a deflated entry on demand instead of decompressing it at once */
+	class InflateStreamBuf;
+
+	bool FindCentralDirectory(std::istream& stream, uint64_t& offset, uint64_t& size, uint64_t& num_entries) const;
 	bool ReadCentralDirectoryEntry(std::istream& zipfile, std::string& filepath, ZipEntry& entry, bool& is_utf8) const;
 	bool ReadLocalHeader(std::istream& zipfile, StorageMethod& method, ZipEntry& entry) const;
+	bool ReadExtraField(std::istream& zipfile, uint16_t length, ZipEntry& entry, bool central) const;
 	const ZipEntry* Find(std::string_view what) const;
 
 	std::vector<std::pair<std::string, ZipEntry>> zip_entries;
 	std::vector<std::pair<std::string, ZipEntry>> zip_entries_cp437;
+	/** Hashed lookup of both entry lists, the keys point into the lists */
+	std::unordered_map<std::string_view, const ZipEntry*> zip_index;
 	std::string encoding;
+	std::shared_ptr<const MappedFile> zip_mapping;
 	mutable Filesystem_Stream::InputStream zip_is;
 	mutable std::vector<char> filename_buffer;
 };
@@ -133,6 +133,48 @@ namespace {
 		return ttyp0 != NULL ? ttyp0 : find_gothic_glyph(code);
 	}
 
+	/**
+	 * Cache of the rendered glyphs of one font.
+	 *
+	 * Masks are copied once into shared 8 bit alpha pages (shelf packed)
+	 * and returned as bitmaps referencing the page memory, so rendering a
+	 * cached glyph is only a blit. Color glyphs get their own copy.
+	 * When all pages are full the atlas is dropped, therefore a returned
+	 * glyph is only valid until the next Insert.
+	 */
+	class GlyphAtlas {
+	public:
+		/**
+		 * @param key glyph and style identifier
+		 * @return cached glyph or nullptr
+		 */
+		const Font::GlyphRet* Find(uint64_t key) const;
+
+		/**
+		 * Stores a rendered glyph.
+		 *
+		 * @param key glyph and style identifier
+		 * @param gret rendered glyph, the bitmap is copied
+		 * @return cached glyph
+		 */
+		const Font::GlyphRet& Insert(uint64_t key, const Font::GlyphRet& gret);
+
+	private:
+		enum { PAGE_SIZE = 256, MAX_PAGES = 8 };
+
+		struct Page {
+			std::vector<uint8_t> pixels = std::vector<uint8_t>(PAGE_SIZE * PAGE_SIZE);
+			int x = 0;
+			int y = 0;
+			int row_height = 0;
+		};
+
+		BitmapRef Allocate(int width, int height);
+
+		std::unordered_map<uint64_t, Font::GlyphRet> glyphs;
+		std::vector<std::unique_ptr<Page>> pages;
+	};
+
 	struct BitmapFont final : public Font {
 		enum { HEIGHT = 12, FULL_WIDTH = HEIGHT, HALF_WIDTH = FULL_WIDTH / 2 };
 
@@ -146,6 +188,7 @@ namespace {
 	private:
 		function_type func;
 		mutable BitmapRef glyph_bm;
+		mutable GlyphAtlas atlas;
 	}; // class BitmapFont
 
 #ifdef HAVE_FREETYPE
@@ -175,6 +218,8 @@ namespace {
 		int baseline_offset = 0;
 		/** Workaround for bad kerning in RM2000 and RMG2000 fonts */
 		bool rm2000_workaround = false;
+		/** Rendered glyphs keyed by size and glyph index */
+		mutable GlyphAtlas atlas;
 
 #ifdef HAVE_HARFBUZZ
 		hb_buffer_t* hb_buffer = nullptr;
@@ -258,6 +303,52 @@ namespace {
 	}
 } // anonymous namespace
 
+const Font::GlyphRet* GlyphAtlas::Find(uint64_t key) const {
+	auto it = glyphs.find(key);
+	return it != glyphs.end() ? &it->second : nullptr;
+}
+
+const Font::GlyphRet& GlyphAtlas::Insert(uint64_t key, const Font::GlyphRet& gret) {
+	Font::GlyphRet cached = gret;
+	if (gret.bitmap) {
+		const int width = gret.bitmap->width();
+		const int height = gret.bitmap->height();
+		if (gret.has_color || width > PAGE_SIZE || height > PAGE_SIZE) {
+			cached.bitmap = Bitmap::Create(*gret.bitmap, gret.bitmap->GetRect());
+		} else {
+			cached.bitmap = Allocate(width, height);
+			cached.bitmap->Blit(0, 0, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+		}
+	}
+	return glyphs[key] = std::move(cached);
+}
+
+BitmapRef GlyphAtlas::Allocate(int width, int height) {
+	// Keep every glyph 4 byte aligned for pixman
+	const int slot_width = (width + 3) & ~3;
+
+	Page* page = pages.empty() ? nullptr : pages.back().get();
+	if (page && page->x + slot_width > PAGE_SIZE) {
+		page->x = 0;
+		page->y += page->row_height;
+		page->row_height = 0;
+	}
+	if (!page || page->y + height > PAGE_SIZE) {
+		if (static_cast<int>(pages.size()) >= MAX_PAGES) {
+			glyphs.clear();
+			pages.clear();
+		}
+		pages.push_back(std::make_unique<Page>());
+		page = pages.back().get();
+	}
+
+	auto* pixels = &page->pixels[page->y * PAGE_SIZE + page->x];
+	page->x += slot_width;
+	page->row_height = std::max(page->row_height, height);
+
+	return Bitmap::Create(pixels, width, height, PAGE_SIZE, DynamicFormat(8, 8, 0, 8, 0, 8, 0, 8, 0, PF::Alpha));
+}
+
 BitmapFont::BitmapFont(std::string_view name, function_type func)
 	: Font(name, HEIGHT, false, false), func(func)
 {}
@@ -269,7 +360,9 @@ Rect BitmapFont::vGetSize(char32_t glyph) const {
 }
 
 Font::GlyphRet BitmapFont::vRender(char32_t glyph) const {
-	std::vector<Font::GlyphRet> glyphs;
+	if (auto* cached = atlas.Find(glyph)) {
+		return *cached;
+	}
 
 	if (EP_UNLIKELY(!glyph_bm)) {
 		glyph_bm = Bitmap::Create(nullptr, FULL_WIDTH, HEIGHT, 0, DynamicFormat(8, 8, 0, 8, 0, 8, 0, 8, 0, PF::Alpha));
@@ -284,7 +377,7 @@ Font::GlyphRet BitmapFont::vRender(char32_t glyph) const {
 		for (size_t x_ = 0; x_ < width; ++x_)
 			data[y_ * pitch + x_] = (bm_glyph->data[y_] & (0x1 << x_)) ? 255 : 0;
 
-	return { glyph_bm, {width, 0}, {0, 0} };
+	return atlas.Insert(glyph, { glyph_bm, {width, 0}, {0, 0} });
 }
 
 #ifdef HAVE_FREETYPE
@@ -450,6 +543,11 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 		}
 	}
 
+	const uint64_t key = (static_cast<uint64_t>(current_style.size) << 32) | glyph;
+	if (auto* cached = atlas.Find(key)) {
+		return *cached;
+	}
+
 	auto render_glyph = [&](auto flags, auto mode) {
 		if (FT_Load_Glyph(face, glyph, flags) != FT_Err_Ok) {
 			Output::Debug("Couldn't load FreeType character {:#x}", uint32_t(glyph));
@@ -526,7 +624,7 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 		advance.x = 6;
 	}
 
-	return { bm, advance, offset, has_color };
+	return atlas.Insert(key, { bm, advance, offset, has_color });
 }
 
 bool FTFont::vCanShape() const {
@@ -888,8 +986,8 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *sys_large, src_x, src_y);
 			} else {
 				auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-				auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+				const auto& col_bm = GetColorBitmap(gret.bitmap->width(), gret.bitmap->height(), col);
+				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, col_bm, 0, 0);
 			}
 		} else {
 			// Color glyphs, emojis etc.
@@ -927,8 +1025,8 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
 		} else {
 			auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-			auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+			const auto& col_bm = GetColorBitmap(gret.bitmap->width(), gret.bitmap->height(), col);
+			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, col_bm, 0, 0);
 		}
 	} else {
 		// Color glyphs, emojis etc.
@@ -938,6 +1036,19 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 	return true;
 }
 
+const Bitmap& Font::GetColorBitmap(int width, int height, const Color& color) const {
+	if (!color_bm || color_bm->width() < width || color_bm->height() < height) {
+		const int w = color_bm ? std::max(color_bm->width(), width) : width;
+		const int h = color_bm ? std::max(color_bm->height(), height) : height;
+		color_bm = Bitmap::Create(w, h, color);
+		color_bm_color = color;
+	} else if (!(color_bm_color == color)) {
+		color_bm->Fill(color);
+		color_bm_color = color;
+	}
+	return *color_bm;
+}
+
 Point Font::Render(Bitmap& dest, int x, int y, Color const& color, char32_t glyph) const {
 	if (EP_UNLIKELY(Utils::IsControlCharacter(glyph))) {
 		return {};
@@ -19,6 +19,7 @@
 #define EP_FONT_H
 
 // Headers
+#include "color.h"
 #include "filesystem_stream.h"
 #include "point.h"
 #include "system.h"
@@ -268,6 +269,20 @@ class Font {
 
 private:
 	bool RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, const GlyphRet& gret) const;
+
+	/**
+	 * Returns a bitmap filled with a solid color that is at least as large
+	 * as the glyph. The bitmap is reused while the color does not change.
+	 *
+	 * @param width minimum width
+	 * @param height minimum height
+	 * @param color fill color
+	 * @return solid color bitmap
+	 */
+	const Bitmap& GetColorBitmap(int width, int height, const Color& color) const;
+
+	mutable BitmapRef color_bm;
+	mutable Color color_bm_color;
 };
 
 #endif
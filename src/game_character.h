@@ -31,6 +31,13 @@
 #include "utils.h"
 #include "multiplayer/game_multiplayer.h"
 
+class Game_Character;
+
+namespace Game_Map {
+	// Declared here because game_map.h includes this header
+	void OnEventPositionChanged(const Game_Character& ev);
+}
+
 /**
  * Game_Character class.
  */
@@ -1002,6 +1009,9 @@ inline int Game_Character::GetX() const {
 
 inline void Game_Character::SetX(int new_x) {
 	data()->position_x = new_x;
+	if (_type == Event) {
+		Game_Map::OnEventPositionChanged(*this);
+	}
 }
 
 inline int Game_Character::GetY() const {
@@ -1010,6 +1020,9 @@ inline int Game_Character::GetY() const {
 
 inline void Game_Character::SetY(int new_y) {
 	data()->position_y = new_y;
+	if (_type == Event) {
+		Game_Map::OnEventPositionChanged(*this);
+	}
 }
 
 inline int Game_Character::GetMapId() const {
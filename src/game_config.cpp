@@ -624,6 +624,7 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	audio.fluidsynth_midi.FromIni(ini);
 	audio.wildmidi_midi.FromIni(ini);
 	audio.native_midi.FromIni(ini);
+	audio.midi_prerender.FromIni(ini);
 	audio.soundfont.FromIni(ini);
 
 	/** INPUT SECTION */
@@ -727,6 +728,7 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	audio.fluidsynth_midi.ToIni(os);
 	audio.wildmidi_midi.ToIni(os);
 	audio.native_midi.ToIni(os);
+	audio.midi_prerender.ToIni(os);
 	audio.soundfont.ToIni(os);
 
 	os << "\n";
@@ -153,6 +153,7 @@ struct Game_ConfigAudio {
 	BoolConfigParam wildmidi_midi { "WildMidi (GUS)", "Play MIDI using GUS patches", "Audio", "WildMidi", true };
 	BoolConfigParam native_midi { "Native MIDI", "Play MIDI through the operating system ", "Audio", "NativeMidi", true };
 	LockedConfigParam<std::string> fmmidi_midi { "FmMidi", "Play MIDI using the built-in MIDI synthesizer", "[Always ON]" };
+	BoolConfigParam midi_prerender { "Pre-render MIDI", "Render MIDI music once and replay it from memory", "Audio", "MidiPrerender", false };
 	PathConfigParam soundfont { "Soundfont", "Soundfont to use for " EP_FLUID_NAME, "Audio", "Soundfont", "" };
 
 	void Hide();
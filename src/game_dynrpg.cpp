@@ -477,39 +477,50 @@ void Game_DynRpg::Load(int slot) {
 }
 
 void Game_DynRpg::Save(int slot) {
+	WriteSaveData(slot, CreateSaveData());
+}
+
+std::string Game_DynRpg::CreateSaveData() {
 	if (!Player::IsPatchDynRpg()) {
-		return;
+		return {};
 	}
 
 	InitPlugins();
 
-	std::string filename = get_filename(slot);
+	std::string out = "DYNSAVE1";
 
-	auto out = FileFinder::Save().OpenOutputStream(filename);
+	auto write_len = [&out](uint32_t len) {
+		Utils::SwapByteOrder(len);
+		out.append(reinterpret_cast<const char*>(&len), 4);
+	};
 
-	if (!out) {
-		Output::Warning("Couldn't write DynRPG save: {}", filename);
-		return;
-	}
+	for (auto &plugin : plugins) {
+		write_len(plugin->GetIdentifier().size());
+		out.append(plugin->GetIdentifier().data(), plugin->GetIdentifier().size());
 
-	std::string header = "DYNSAVE1";
+		std::vector<uint8_t> data = plugin->Save();
+		write_len(data.size());
+		out.append(reinterpret_cast<const char*>(data.data()), data.size());
+	}
 
-	out.write(header.c_str(), 8);
+	return out;
+}
 
-	for (auto &plugin : plugins) {
-		uint32_t len = plugin->GetIdentifier().size();
-		Utils::SwapByteOrder(len);
+void Game_DynRpg::WriteSaveData(int slot, std::string_view data) {
+	if (data.empty()) {
+		return;
+	}
 
-		out.write((char*)&len, 4);
-		out.write(plugin->GetIdentifier().data(), len);
+	std::string filename = get_filename(slot);
 
-		std::vector<uint8_t> data = plugin->Save();
-		len = data.size();
-		Utils::SwapByteOrder(len);
+	auto out = FileFinder::Save().OpenOutputStream(filename);
 
-		out.write((char*)&len, 4);
-		out.write((char*)data.data(), data.size());
+	if (!out) {
+		Output::Warning("Couldn't write DynRPG save: {}", filename);
+		return;
 	}
+
+	out.write(data.data(), data.size());
 }
 
 void Game_DynRpg::Update() {
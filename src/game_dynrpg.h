@@ -134,6 +134,21 @@ public:
 	void Load(int slot);
 	void Save(int slot);
 
+	/**
+	 * Serializes the state of all plugins.
+	 *
+	 * @return content of a DynRPG save, empty when DynRPG is disabled
+	 */
+	std::string CreateSaveData();
+
+	/**
+	 * Writes plugin state created by CreateSaveData to the DynRPG save of a slot.
+	 *
+	 * @param slot save slot
+	 * @param data content of the DynRPG save, nothing is written when empty
+	 */
+	void WriteSaveData(int slot, std::string_view data);
+
 private:
 	friend DynRpg::EasyRpgPlugin;
 
@@ -45,9 +45,11 @@
 #include "game_runtime_patches.h"
 #include "game_screen.h"
 #include "game_interpreter_control_variables.h"
+#include "game_interpreter_profiler.h"
 #include "game_windows.h"
 #include "json_helper.h"
 #include "maniac_patch.h"
+#include "save_writer.h"
 #include "spriteset_map.h"
 #include "sprite_character.h"
 #include "scene_gameover.h"
@@ -77,6 +79,8 @@ enum BranchSubcommand {
 	eOptionBranchElse = 1
 };
 
+Game_Interpreter::UpdateStats Game_Interpreter::update_stats;
+
 Game_Interpreter::Game_Interpreter(bool _main_flag) {
 	main_flag = _main_flag;
 
@@ -91,6 +95,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	jump_tables.clear();
 }
 
 // Is interpreter running.
@@ -141,6 +146,11 @@ void Game_Interpreter::PushInternal(
 		Main_Data::game_player->SetEncounterCalling(false);
 	}
 
+	// The slot may still hold the table of a popped frame
+	if (_state.stack.size() < jump_tables.size()) {
+		jump_tables[_state.stack.size()] = {};
+	}
+
 	_state.stack.push_back(std::move(frame));
 }
 
@@ -401,6 +411,17 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 	});
 #endif
 
+	if (loop_count == 0 && IsAsleep()) {
+		++update_stats.skipped;
+		if (Game_Map::GetNeedRefresh()) {
+			Game_Map::Refresh();
+		}
+		return;
+	}
+	++update_stats.executed;
+
+	Game_Interpreter_Profiler::UpdateScope profile_update;
+
 	for (; loop_count < loop_limit; ++loop_count) {
 		// If something is calling a menu, we're allowed to execute only 1 command per interpreter. So we pass through if loop_count == 0, and stop at 1 or greater.
 		// RPG_RT compatible behavior.
@@ -514,8 +535,11 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 		int current_frame_idx = _state.stack.size() - 1;
 
 		const int index_before_exec = frame->current_command;
-		if (!ExecuteCommand()) {
-			break;
+		{
+			Game_Interpreter_Profiler::CommandScope profile_command(profile_update, *frame);
+			if (!ExecuteCommand()) {
+				break;
+			}
 		}
 
 		if (Game_Battle::IsBattleRunning() && Player::IsRPG2k3() && Game_Battle::CheckWin()) {
@@ -551,6 +575,46 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 	}
 }
 
+bool Game_Interpreter::IsAsleep() {
+	// Same checks and side effects as the start of the loop in Update,
+	// limited to the wake conditions that resolve without executing a command.
+	// The foreground interpreter additionally waits for vehicles and
+	// pending messages and always takes the full path.
+	if (main_flag) {
+		return false;
+	}
+
+	if (Game_Message::IsMessageActive() && _state.show_message) {
+		return true;
+	}
+
+	_state.show_message = false;
+	_state.abort_on_escape = false;
+
+	if (_state.wait_time > 0) {
+		_state.wait_time--;
+		return true;
+	}
+
+	if (_state.wait_key_enter && (Game_Message::IsMessageActive() || !Input::IsTriggered(Input::DECISION))) {
+		return true;
+	}
+
+	if (_state.wait_movement && !_state.wait_key_enter && Game_Map::IsAnyMovePending()) {
+		return true;
+	}
+
+	return false;
+}
+
+Game_Interpreter::UpdateStats Game_Interpreter::GetUpdateStats() {
+	return update_stats;
+}
+
+void Game_Interpreter::ResetUpdateStats() {
+	update_stats = {};
+}
+
 // Setup Starting Event
 void Game_Interpreter::PushInternal(Game_Event* ev, ExecutionType ex_type) {
 	PushInternal(
@@ -590,15 +654,22 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
-		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
-			break;
-		}
+	index = GetJumpTable().FindNextConditional(index, codes, indent);
+}
+
+const Game_Interpreter_JumpTable& Game_Interpreter::GetJumpTable() {
+	const auto& frame = GetFrame();
+	const size_t frame_idx = _state.stack.size() - 1;
+
+	if (frame_idx >= jump_tables.size()) {
+		jump_tables.resize(frame_idx + 1);
 	}
+
+	auto& table = jump_tables[frame_idx];
+	if (!table.IsBuiltFor(frame.commands)) {
+		table = Game_Interpreter_JumpTable(frame.commands);
+	}
+	return table;
 }
 
 // Execute Command.
@@ -1095,10 +1166,8 @@ bool Game_Interpreter::CommandControlSwitches(lcf::rpg::EventCommand const& com)
 		} else {
 			Output::Debug("ControlSwitch: Unknown mode {}", mode);
 		}
-		for (int i = start; i <= end; ++i) {
-			GMI().SwitchSet(i, Main_Data::game_switches->GetInt(i));
-		}
-		Game_Map::SetNeedRefresh(true);
+		GMI().SwitchRangeSet(start, end);
+		Game_Map::SetNeedRefreshForSwitchRangeChange(start, end);
 	}
 	return true;
 }
@@ -1380,7 +1449,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariable(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 			RuntimePatches::OnVariableRangeChanged(start, end);
 		} else if (com.parameters[4] == 2) {
 			// Multiple variables - Indirect variable lookup
@@ -1420,7 +1489,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariableIndirect(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 			RuntimePatches::OnVariableRangeChanged(start, end);
 		} else if (com.parameters[4] == 3) {
 			// Multiple variables - random
@@ -1461,7 +1530,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeRandom(start, end, rmin, rmax);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 			RuntimePatches::OnVariableRangeChanged(start, end);
 		} else {
 			// Multiple variables - constant
@@ -1500,13 +1569,11 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRange(start, end, value);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 			RuntimePatches::OnVariableRangeChanged(start, end);
 		}
 
-		for (int i = start; i <= end; ++i) {
-			GMI().VariableSet(i, Main_Data::game_variables->Get(i));
-		}
+		GMI().VariableRangeSet(start, end);
 	}
 
 	return true;
@@ -1643,6 +1710,7 @@ bool Game_Interpreter::CommandChangeItems(lcf::rpg::EventCommand const& com) { /
 		}
 	}
 
+	// Game_Party refreshes the events depending on the item
 	if (com.parameters[1] == 0) {
 		// Item by const number
 		Main_Data::game_party->AddItem(com.parameters[2], value);
@@ -1653,7 +1721,6 @@ bool Game_Interpreter::CommandChangeItems(lcf::rpg::EventCommand const& com) { /
 			value
 		);
 	}
-	Game_Map::SetNeedRefresh(true);
 	// Continue
 	return true;
 }
@@ -1679,7 +1746,8 @@ bool Game_Interpreter::CommandChangePartyMember(lcf::rpg::EventCommand const& co
 	}
 
 	CheckGameOver();
-	Game_Map::SetNeedRefresh(true);
+	// Game_Party refreshes the events depending on the equipment of the actor
+	Game_Map::SetNeedRefreshForActorChange(id);
 
 	// Continue
 	return true;
@@ -3821,18 +3889,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 
 bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters.empty() || list[idx].parameters[0] != label_id)
-			continue;
+	int idx = GetJumpTable().FindLabel(label_id);
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	return true;
@@ -3916,13 +3979,8 @@ bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */)
 
 	// This emulates an RPG_RT bug where break loop ignores scopes and
 	// unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
-	}
+	int idx = GetJumpTable().FindNextEndLoop(index);
+	index = std::min(idx + 1, static_cast<int>(list.size()));
 
 	return true;
 }
@@ -3986,16 +4044,11 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	}
 
 	// Restart the loop
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
-		index = idx;
-		break;
+	int idx = GetJumpTable().FindLoopStart(index, indent);
+	if (idx < 0) {
+		return false;
 	}
+	index = idx;
 
 	// Jump past the Cmd::Loop to the first command.
 	if (index < (int)frame.commands.size()) {
@@ -4438,6 +4491,8 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
+	// A background save of the same slot must finish first
+	SaveWriter::Wait();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, save_number);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
@@ -4534,6 +4589,8 @@ bool Game_Interpreter::CommandManiacLoad(lcf::rpg::EventCommand const& com) {
 	// Not implemented (kinda useless feature):
 	// When com.parameters[2] is 1 the check whether the file exists is skipped
 	// When skipped and missing RPG_RT will crash
+	// A background save of the same slot must finish first
+	SaveWriter::Wait();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, slot);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
@@ -4842,11 +4899,13 @@ bool Game_Interpreter::CommandManiacControlVarArray(lcf::rpg::EventCommand const
 			// Copy, assigns left to right, the others apply right to left
 			int last_target_b = target_b + length - 1;
 			Main_Data::game_variables->SetArray(target_b, last_target_b, target_a);
-			break;
+			Game_Map::SetNeedRefreshForVarRangeChange(target_b, last_target_b);
+			return true;
 		}
 		case 1:
 			// Swap
 			Main_Data::game_variables->SwapArray(target_a, last_target_a, target_b);
+			Game_Map::SetNeedRefreshForVarRangeChange(target_b, target_b + length - 1);
 			break;
 		case 2:
 			// Sort asc
@@ -4906,9 +4965,10 @@ bool Game_Interpreter::CommandManiacControlVarArray(lcf::rpg::EventCommand const
 			break;
 		default:
 			Output::Warning("ManiacControlVarArray: Unknown operation {}", op);
+			return true;
 	}
 
-	Game_Map::SetNeedRefresh(true);
+	Game_Map::SetNeedRefreshForVarRangeChange(target_a, last_target_a);
 
 	return true;
 }
@@ -25,6 +25,7 @@
 #include "async_handler.h"
 #include "game_character.h"
 #include "game_actor.h"
+#include "game_interpreter_jumptable.h"
 #include "game_interpreter_shared.h"
 #include <lcf/dbarray.h>
 #include <lcf/rpg/fwd.h>
@@ -130,6 +131,20 @@ public:
 	/** @return true if wait command (time or key) is active. Used by 2k3 battle system */
 	bool IsWaitingForWaitCommand() const;
 
+	/** Number of Update calls that ran or skipped the command loop */
+	struct UpdateStats {
+		/** Updates that entered the command loop */
+		int64_t executed = 0;
+		/** Updates that only advanced a wait because no wake condition fired */
+		int64_t skipped = 0;
+	};
+
+	/** @return update counters of all interpreters since the last ResetUpdateStats */
+	static UpdateStats GetUpdateStats();
+
+	/** Clears the update counters. Called by Game_Map once per frame. */
+	static void ResetUpdateStats();
+
 protected:
 	static constexpr int loop_limit = 10000;
 	static constexpr int call_stack_limit = 1000;
@@ -140,10 +155,21 @@ protected:
 	const lcf::rpg::SaveEventExecFrame* GetFramePtr() const;
 	lcf::rpg::SaveEventExecFrame* GetFramePtr();
 
+	/**
+	 * Evaluates the wake conditions of a parallel interpreter: wait time,
+	 * wait for decision key and wait for movement. Advances the wait the
+	 * same way the command loop does.
+	 *
+	 * @return true when no condition fired and the command loop can be skipped
+	 */
+	bool IsAsleep();
+
 	bool main_flag;
 
 	int loop_count = 0;
 
+	static UpdateStats update_stats;
+
 	/**
 	 * Gets strings for choice selection.
 	 * This is just a helper (private) method
@@ -174,6 +200,11 @@ protected:
 	 */
 	void SkipToNextConditional(std::initializer_list<Cmd> codes, int indent);
 
+	/**
+	 * @return jump table of the commands of the current frame, built on first use
+	 */
+	const Game_Interpreter_JumpTable& GetJumpTable();
+
 	/**
 	 * Sets up a wait (and closes the message box)
 	 */
@@ -361,6 +392,9 @@ protected:
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
 
+	/** Jump tables of the stack frames, same index as _state.stack */
+	std::vector<Game_Interpreter_JumpTable> jump_tables;
+
 	private:
 		void PushInternal(
 			InterpreterPush push_info,
@@ -0,0 +1,121 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_interpreter_jumptable.h"
+#include <algorithm>
+
+Game_Interpreter_JumpTable::Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list)
+	: commands(list.data()), num_commands(static_cast<int>(list.size()))
+{
+	const int n = num_commands;
+	codes.resize(n);
+	indents.resize(n);
+	next_same_or_lower.resize(n);
+	prev_same_or_lower.resize(n);
+	next_end_loop.resize(n);
+
+	for (int i = 0; i < n; ++i) {
+		codes[i] = list[i].code;
+		indents[i] = list[i].indent;
+
+		if (static_cast<Cmd>(list[i].code) == Cmd::Label && !list[i].parameters.empty()) {
+			labels.emplace_back(list[i].parameters[0], i);
+		}
+	}
+
+	// Stable sort keeps the first label of an id in front
+	std::stable_sort(labels.begin(), labels.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	std::vector<int32_t> stack;
+	for (int i = n - 1; i >= 0; --i) {
+		while (!stack.empty() && indents[stack.back()] > indents[i]) {
+			stack.pop_back();
+		}
+		next_same_or_lower[i] = stack.empty() ? n : stack.back();
+		stack.push_back(i);
+
+		next_end_loop[i] = (i + 1 < n && static_cast<Cmd>(codes[i + 1]) == Cmd::EndLoop) ? i + 1
+			: (i + 1 < n ? next_end_loop[i + 1] : n);
+	}
+
+	stack.clear();
+	for (int i = 0; i < n; ++i) {
+		while (!stack.empty() && indents[stack.back()] > indents[i]) {
+			stack.pop_back();
+		}
+		prev_same_or_lower[i] = stack.empty() ? -1 : stack.back();
+		stack.push_back(i);
+	}
+}
+
+int Game_Interpreter_JumpTable::FindNextConditional(int index, std::initializer_list<Cmd> search_codes, int indent) const {
+	if (index < 0 || index >= num_commands) {
+		return std::max(index, num_commands);
+	}
+
+	int idx = index;
+	for (;;) {
+		// Following the chain never skips a command with an indentation of at
+		// most indent as long as the current command is not below indent.
+		// Broken event code can have lower indentation, then step one by one.
+		idx = indents[idx] >= indent ? next_same_or_lower[idx] : idx + 1;
+		if (idx >= num_commands) {
+			return num_commands;
+		}
+		if (indents[idx] > indent) {
+			continue;
+		}
+		if (std::find(search_codes.begin(), search_codes.end(), static_cast<Cmd>(codes[idx])) != search_codes.end()) {
+			return idx;
+		}
+	}
+}
+
+int Game_Interpreter_JumpTable::FindLoopStart(int index, int indent) const {
+	if (index < 0 || index >= num_commands) {
+		return index;
+	}
+
+	for (int idx = index; idx >= 0; idx = prev_same_or_lower[idx]) {
+		if (indents[idx] < indent) {
+			return -1;
+		}
+		if (indents[idx] == indent && static_cast<Cmd>(codes[idx]) == Cmd::Loop) {
+			return idx;
+		}
+	}
+	return index;
+}
+
+int Game_Interpreter_JumpTable::FindNextEndLoop(int index) const {
+	if (index < 0 || index >= num_commands) {
+		return std::max(index, num_commands);
+	}
+	return next_end_loop[index];
+}
+
+int Game_Interpreter_JumpTable::FindLabel(int label_id) const {
+	auto it = std::lower_bound(labels.begin(), labels.end(), label_id, [](const auto& label, int id) {
+		return label.first < id;
+	});
+	if (it == labels.end() || it->first != label_id) {
+		return -1;
+	}
+	return it->second;
+}
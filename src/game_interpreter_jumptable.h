@@ -0,0 +1,113 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_JUMPTABLE_H
+#define EP_GAME_INTERPRETER_JUMPTABLE_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Resolves the jump targets of the control flow commands of an event
+ * command list without scanning the list for every jump.
+ *
+ * The table is built once per list. All lookups return the same index
+ * the linear scans of the interpreter would find, so current_command
+ * of the savegame keeps its meaning.
+ */
+class Game_Interpreter_JumpTable {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	Game_Interpreter_JumpTable() = default;
+
+	/**
+	 * Builds the jump table for a command list.
+	 *
+	 * @param list command list, must not be modified while the table is used
+	 */
+	explicit Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list);
+
+	/**
+	 * @param list command list
+	 * @return whether the table was built for this list
+	 */
+	bool IsBuiltFor(const std::vector<lcf::rpg::EventCommand>& list) const;
+
+	/**
+	 * Finds the next command after index with a code in codes and
+	 * an indentation of at most indent.
+	 *
+	 * @param index start index, this command is not considered
+	 * @param codes codes to look for
+	 * @param indent maximum indentation
+	 * @return index of the command or size of the list when not found
+	 */
+	int FindNextConditional(int index, std::initializer_list<Cmd> codes, int indent) const;
+
+	/**
+	 * Searches backwards from index for the Loop command with the given
+	 * indentation.
+	 *
+	 * @param index index of the EndLoop command
+	 * @param indent indentation of the loop
+	 * @return index of the Loop, -1 when a command with a lower indentation
+	 *   is found first or index itself when there is no Loop
+	 */
+	int FindLoopStart(int index, int indent) const;
+
+	/**
+	 * Finds the first EndLoop after index regardless of the indentation.
+	 *
+	 * @param index start index, this command is not considered
+	 * @return index of the EndLoop or size of the list when not found
+	 */
+	int FindNextEndLoop(int index) const;
+
+	/**
+	 * Finds the first label with the given id.
+	 *
+	 * @param label_id id of the label
+	 * @return index of the label or -1 when not found
+	 */
+	int FindLabel(int label_id) const;
+
+private:
+	const lcf::rpg::EventCommand* commands = nullptr;
+	int num_commands = -1;
+
+	/** Code and indentation of each command, kept compact for the lookups */
+	std::vector<int32_t> codes;
+	std::vector<int32_t> indents;
+	/** Next command with an indentation not larger than this one */
+	std::vector<int32_t> next_same_or_lower;
+	/** Previous command with an indentation not larger than this one */
+	std::vector<int32_t> prev_same_or_lower;
+	/** Next EndLoop command */
+	std::vector<int32_t> next_end_loop;
+	/** Label id and index of the first label, sorted by id */
+	std::vector<std::pair<int32_t, int32_t>> labels;
+};
+
+inline bool Game_Interpreter_JumpTable::IsBuiltFor(const std::vector<lcf::rpg::EventCommand>& list) const {
+	return commands == list.data() && num_commands == static_cast<int>(list.size());
+}
+
+#endif
@@ -0,0 +1,281 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game_interpreter_profiler.h"
+#include "filefinder.h"
+#include "game_event.h"
+#include "game_map.h"
+#include "output.h"
+#include "string_view.h"
+#include <lcf/data.h>
+#include <lcf/reader_util.h>
+#include <algorithm>
+#include <ctime>
+#include <unordered_map>
+
+using EventType = Game_Interpreter_Shared::EventType;
+
+namespace {
+	std::string output_path;
+	std::unordered_map<uint64_t, Game_Interpreter_Profiler::EventStats> events;
+	std::unordered_map<int, Game_Interpreter_Profiler::CommandStats> commands;
+	Game_Interpreter::UpdateStats update_stats;
+
+	uint64_t MakeKey(EventType type, int map_id, int event_id) {
+		return (static_cast<uint64_t>(type) << 56)
+			| (static_cast<uint64_t>(static_cast<uint32_t>(map_id) & 0xFFFFFF) << 32)
+			| static_cast<uint32_t>(event_id);
+	}
+
+	std::string GetName(EventType type, int event_id) {
+		switch (type) {
+			case EventType::MapEvent:
+				if (auto* ev = Game_Map::GetEvent(event_id)) {
+					return ToString(ev->GetName());
+				}
+				break;
+			case EventType::CommonEvent:
+				if (auto* ce = lcf::ReaderUtil::GetElement(lcf::Data::commonevents, event_id)) {
+					return ToString(ce->name);
+				}
+				break;
+			default:
+				break;
+		}
+		return "";
+	}
+
+	std::string FormatEvent(const Game_Interpreter_Profiler::EventStats& ev) {
+		std::string name;
+		switch (ev.type) {
+			case EventType::MapEvent:
+				name = fmt::format("Map{:04d} EV{:04d}", ev.map_id, ev.event_id);
+				break;
+			case EventType::CommonEvent:
+				name = fmt::format("CE{:04d}", ev.event_id);
+				break;
+			case EventType::BattleEvent:
+				name = fmt::format("Battle page {}", ev.event_id);
+				break;
+			default:
+				name = fmt::format("Event {}", ev.event_id);
+				break;
+		}
+		if (!ev.name.empty()) {
+			name += fmt::format(" '{}'", ev.name);
+		}
+		return name;
+	}
+
+	std::string JsonEscape(std::string_view str) {
+		std::string out;
+		out.reserve(str.size());
+		for (char c: str) {
+			switch (c) {
+				case '"':
+					out += "\\\"";
+					break;
+				case '\\':
+					out += "\\\\";
+					break;
+				default:
+					if (static_cast<unsigned char>(c) < 0x20) {
+						out += fmt::format("\\u{:04x}", static_cast<int>(c));
+					} else {
+						out += c;
+					}
+					break;
+			}
+		}
+		return out;
+	}
+
+	double ToMs(int64_t ns) {
+		return ns / 1000000.0;
+	}
+
+	void WriteJson() {
+		auto os = FileFinder::Root().OpenOutputStream(output_path, std::ios::out | std::ios::trunc);
+		if (!os) {
+			Output::Warning("Profiler: Failed to open {} for writing", output_path);
+			return;
+		}
+
+		std::time_t t = std::time(nullptr);
+		char date[100] = "";
+		std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", std::localtime(&t));
+
+		os << "{\n";
+		os << fmt::format("\t\"date\": \"{}\",\n", date);
+		os << "\t\"events\": [";
+		bool first = true;
+		for (const auto& ev: Game_Interpreter_Profiler::GetEventStats()) {
+			os << (first ? "\n" : ",\n");
+			os << fmt::format("\t\t{{\"type\": \"{}\", \"map_id\": {}, \"event_id\": {}, \"name\": \"{}\", "
+				"\"updates\": {}, \"commands\": {}, \"max_commands_per_update\": {}, \"time_ns\": {}}}",
+				Game_Interpreter_Shared::kEventType.tag(static_cast<int>(ev.type)), ev.map_id, ev.event_id, JsonEscape(ev.name),
+				ev.updates, ev.commands, ev.max_commands_per_update, ev.time_ns);
+			first = false;
+		}
+		os << "\n\t],\n";
+		os << "\t\"commands\": [";
+		first = true;
+		for (const auto& cmd: Game_Interpreter_Profiler::GetCommandStats()) {
+			os << (first ? "\n" : ",\n");
+			os << fmt::format("\t\t{{\"code\": {}, \"count\": {}, \"time_ns\": {}}}", cmd.code, cmd.count, cmd.time_ns);
+			first = false;
+		}
+		os << "\n\t],\n";
+		os << fmt::format("\t\"interpreter_updates\": {{\"executed\": {}, \"skipped\": {}}}\n", update_stats.executed, update_stats.skipped);
+		os << "}\n";
+
+		Output::Debug("Profiler: Wrote statistics to {}", output_path);
+	}
+}
+
+bool Game_Interpreter_Profiler::detail::enabled = false;
+
+void Game_Interpreter_Profiler::Init(std::string path) {
+	output_path = std::move(path);
+	detail::enabled = true;
+	Reset();
+}
+
+void Game_Interpreter_Profiler::Reset() {
+	events.clear();
+	commands.clear();
+	update_stats = {};
+}
+
+std::vector<Game_Interpreter_Profiler::EventStats> Game_Interpreter_Profiler::GetEventStats() {
+	std::vector<EventStats> result;
+	result.reserve(events.size());
+	for (const auto& ev: events) {
+		result.push_back(ev.second);
+	}
+	std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+		return a.time_ns > b.time_ns;
+	});
+	return result;
+}
+
+std::vector<Game_Interpreter_Profiler::CommandStats> Game_Interpreter_Profiler::GetCommandStats() {
+	std::vector<CommandStats> result;
+	result.reserve(commands.size());
+	for (const auto& cmd: commands) {
+		result.push_back(cmd.second);
+	}
+	std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+		return a.time_ns > b.time_ns;
+	});
+	return result;
+}
+
+void Game_Interpreter_Profiler::AddUpdateStats(const Game_Interpreter::UpdateStats& stats) {
+	update_stats.executed += stats.executed;
+	update_stats.skipped += stats.skipped;
+}
+
+Game_Interpreter::UpdateStats Game_Interpreter_Profiler::GetUpdateStats() {
+	return update_stats;
+}
+
+void Game_Interpreter_Profiler::Dump(int max_entries) {
+	auto ev_stats = GetEventStats();
+	Output::Debug("Profiler: {} events", ev_stats.size());
+	for (int i = 0; i < std::min<int>(max_entries, ev_stats.size()); ++i) {
+		const auto& ev = ev_stats[i];
+		Output::Debug("Profiler: {:8.2f} ms {:9} cmds {:7} updates (max {}/update) {}",
+			ToMs(ev.time_ns), ev.commands, ev.updates, ev.max_commands_per_update, FormatEvent(ev));
+	}
+
+	auto cmd_stats = GetCommandStats();
+	Output::Debug("Profiler: {} command codes", cmd_stats.size());
+	for (int i = 0; i < std::min<int>(max_entries, cmd_stats.size()); ++i) {
+		const auto& cmd = cmd_stats[i];
+		Output::Debug("Profiler: {:8.2f} ms {:9} cmds code {}", ToMs(cmd.time_ns), cmd.count, cmd.code);
+	}
+
+	Output::Debug("Profiler: {} interpreter updates executed, {} skipped while waiting", update_stats.executed, update_stats.skipped);
+}
+
+void Game_Interpreter_Profiler::Quit() {
+	if (!IsEnabled()) {
+		return;
+	}
+
+	Dump();
+	if (!output_path.empty()) {
+		WriteJson();
+	}
+
+	detail::enabled = false;
+	Reset();
+}
+
+void Game_Interpreter_Profiler::detail::FinishUpdate(const std::vector<std::pair<uint64_t, int64_t>>& update_commands) {
+	for (const auto& cmd: update_commands) {
+		auto it = events.find(cmd.first);
+		if (it == events.end()) {
+			continue;
+		}
+		auto& ev = it->second;
+		++ev.updates;
+		ev.max_commands_per_update = std::max(ev.max_commands_per_update, cmd.second);
+	}
+}
+
+void Game_Interpreter_Profiler::CommandScope::Begin(const lcf::rpg::SaveEventExecFrame& frame) {
+	const auto type = Game_Interpreter_Shared::EasyRpgEventType(frame);
+	const int map_id = type == EventType::MapEvent ? Game_Map::GetMapId() : 0;
+	key = MakeKey(type, map_id, frame.maniac_event_id);
+
+	auto it = events.find(key);
+	if (it == events.end()) {
+		EventStats ev;
+		ev.type = type;
+		ev.map_id = map_id;
+		ev.event_id = frame.maniac_event_id;
+		ev.name = GetName(type, frame.maniac_event_id);
+		it = events.emplace(key, std::move(ev)).first;
+	}
+
+	event = &it->second;
+	code = frame.commands[frame.current_command].code;
+	start = Game_Clock::now();
+}
+
+void Game_Interpreter_Profiler::CommandScope::End() {
+	const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Game_Clock::now() - start).count();
+
+	++event->commands;
+	event->time_ns += ns;
+
+	auto& cmd = commands[code];
+	cmd.code = code;
+	++cmd.count;
+	cmd.time_ns += ns;
+
+	auto it = std::find_if(update.commands.begin(), update.commands.end(), [this](const auto& c) {
+		return c.first == key;
+	});
+	if (it == update.commands.end()) {
+		update.commands.emplace_back(key, 1);
+	} else {
+		++it->second;
+	}
+}
@@ -0,0 +1,168 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_PROFILER_H
+#define EP_GAME_INTERPRETER_PROFILER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "game_clock.h"
+#include "game_interpreter.h"
+#include "game_interpreter_shared.h"
+#include <lcf/rpg/saveeventexecframe.h>
+
+/**
+ * Opt-in profiler for the event interpreter.
+ *
+ * Records per event and per command code how often they ran and how much
+ * wall time they took. Map events, common events and battle events are
+ * tracked separately. When disabled every hook is a single branch.
+ */
+namespace Game_Interpreter_Profiler {
+	/** Statistics of one map event, common event or battle event page */
+	struct EventStats {
+		Game_Interpreter_Shared::EventType type = Game_Interpreter_Shared::EventType::None;
+		/** Map of a map event, 0 otherwise */
+		int map_id = 0;
+		int event_id = 0;
+		std::string name;
+		/** Interpreter updates in which the event executed commands */
+		int64_t updates = 0;
+		int64_t commands = 0;
+		/** Most commands executed in one interpreter update */
+		int64_t max_commands_per_update = 0;
+		int64_t time_ns = 0;
+	};
+
+	/** Statistics of one event command code */
+	struct CommandStats {
+		int code = 0;
+		int64_t count = 0;
+		int64_t time_ns = 0;
+	};
+
+	/**
+	 * Enables the profiler.
+	 *
+	 * @param path file the statistics are written to as JSON on Quit,
+	 *   when empty only the summary is logged
+	 */
+	void Init(std::string path);
+
+	/** @return whether the profiler is enabled */
+	bool IsEnabled();
+
+	/** Drops all recorded statistics */
+	void Reset();
+
+	/**
+	 * Logs the events and commands that took the most time.
+	 *
+	 * @param max_entries number of events and commands to log
+	 */
+	void Dump(int max_entries = 15);
+
+	/** Logs the summary, writes the JSON file and disables the profiler */
+	void Quit();
+
+	/** @return events sorted by time, most expensive first */
+	std::vector<EventStats> GetEventStats();
+
+	/** @return command codes sorted by time, most expensive first */
+	std::vector<CommandStats> GetCommandStats();
+
+	/**
+	 * Adds the interpreter updates of one frame. Called by Game_Map.
+	 *
+	 * @param stats update counters of all interpreters in this frame
+	 */
+	void AddUpdateStats(const Game_Interpreter::UpdateStats& stats);
+
+	/** @return interpreter updates of all frames since the last Reset */
+	Game_Interpreter::UpdateStats GetUpdateStats();
+
+	/** Tracks the commands executed during one Game_Interpreter::Update */
+	class UpdateScope {
+	public:
+		UpdateScope() = default;
+		UpdateScope(const UpdateScope&) = delete;
+		UpdateScope& operator=(const UpdateScope&) = delete;
+		~UpdateScope();
+
+	private:
+		friend class CommandScope;
+
+		/** Event key and number of commands executed in this update */
+		std::vector<std::pair<uint64_t, int64_t>> commands;
+	};
+
+	/**
+	 * Measures the execution of the current command of a frame.
+	 * Must not outlive a call to Reset.
+	 */
+	class CommandScope {
+	public:
+		CommandScope(UpdateScope& update, const lcf::rpg::SaveEventExecFrame& frame);
+		CommandScope(const CommandScope&) = delete;
+		CommandScope& operator=(const CommandScope&) = delete;
+		~CommandScope();
+
+	private:
+		void Begin(const lcf::rpg::SaveEventExecFrame& frame);
+		void End();
+
+		UpdateScope& update;
+		EventStats* event = nullptr;
+		uint64_t key = 0;
+		int code = 0;
+		Game_Clock::time_point start;
+	};
+
+	namespace detail {
+		extern bool enabled;
+
+		void FinishUpdate(const std::vector<std::pair<uint64_t, int64_t>>& commands);
+	}
+}
+
+inline bool Game_Interpreter_Profiler::IsEnabled() {
+	return detail::enabled;
+}
+
+inline Game_Interpreter_Profiler::UpdateScope::~UpdateScope() {
+	if (!commands.empty()) {
+		detail::FinishUpdate(commands);
+	}
+}
+
+inline Game_Interpreter_Profiler::CommandScope::CommandScope(UpdateScope& update, const lcf::rpg::SaveEventExecFrame& frame)
+	: update(update)
+{
+	if (IsEnabled()) {
+		Begin(frame);
+	}
+}
+
+inline Game_Interpreter_Profiler::CommandScope::~CommandScope() {
+	if (event) {
+		End();
+	}
+}
+
+#endif
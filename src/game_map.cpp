@@ -23,6 +23,8 @@
 #include <algorithm>
 #include <climits>
 #include <numeric>
+#include <functional>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "async_handler.h"
@@ -32,6 +34,7 @@
 #include "game_battler.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
+#include "game_interpreter_profiler.h"
 #include "game_switches.h"
 #include "game_player.h"
 #include "game_party.h"
@@ -43,7 +46,9 @@
 #include "scene_map.h"
 #include <lcf/lmu/reader.h>
 #include <lcf/reader_lcf.h>
+#include "lazy_database.h"
 #include "map_data.h"
+#include "map_preloader.h"
 #include "main_data.h"
 #include "output.h"
 #include "util_macro.h"
@@ -69,6 +74,8 @@ namespace {
 	lcf::rpg::SavePanorama panorama;
 
 	bool need_refresh;
+	// Events to refresh when need_refresh is not set
+	std::vector<int> refresh_event_ids;
 
 	int animation_type;
 	bool animation_fast;
@@ -76,6 +83,14 @@ namespace {
 	std::vector<unsigned char> passages_up;
 	std::vector<Game_Event> events;
 	std::vector<Game_CommonEvent> common_events;
+
+	// Indices into events grouped by position, sorted ascending.
+	// Rebuilt lazily after events were created or destroyed.
+	std::unordered_map<uint64_t, std::vector<int>> event_index;
+	// Position key of every event in the index
+	std::vector<uint64_t> event_index_keys;
+	bool event_index_dirty = true;
+
 	std::unique_ptr<Game_Map::Caching::MapCache> map_cache;
 
 	std::unique_ptr<lcf::rpg::Map> map;
@@ -94,6 +109,14 @@ namespace {
 
 	// Used when the current map is not in the maptree
 	const lcf::rpg::MapInfo empty_map_info;
+
+	struct MapFileEntry {
+		std::string map_file;
+		std::shared_ptr<const lcf::rpg::Map> map;
+	};
+	// Parsed maps, most recently used first
+	std::vector<MapFileEntry> map_files;
+	int map_files_capacity = Game_Map::MapFiles::default_capacity;
 }
 
 namespace Game_Map {
@@ -133,8 +156,16 @@ void Game_Map::InitCommonEvents() {
 	translation_changed = false;
 }
 
+void Game_Map::LoadDeferredDatabase() {
+	if (LazyDatabase::HasPendingSections()) {
+		LazyDatabase::LoadPendingSections();
+		InitCommonEvents();
+	}
+}
+
 void Game_Map::Dispose() {
 	events.clear();
+	event_index_dirty = true;
 	map.reset();
 	map_info = {};
 	panorama = {};
@@ -147,6 +178,8 @@ void Game_Map::Quit() {
 	Output::Debug("MP: map quit");
 	GMI().Quit();
 	map_cache.reset();
+	MapPreloader::Clear();
+	MapFiles::Clear();
 }
 
 int Game_Map::GetMapSaveCount() {
@@ -216,6 +249,8 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 	// events will properly resume upon loading.
 	Main_Data::game_player->UpdateSaveCounts(lcf::Data::system.save_count, GetMapSaveCount());
 
+	MapPreloader::Start(*map, GetMapId());
+
 	//multiplayer setup
 	Output::Debug("MP: map setup id={}", GetMapId());
 	GMI().Connect(GetMapId(), true);
@@ -291,6 +326,8 @@ void Game_Map::SetupFromSave(
 		UpdateUnderlyingEventReferences();
 	}
 	map_info.events.clear();
+	// The event positions were replaced by the savegame
+	event_index_dirty = true;
 	interpreter->Clear();
 
 	GetVehicle(Game_Vehicle::Boat)->SetSaveData(std::move(save_boat));
@@ -329,50 +366,72 @@ void Game_Map::SetupFromSave(
 	// cause panorama chunks to be out of sync.
 	Game_Map::Parallax::ChangeBG(GetParallaxParams());
 
+	MapPreloader::Start(*map, GetMapId());
+
 	//multiplayer setup
 	Output::Debug("MP: map setup from save id={}", GetMapId());
 	GMI().Connect(GetMapId());
 }
 
+std::string Game_Map::FindMapFile(int map_id, bool& is_easyrpg) {
+	// Attempt to find either the EasyRPG map file or the RPG Maker map file first, depending on config.
+	// If it fails, try the other one.
+	is_easyrpg = Player::player_config.prefer_easyrpg_map_files.Get();
+	std::string map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, is_easyrpg));
+	if (map_file.empty()) {
+		is_easyrpg = !is_easyrpg;
+		map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, is_easyrpg));
+	}
+	return map_file;
+}
+
 std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id, bool map_changed) {
 	std::unique_ptr<lcf::rpg::Map> map;
 
-	// Attempt to load either the EasyRPG map file or the RPG Maker map file first, depending on config.
-	// If it fails, try the other one.
 	// FIXME: Assert map was cached for async platforms
-	bool map_is_easyrpg_file = Player::player_config.prefer_easyrpg_map_files.Get();
+	bool map_is_easyrpg_file;
+	std::string map_file = FindMapFile(map_id, map_is_easyrpg_file);
 	std::string map_name = Game_Map::ConstructMapName(map_id, map_is_easyrpg_file);
-	std::string map_file = FileFinder::Game().FindFile(map_name);
 	if (map_file.empty()) {
-		map_is_easyrpg_file = !map_is_easyrpg_file;
-		map_name = Game_Map::ConstructMapName(map_id, map_is_easyrpg_file);
-		map_file = FileFinder::Game().FindFile(map_name);
-
-		if (map_file.empty()) {
-			Output::Error("Loading of Map {} failed.\nThe map was not found.", map_name);
-			return nullptr;
-		}
-	}
-
-	auto map_stream = FileFinder::Game().OpenInputStream(map_file);
-	if (!map_stream) {
-		Output::Error("Loading of Map {} failed.\nMap not readable.", map_name);
+		Output::Error("Loading of Map {} failed.\nThe map was not found.", map_name);
 		return nullptr;
 	}
 
-	if (map_is_easyrpg_file) {
-		map = lcf::LMU_Reader::LoadXml(map_stream);
-	} else {
-		map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
-		if (Input::IsRecording()) {
-			map_stream.clear();
-			map_stream.seekg(0);
+	if (auto cached = MapFiles::Find(map_file)) {
+		map = std::make_unique<lcf::rpg::Map>(*cached);
+
+		if (!map_is_easyrpg_file && Input::IsRecording()) {
+			auto map_stream = FileFinder::Game().OpenInputStream(map_file);
 			Input::AddRecordingData(Input::RecordingData::Hash,
 							fmt::format("map{:04} {:#08x}", map_id, Utils::CRC32(map_stream)));
 		}
-	}
 
-	Output::Debug("Loaded Map {}", map_name);
+		Output::Debug("Loaded Map {} (cached)", map_name);
+	} else {
+		auto map_stream = FileFinder::Game().OpenInputStream(map_file);
+		if (!map_stream) {
+			Output::Error("Loading of Map {} failed.\nMap not readable.", map_name);
+			return nullptr;
+		}
+
+		if (map_is_easyrpg_file) {
+			map = lcf::LMU_Reader::LoadXml(map_stream);
+		} else {
+			map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
+			if (Input::IsRecording()) {
+				map_stream.clear();
+				map_stream.seekg(0);
+				Input::AddRecordingData(Input::RecordingData::Hash,
+								fmt::format("map{:04} {:#08x}", map_id, Utils::CRC32(map_stream)));
+			}
+		}
+
+		if (map && MapFiles::GetCapacity() > 0) {
+			MapFiles::Insert(map_file, std::make_shared<lcf::rpg::Map>(*map));
+		}
+
+		Output::Debug("Loaded Map {}", map_name);
+	}
 
 	if (map_changed) {
 		Web_API::OnLoadMap(map_name);
@@ -385,6 +444,53 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id, bool map_change
 	return map;
 }
 
+void Game_Map::MapFiles::Clear() {
+	map_files.clear();
+}
+
+void Game_Map::MapFiles::SetCapacity(int max_maps) {
+	map_files_capacity = std::max(max_maps, 0);
+	if (static_cast<int>(map_files.size()) > map_files_capacity) {
+		map_files.resize(map_files_capacity);
+	}
+}
+
+int Game_Map::MapFiles::GetCapacity() {
+	return map_files_capacity;
+}
+
+int Game_Map::MapFiles::GetSize() {
+	return static_cast<int>(map_files.size());
+}
+
+std::shared_ptr<const lcf::rpg::Map> Game_Map::MapFiles::Find(std::string_view map_file) {
+	auto it = std::find_if(map_files.begin(), map_files.end(), [&](const auto& entry) {
+		return entry.map_file == map_file;
+	});
+	if (it == map_files.end()) {
+		return nullptr;
+	}
+	// Move to the front
+	std::rotate(map_files.begin(), it, it + 1);
+	return map_files.front().map;
+}
+
+void Game_Map::MapFiles::Insert(std::string map_file, std::shared_ptr<const lcf::rpg::Map> map) {
+	if (map_files_capacity == 0) {
+		return;
+	}
+
+	auto it = std::find_if(map_files.begin(), map_files.end(), [&](const auto& entry) {
+		return entry.map_file == map_file;
+	});
+	if (it != map_files.end()) {
+		map_files.erase(it);
+	} else if (static_cast<int>(map_files.size()) >= map_files_capacity) {
+		map_files.pop_back();
+	}
+	map_files.insert(map_files.begin(), { std::move(map_file), std::move(map) });
+}
+
 void Game_Map::SetupCommon() {
 	screen_width = (Player::screen_width / 16.0) * SCREEN_TILE_SIZE;
 	screen_height = (Player::screen_height / 16.0) * SCREEN_TILE_SIZE;
@@ -396,6 +502,9 @@ void Game_Map::SetupCommon() {
 
 	PrintPathToMap();
 
+	// Already done by Player when the game starts
+	LoadDeferredDatabase();
+
 	if (translation_changed) {
 		InitCommonEvents();
 	}
@@ -406,6 +515,7 @@ void Game_Map::SetupCommon() {
 }
 
 void Game_Map::CreateMapEvents() {
+	event_index_dirty = true;
 	events.reserve(map->events.size());
 	for (auto& ev : map->events) {
 		events.emplace_back(GetMapId(), &ev);
@@ -426,6 +536,18 @@ void Game_Map::AddEventToCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->AddEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item) {
+			map_cache->AddEventAsRefreshTarget<Op::ItemSet>(pg.condition.item_id, ev);
+		}
+		if (pg.condition.flags.actor) {
+			map_cache->AddEventAsRefreshTarget<Op::ActorSet>(pg.condition.actor_id, ev);
+		}
+		if (pg.condition.flags.timer) {
+			map_cache->AddEventAsRefreshTarget<Op::TimerSet>(Game_Party::Timer1, ev);
+		}
+		if (pg.condition.flags.timer2) {
+			map_cache->AddEventAsRefreshTarget<Op::TimerSet>(Game_Party::Timer2, ev);
+		}
 	}
 }
 
@@ -442,6 +564,18 @@ void Game_Map::RemoveEventFromCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->RemoveEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item) {
+			map_cache->RemoveEventAsRefreshTarget<Op::ItemSet>(pg.condition.item_id, ev);
+		}
+		if (pg.condition.flags.actor) {
+			map_cache->RemoveEventAsRefreshTarget<Op::ActorSet>(pg.condition.actor_id, ev);
+		}
+		if (pg.condition.flags.timer) {
+			map_cache->RemoveEventAsRefreshTarget<Op::TimerSet>(Game_Party::Timer1, ev);
+		}
+		if (pg.condition.flags.timer2) {
+			map_cache->RemoveEventAsRefreshTarget<Op::TimerSet>(Game_Party::Timer2, ev);
+		}
 	}
 }
 
@@ -505,6 +639,7 @@ bool Game_Map::CloneMapEvent(int src_map_id, int src_event_id, int target_x, int
 		std::upper_bound(events.begin(), events.end(), game_event, [](const auto& e, const auto& e2) {
 			return e.GetId() < e2.GetId();
 		}), std::move(game_event));
+	event_index_dirty = true;
 
 	UpdateUnderlyingEventReferences();
 
@@ -536,6 +671,7 @@ bool Game_Map::DestroyMapEvent(const int event_id, bool from_clone) {
 	for (auto it = events.begin(); it != events.end(); ++it) {
 		if (it->GetId() == event_id) {
 			events.erase(it);
+			event_index_dirty = true;
 			break;
 		}
 	}
@@ -658,12 +794,23 @@ std::vector<uint8_t> Game_Map::GetTilesLayer(int layer) {
 
 void Game_Map::Refresh() {
 	if (GetMapId() > 0) {
-		for (Game_Event& ev : events) {
-			ev.RefreshPage();
+		if (need_refresh) {
+			for (Game_Event& ev : events) {
+				ev.RefreshPage();
+			}
+		} else if (!refresh_event_ids.empty()) {
+			// Same order as a full refresh
+			std::sort(refresh_event_ids.begin(), refresh_event_ids.end());
+			for (Game_Event& ev : events) {
+				if (std::binary_search(refresh_event_ids.begin(), refresh_event_ids.end(), ev.GetId())) {
+					ev.RefreshPage();
+				}
+			}
 		}
 	}
 
 	need_refresh = false;
+	refresh_event_ids.clear();
 }
 
 Game_Interpreter_Map& Game_Map::GetInterpreter() {
@@ -903,16 +1050,16 @@ bool Game_Map::CheckOrMakeWayEx(const Game_Character& self,
 	if (vehicle_type != Game_Vehicle::Airship && check_events_and_vehicles) {
 		// Check for collision with events on the target tile.
 		if (ignore_some_events_by_id.empty()) {
-			for (auto& other: GetEvents()) {
-				if (CheckOrMakeCollideEvent(other)) {
+			for (auto* other = GetNextEventAt(to_x, to_y); other; other = GetNextEventAt(to_x, to_y, other)) {
+				if (CheckOrMakeCollideEvent(*other)) {
 					return false;
 				}
 			}
 		} else {
-			for (auto& other: GetEvents()) {
-				if (std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
+			for (auto* other = GetNextEventAt(to_x, to_y); other; other = GetNextEventAt(to_x, to_y, other)) {
+				if (std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other->GetId()) != ignore_some_events_by_id.end())
 					continue;
-				if (CheckOrMakeCollideEvent(other)) {
+				if (CheckOrMakeCollideEvent(*other)) {
 					return false;
 				}
 			}
@@ -972,10 +1119,8 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventAt(x, y); ev; ev = GetNextEventAt(x, y, ev)) {
+		if (ev->IsActive() && ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -1010,11 +1155,10 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
-			&& ev.IsActive()
-			&& ev.GetActivePage() != nullptr) {
+	for (auto* ev = GetNextEventAt(x, y); ev; ev = GetNextEventAt(x, y, ev)) {
+		if (ev->GetLayer() == lcf::rpg::EventPage::Layers_same
+			&& ev->IsActive()
+			&& ev->GetActivePage() != nullptr) {
 			return false;
 		}
 	}
@@ -1088,16 +1232,16 @@ bool Game_Map::IsPassableTile(
 
 		// Highest ID event with layer=below, not through, and a tile graphic wins.
 		int event_tile_id = 0;
-		for (auto& ev: events) {
-			if (self == &ev) {
+		for (auto* ev = GetNextEventAt(x, y); ev; ev = GetNextEventAt(x, y, ev)) {
+			if (self == ev) {
 				continue;
 			}
-			if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
+			if (!ev->IsActive() || ev->GetActivePage() == nullptr || ev->GetThrough()) {
 				continue;
 			}
-			if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
-				if (ev.HasTileSprite()) {
-					event_tile_id = ev.GetTileId();
+			if (ev->GetLayer() == lcf::rpg::EventPage::Layers_below) {
+				if (ev->HasTileSprite()) {
+					event_tile_id = ev->GetTileId();
 				}
 			}
 		}
@@ -1201,17 +1345,80 @@ int Game_Map::GetTerrainTag(int x, int y) {
 	return terrain_data[chip_index];
 }
 
+static uint64_t EventIndexKey(int x, int y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static const std::vector<int>* GetEventIndexBucket(int x, int y) {
+	if (event_index_dirty) {
+		event_index.clear();
+		event_index_keys.resize(events.size());
+		for (int i = 0; i < static_cast<int>(events.size()); ++i) {
+			const auto key = EventIndexKey(events[i].GetX(), events[i].GetY());
+			event_index_keys[i] = key;
+			event_index[key].push_back(i);
+		}
+		event_index_dirty = false;
+	}
+
+	auto it = event_index.find(EventIndexKey(x, y));
+	if (it == event_index.end() || it->second.empty()) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
+	const auto* bucket = GetEventIndexBucket(x, y);
+	if (!bucket) {
+		return nullptr;
+	}
+	for (auto iter = bucket->rbegin(); iter != bucket->rend(); ++iter) {
+		auto& ev = events[*iter];
+		if (!require_active || ev.IsActive()) {
 			return &ev;
 		}
 	}
 	return nullptr;
 }
 
+Game_Event* Game_Map::GetNextEventAt(int x, int y, const Game_Event* prev) {
+	const auto* bucket = GetEventIndexBucket(x, y);
+	if (!bucket) {
+		return nullptr;
+	}
+	// The bucket is looked up again on every call because the events can move in between
+	const int prev_idx = prev ? static_cast<int>(prev - events.data()) : -1;
+	auto it = std::upper_bound(bucket->begin(), bucket->end(), prev_idx);
+	return it != bucket->end() ? &events[*it] : nullptr;
+}
+
+void Game_Map::OnEventPositionChanged(const Game_Character& ch) {
+	if (event_index_dirty) {
+		return;
+	}
+
+	// Events that are not part of the map (e.g. while being cloned) are not indexed
+	const auto* ev = static_cast<const Game_Event*>(&ch);
+	const std::less<const Game_Event*> less;
+	if (less(ev, events.data()) || !less(ev, events.data() + events.size())) {
+		return;
+	}
+
+	const int idx = static_cast<int>(ev - events.data());
+	const auto key = EventIndexKey(ev->GetX(), ev->GetY());
+	auto& old_key = event_index_keys[idx];
+	if (key == old_key) {
+		return;
+	}
+
+	auto& old_bucket = event_index[old_key];
+	old_bucket.erase(std::lower_bound(old_bucket.begin(), old_bucket.end(), idx));
+	auto& bucket = event_index[key];
+	bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), idx), idx);
+	old_key = key;
+}
+
 bool Game_Map::LoopHorizontal() {
 	return map->scroll_type == lcf::rpg::Map::ScrollType_horizontal || map->scroll_type == lcf::rpg::Map::ScrollType_both;
 }
@@ -1261,13 +1468,8 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
-	}
-
-	return 0;
+	const auto* ev = GetNextEventAt(x, y);
+	return ev ? ev->GetId() : 0;
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
@@ -1278,6 +1480,13 @@ void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
 	if (!actx.IsActive()) {
 		//If not resuming from async op ...
 		UpdateProcessedFlags(is_preupdate);
+
+		if (Game_Interpreter_Profiler::IsEnabled()) {
+			Game_Interpreter_Profiler::AddUpdateStats(Game_Interpreter::GetUpdateStats());
+		}
+		Game_Interpreter::ResetUpdateStats();
+
+		MapPreloader::Update();
 	}
 
 	if (!actx.IsActive() || actx.IsParallelCommonEvent()) {
@@ -1800,25 +2009,73 @@ bool Game_Map::GetNeedRefresh() {
 		return false;
 	}
 
-	return need_refresh;
+	return need_refresh || !refresh_event_ids.empty();
 }
 
 void Game_Map::SetNeedRefresh(bool refresh) {
 	need_refresh = refresh;
+	if (!refresh) {
+		refresh_event_ids.clear();
+	}
+}
+
+static void CompactRefreshEventIds() {
+	// Bounds the pending list when the refresh is delayed, e.g. by the anti-lag switch
+	if (refresh_event_ids.size() > events.size()) {
+		std::sort(refresh_event_ids.begin(), refresh_event_ids.end());
+		refresh_event_ids.erase(std::unique(refresh_event_ids.begin(), refresh_event_ids.end()), refresh_event_ids.end());
+	}
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(int switch_id) {
 	if (need_refresh)
 		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::SwitchSet>(switch_id))
-		SetNeedRefresh(true);
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::SwitchSet>(switch_id, refresh_event_ids);
+	CompactRefreshEventIds();
 }
 
 void Game_Map::SetNeedRefreshForVarChange(int var_id) {
 	if (need_refresh)
 		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::VarSet>(var_id))
-		SetNeedRefresh(true);
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::VarSet>(var_id, refresh_event_ids);
+	CompactRefreshEventIds();
+}
+
+void Game_Map::SetNeedRefreshForSwitchRangeChange(int first_id, int last_id) {
+	if (need_refresh)
+		return;
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::SwitchSet>(first_id, last_id, refresh_event_ids);
+	CompactRefreshEventIds();
+}
+
+void Game_Map::SetNeedRefreshForVarRangeChange(int first_id, int last_id) {
+	if (need_refresh)
+		return;
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::VarSet>(first_id, last_id, refresh_event_ids);
+	CompactRefreshEventIds();
+}
+
+void Game_Map::SetNeedRefreshForItemChange(int item_id) {
+	// Also changed without a map, e.g. in the battle test
+	if (need_refresh || !map_cache)
+		return;
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::ItemSet>(item_id, refresh_event_ids);
+	CompactRefreshEventIds();
+}
+
+void Game_Map::SetNeedRefreshForActorChange(int actor_id) {
+	if (need_refresh)
+		return;
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::ActorSet>(actor_id, refresh_event_ids);
+	CompactRefreshEventIds();
+}
+
+void Game_Map::SetNeedRefreshForTimerChange(int which) {
+	// Also changed without a map, e.g. in the battle test
+	if (need_refresh || !map_cache)
+		return;
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::TimerSet>(which, refresh_event_ids);
+	CompactRefreshEventIds();
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids) {
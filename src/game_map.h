@@ -88,6 +88,13 @@ namespace Game_Map {
 	 */
 	void InitCommonEvents();
 
+	/**
+	 * Parses the database sections deferred by --lazy-database and
+	 * initializes the Common Events again.
+	 * Must be called before any game state referring to them is set up.
+	 */
+	void LoadDeferredDatabase();
+
 	/**
 	 * Quits (frees) Game_Map.
 	 */
@@ -127,7 +134,17 @@ namespace Game_Map {
 	int GetNextAvailableEventId();
 
 	/**
-	 * Loads the map from disk
+	 * Finds the file of a map.
+	 *
+	 * @param map_id the id of the map
+	 * @param is_easyrpg receives whether the file is an EasyRPG map (emu)
+	 * @return path of the map file, empty when not found
+	 */
+	std::string FindMapFile(int map_id, bool& is_easyrpg);
+
+	/**
+	 * Loads the map from disk.
+	 * Recently loaded maps are served from the MapFiles cache.
 	 *
 	 * @param map_id the id of the map to load
 	 * @param map_changed set to true if loading map for map change
@@ -135,6 +152,46 @@ namespace Game_Map {
 	 */
 	std::unique_ptr<lcf::rpg::Map> LoadMapFile(int map_id, bool map_changed);
 
+	/**
+	 * Cache of parsed map files.
+	 *
+	 * Maps are stored untranslated and unmodified. LoadMapFile hands out a
+	 * copy, so the running map can be changed without touching the cache.
+	 * The least recently used map is dropped when the cache is full.
+	 */
+	namespace MapFiles {
+		/** Number of maps kept by default */
+		constexpr int default_capacity = 8;
+
+		/** Drops all cached maps. Called when the game is unloaded. */
+		void Clear();
+
+		/**
+		 * @param max_maps how many maps are kept, 0 disables the cache
+		 */
+		void SetCapacity(int max_maps);
+
+		/** @return how many maps are kept */
+		int GetCapacity();
+
+		/** @return number of cached maps */
+		int GetSize();
+
+		/**
+		 * @param map_file path of the map file in the game filesystem
+		 * @return cached map or nullptr
+		 */
+		std::shared_ptr<const lcf::rpg::Map> Find(std::string_view map_file);
+
+		/**
+		 * Adds a parsed map, replacing an older entry of the same file.
+		 *
+		 * @param map_file path of the map file in the game filesystem
+		 * @param map parsed map
+		 */
+		void Insert(std::string map_file, std::shared_ptr<const lcf::rpg::Map> map);
+	}
+
 	/**
 	 * Setups a new map.
 	 *
@@ -529,7 +586,7 @@ namespace Game_Map {
 	void SetPositionY(int new_position_y, bool reset_panorama = true);
 
 	/**
-	 * @return need refresh flag.
+	 * @return whether a full refresh or a refresh of some events is pending.
 	 */
 	bool GetNeedRefresh();
 
@@ -542,6 +599,7 @@ namespace Game_Map {
 
 	/**
 	 * Sets the need refresh flag.
+	 * When set the next Refresh refreshes the pages of all events.
 	 *
 	 * @param refresh need refresh flag.
 	 */
@@ -608,6 +666,31 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEventAt(int x, int y, bool require_active);
 
+	/**
+	 * Iterates over the events at a position in the order of GetEvents()
+	 * without scanning all events:
+	 *
+	 *   for (auto* ev = GetNextEventAt(x, y); ev; ev = GetNextEventAt(x, y, ev))
+	 *
+	 * Events that move while iterating are handled like in a scan over
+	 * GetEvents(): Only events after prev that are at the position when the
+	 * function is called are returned.
+	 *
+	 * @param x x position on the map
+	 * @param y y position on the map
+	 * @param prev previously returned event or nullptr to start
+	 * @return next event at (x,y) or nullptr
+	 */
+	Game_Event* GetNextEventAt(int x, int y, const Game_Event* prev = nullptr);
+
+	/**
+	 * Updates the position of an event in the event position index.
+	 * Called by Game_Character when the position of an event changes.
+	 *
+	 * @param ev event that moved
+	 */
+	void OnEventPositionChanged(const Game_Character& ev);
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
@@ -719,6 +802,8 @@ namespace Game_Map {
 			void AddEvent(const lcf::rpg::Event& ev);
 			void RemoveEvent(const lcf::rpg::Event& ev);
 
+			const std::vector<int>& GetEventIds() const;
+
 		private:
 			std::vector<int> event_ids;
 		};
@@ -728,6 +813,9 @@ namespace Game_Map {
 		enum ObservedVarOps {
 			SwitchSet = 0,
 			VarSet,
+			ItemSet,
+			ActorSet,
+			TimerSet,
 
 			ObservedVarOps_END
 		};
@@ -743,6 +831,25 @@ namespace Game_Map {
 			template <ObservedVarOps Op>
 			bool GetNeedRefresh(int var_id);
 
+			/**
+			 * Appends the events which have a page depending on var_id.
+			 *
+			 * @param var_id id of the changed switch, variable, item, actor or timer
+			 * @param event_ids receives the event ids
+			 */
+			template <ObservedVarOps Op>
+			void CollectRefreshTargets(int var_id, std::vector<int>& event_ids);
+
+			/**
+			 * Appends the events which have a page depending on any id in the range.
+			 *
+			 * @param first_id first changed id
+			 * @param last_id last changed id (inclusive)
+			 * @param event_ids receives the event ids
+			 */
+			template <ObservedVarOps Op>
+			void CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids);
+
 			void Clear();
 		private:
 			MapEventCacheData_t refresh_targets_by_varid[ObservedVarOps_END];
@@ -753,6 +860,12 @@ namespace Game_Map {
 	void SetNeedRefreshForVarChange(int var_id);
 	void SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids);
 	void SetNeedRefreshForVarChange(std::initializer_list<int> var_ids);
+	void SetNeedRefreshForSwitchRangeChange(int first_id, int last_id);
+	void SetNeedRefreshForVarRangeChange(int first_id, int last_id);
+	void SetNeedRefreshForItemChange(int item_id);
+	void SetNeedRefreshForActorChange(int actor_id);
+	/** @param which Game_Party::Timer1 or Game_Party::Timer2 */
+	void SetNeedRefreshForTimerChange(int which);
 
 	namespace Parallax {
 		struct Params {
@@ -922,4 +1035,35 @@ inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int var_id) {
 	return events_cache.find(var_id) != events_cache.end();
 }
 
+template <Game_Map::Caching::ObservedVarOps Op>
+inline void Game_Map::Caching::MapCache::CollectRefreshTargets(int var_id, std::vector<int>& event_ids) {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+	auto it = events_cache.find(var_id);
+	if (it != events_cache.end()) {
+		const auto& ids = it->second.GetEventIds();
+		event_ids.insert(event_ids.end(), ids.begin(), ids.end());
+	}
+}
+
+template <Game_Map::Caching::ObservedVarOps Op>
+inline void Game_Map::Caching::MapCache::CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids) {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	// Only ids used in page conditions are in the cache, so walking the cache
+	// is cheaper than looking up every id of a large range.
+	auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+	for (auto& [var_id, cache]: events_cache) {
+		if (var_id >= first_id && var_id <= last_id) {
+			const auto& ids = cache.GetEventIds();
+			event_ids.insert(event_ids.end(), ids.begin(), ids.end());
+		}
+	}
+}
+
+inline const std::vector<int>& Game_Map::Caching::MapEventCache::GetEventIds() const {
+	return event_ids;
+}
+
 #endif
@@ -196,6 +196,7 @@ void Game_Party::AddItem(int item_id, int amount) {
 			data.item_ids.insert(data.item_ids.begin() + idx, (int16_t)item_id);
 			data.item_counts.insert(data.item_counts.begin() + idx, (uint8_t)amount);
 			data.item_usage.insert(data.item_usage.begin() + idx, 0);
+			Game_Map::SetNeedRefreshForItemChange(item_id);
 		}
 		return;
 	}
@@ -206,6 +207,7 @@ void Game_Party::AddItem(int item_id, int amount) {
 		data.item_ids.erase(data.item_ids.begin() + idx);
 		data.item_counts.erase(data.item_counts.begin() + idx);
 		data.item_usage.erase(data.item_usage.begin() + idx);
+		Game_Map::SetNeedRefreshForItemChange(item_id);
 		return;
 	}
 
@@ -261,6 +263,7 @@ void Game_Party::ConsumeItemUse(int item_id) {
 			data.item_ids.erase(data.item_ids.begin() + idx);
 			data.item_counts.erase(data.item_counts.begin() + idx);
 			data.item_usage.erase(data.item_usage.begin() + idx);
+			Game_Map::SetNeedRefreshForItemChange(item_id);
 		} else {
 			data.item_counts[idx]--;
 			data.item_usage[idx] = 0;
@@ -459,6 +462,15 @@ bool Game_Party::UseSkill(int skill_id, Game_Actor* source, Game_Actor* target)
 	return was_used;
 }
 
+static void RefreshEquipmentConditions(const Game_Actor& actor) {
+	// Item page conditions also count the items equipped by party members
+	for (int item_id: actor.GetWholeEquipment()) {
+		if (item_id > 0) {
+			Game_Map::SetNeedRefreshForItemChange(item_id);
+		}
+	}
+}
+
 void Game_Party::AddActor(int actor_id) {
 	auto* actor = Main_Data::game_actors->GetActor(actor_id);
 	if (!actor) {
@@ -471,6 +483,7 @@ void Game_Party::AddActor(int actor_id) {
 		return;
 	data.party.push_back((int16_t)actor_id);
 	Main_Data::game_player->ResetGraphic();
+	RefreshEquipmentConditions(*actor);
 
 	auto scene = Scene::Find(Scene::Battle);
 	if (scene) {
@@ -488,6 +501,7 @@ void Game_Party::RemoveActor(int actor_id) {
 	if (!actor) {
 		return;
 	}
+	RefreshEquipmentConditions(*actor);
 
 	auto scene = Scene::Find(Scene::Battle);
 	if (scene) {
@@ -538,11 +552,11 @@ void Game_Party::SetTimer(int which, int seconds) {
 	switch (which) {
 		case Timer1:
 			data.timer1_frames = seconds * DEFAULT_FPS + (DEFAULT_FPS - 1);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForTimerChange(Timer1);
 			break;
 		case Timer2:
 			data.timer2_frames = seconds * DEFAULT_FPS + (DEFAULT_FPS -1);
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForTimerChange(Timer2);
 			break;
 	}
 }
@@ -577,14 +591,15 @@ void Game_Party::StopTimer(int which) {
 
 void Game_Party::UpdateTimers() {
 	const bool battle = Game_Battle::IsBattleRunning();
-	bool seconds_changed = false;
 
 	if (data.timer1_active && (data.timer1_battle || !battle) && data.timer1_frames > 0) {
 		data.timer1_frames = data.timer1_frames - 1;
 
 		const int seconds = data.timer1_frames / DEFAULT_FPS;
 		const int mod_frames = data.timer1_frames % DEFAULT_FPS;
-		seconds_changed |= (mod_frames == (DEFAULT_FPS - 1));
+		if (mod_frames == (DEFAULT_FPS - 1)) {
+			Game_Map::SetNeedRefreshForTimerChange(Timer1);
+		}
 
 		if (seconds == 0) {
 			StopTimer(Timer1);
@@ -596,16 +611,14 @@ void Game_Party::UpdateTimers() {
 
 		const int seconds = data.timer2_frames / DEFAULT_FPS;
 		const int mod_frames = data.timer2_frames % DEFAULT_FPS;
-		seconds_changed |= (mod_frames == (DEFAULT_FPS - 1));
+		if (mod_frames == (DEFAULT_FPS - 1)) {
+			Game_Map::SetNeedRefreshForTimerChange(Timer2);
+		}
 
 		if (seconds == 0) {
 			StopTimer(Timer2);
 		}
 	}
-
-	if (seconds_changed) {
-		Game_Map::SetNeedRefresh(true);
-	}
 }
 
 int Game_Party::GetTimerSeconds(int which) {
@@ -69,15 +69,74 @@ Game_Pictures::Picture::Picture(lcf::rpg::SavePicture save)
 	needs_update = !IsEmpty(data);
 }
 
+void Game_Pictures::Activate(Picture& pic) {
+	pic.needs_update = true;
+	if (pic.active || GetPlayerIdForPicture(pic.data.ID) >= 0) {
+		return;
+	}
+	pic.data.frames += GetInactiveFrames(pic);
+	pic.active = true;
+	active_pictures.push_back(pic.data.ID);
+}
+
+int Game_Pictures::GetInactiveFrames(const Picture& pic) const {
+	// Picture::Update counts frames even when nothing else changes.
+	// Inactive pictures are not updated, so catch up here.
+	int frames = 0;
+	if (pic.IsOnMap()) {
+		frames += map_frames - pic.inactive_map_frames;
+	}
+	if (pic.IsOnBattle()) {
+		frames += battle_frames - pic.inactive_battle_frames;
+	}
+	return frames;
+}
+
+template <typename F>
+void Game_Pictures::ForEachPicture(F&& f) {
+	for (int id: active_pictures) {
+		f(pictures[id - 1]);
+	}
+	for (auto& player: remote_pictures) {
+		for (auto& pic: player.second) {
+			f(pic.second);
+		}
+	}
+}
+
+template <typename P>
+void Game_Pictures::EraseRemotePictures(P&& pred) {
+	// Remote pictures are destroyed instead of being kept as empty slots
+	for (auto player = remote_pictures.begin(); player != remote_pictures.end();) {
+		auto& pics = player->second;
+		for (auto pic = pics.begin(); pic != pics.end();) {
+			if (pred(pic->second)) {
+				pic = pics.erase(pic);
+			} else {
+				++pic;
+			}
+		}
+		if (pics.empty()) {
+			player = remote_pictures.erase(player);
+		} else {
+			++player;
+		}
+	}
+}
+
 void Game_Pictures::InitGraphics() {
-	for (auto& pic: pictures) {
+	ForEachPicture([this](Picture& pic) {
 		RequestPictureSprite(pic);
-	}
+	});
 }
 
 void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 {
 	pictures.clear();
+	remote_pictures.clear();
+	active_pictures.clear();
+	map_frames = 0;
+	battle_frames = 0;
 
 	frame_counter = save.empty() ? 0 : save.back().frames;
 
@@ -92,7 +151,10 @@ void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 
 	pictures.reserve(num_pictures);
 	for (int i = 0; i < num_pictures; ++i) {
-		pictures.emplace_back(std::move(save[i]));
+		auto& pic = pictures.emplace_back(std::move(save[i]));
+		if (pic.needs_update) {
+			Activate(pic);
+		}
 	}
 }
 
@@ -102,15 +164,15 @@ std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
 	auto data_size = GetDefaultNumberOfPictures();
 	// YNO: upstream just saves all images which is correct in singleplayer
 	// but in multiplayer we don't want to save pictures generated by other players
-	// because 1) they occupy needless space and 2) they will be immediately out of date
-	constexpr int min_pic_id = 1;
-	constexpr int min_player_id = 0;
-	const int multiplayer_pic_ids_begin = GetPictureIdForPlayer(min_player_id, min_pic_id);
-	save.reserve(multiplayer_pic_ids_begin);
+	// because 1) they occupy needless space and 2) they will be immediately out of date.
+	// These live in remote_pictures and are therefore skipped here.
+	save.reserve(std::max(data_size, static_cast<int>(pictures.size())));
 
 	for (const auto& pic: pictures) {
-		if (pic.data.ID >= multiplayer_pic_ids_begin) continue;
 		save.push_back(pic.data);
+		if (!pic.active) {
+			save.back().frames += GetInactiveFrames(pic);
+		}
 	}
 
 	// RPG_RT Save game data always has a constant number of pictures
@@ -157,35 +219,70 @@ int Game_Pictures::GetPictureIdForPlayer(int player_id, int pic_id) {
 	return (player_id + 1) * GetDefaultNumberOfPictures() + pic_id;
 }
 
+int Game_Pictures::GetPlayerIdForPicture(int id) {
+	const int num_pictures = GetDefaultNumberOfPictures();
+	if (num_pictures <= 0 || id <= num_pictures) {
+		return -1;
+	}
+	return (id - 1) / num_pictures - 1;
+}
+
 Game_Pictures::Picture& Game_Pictures::GetPicture(int id) {
+	const int player_id = GetPlayerIdForPicture(id);
+	if (EP_UNLIKELY(player_id >= 0)) {
+		// Player ids are assigned by the server and can be large, a dense
+		// vector would allocate every picture slot of every lower player id
+		return remote_pictures[player_id].try_emplace(id, id).first->second;
+	}
+
 	if (EP_UNLIKELY(id > static_cast<int>(pictures.size()))) {
 		pictures.reserve(id);
 		while (static_cast<int>(pictures.size()) < id) {
-			pictures.emplace_back(static_cast<int>(pictures.size()) + 1);
+			auto& pic = pictures.emplace_back(static_cast<int>(pictures.size()) + 1);
+			pic.inactive_map_frames = map_frames;
+			pic.inactive_battle_frames = battle_frames;
 		}
 	}
 	return pictures[id - 1];
 }
 
 Game_Pictures::Picture* Game_Pictures::GetPicturePtr(int id) {
+	const int player_id = GetPlayerIdForPicture(id);
+	if (EP_UNLIKELY(player_id >= 0)) {
+		auto player = remote_pictures.find(player_id);
+		if (player == remote_pictures.end()) {
+			return nullptr;
+		}
+		auto pic = player->second.find(id);
+		return pic != player->second.end() ? &pic->second : nullptr;
+	}
+
 	return id <= static_cast<int>(pictures.size())
 		? &pictures[id - 1] : nullptr;
 }
 
 void Game_Pictures::OnMapChange() {
-	for (auto& pic: pictures) {
+	for (int id: active_pictures) {
+		auto& pic = pictures[id - 1];
 		if (pic.data.flags.erase_on_map_change) {
 			pic.Erase();
 		}
 	}
+	EraseRemotePictures([](const Picture& pic) {
+		return pic.data.flags.erase_on_map_change;
+	});
 }
 
 void Game_Pictures::OnBattleEnd() {
-	for (auto& pic: pictures) {
+	for (int id: active_pictures) {
+		auto& pic = pictures[id - 1];
 		if (pic.data.flags.erase_on_battle_end) {
 			pic.Erase();
 		}
 	}
+	EraseRemotePictures([](const Picture& pic) {
+		return pic.data.flags.erase_on_battle_end;
+	});
 }
 
 bool Game_Pictures::Picture::Show(const ShowParams& params) {
@@ -264,6 +361,7 @@ bool Game_Pictures::Picture::Show(const ShowParams& params) {
 
 bool Game_Pictures::Show(int id, const ShowParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	if (pic.Show(params)) {
 		RequestPictureSprite(pic);
 		return true;
@@ -328,10 +426,13 @@ void Game_Pictures::Picture::Move(const MoveParams& params) {
 
 void Game_Pictures::Move(int id, const MoveParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	pic.Move(params);
 }
 
 void Game_Pictures::Picture::Erase() {
+	// Removed from the active pictures by the next Game_Pictures::Update
+	needs_update = false;
 	request_id = {};
 	data.name.clear();
 	if (sprite) {
@@ -344,6 +445,18 @@ void Game_Pictures::Picture::Erase() {
 }
 
 void Game_Pictures::Erase(int id) {
+	const int player_id = GetPlayerIdForPicture(id);
+	if (EP_UNLIKELY(player_id >= 0)) {
+		auto player = remote_pictures.find(player_id);
+		if (player != remote_pictures.end()) {
+			player->second.erase(id);
+			if (player->second.empty()) {
+				remote_pictures.erase(player);
+			}
+		}
+		return;
+	}
+
 	auto* pic = GetPicturePtr(id);
 	if (EP_LIKELY(pic)) {
 		pic->Erase();
@@ -351,27 +464,18 @@ void Game_Pictures::Erase(int id) {
 }
 
 void Game_Pictures::EraseAll() {
-	for (auto& pic: pictures) {
-		pic.Erase();
+	for (int id: active_pictures) {
+		pictures[id - 1].Erase();
 	}
+	remote_pictures.clear();
 }
 
 void Game_Pictures::EraseAllMultiplayer() {
-	for (auto& pic: pictures) {
-		if (pic.data.ID > GetDefaultNumberOfPictures()) {
-			pic.Erase();
-		}
-	}
+	remote_pictures.clear();
 }
 
 void Game_Pictures::EraseAllMultiplayerForPlayer(int id) {
-	auto start = GetPictureIdForPlayer(id, 1);
-	auto end = start + GetDefaultNumberOfPictures();
-	for (auto& pic: pictures) {
-		if (pic.data.ID >= start && pic.data.ID < end) {
-			pic.Erase();
-		}
-	}
+	remote_pictures.erase(id);
 }
 
 bool Game_Pictures::Picture::Exists() const {
@@ -513,9 +617,9 @@ void Game_Pictures::Picture::OnMapScrolled(int dx16, int dy16) {
 }
 
 void Game_Pictures::OnMapScrolled(int dx, int dy) {
-	for (auto& pic: pictures) {
+	ForEachPicture([dx, dy](Picture& pic) {
 		pic.OnMapScrolled(dx, dy);
-	}
+	});
 }
 
 void Game_Pictures::Picture::AttachWindow(const Window_Base& window) {
@@ -629,8 +733,29 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 
 void Game_Pictures::Update(bool is_battle) {
 	++frame_counter;
-	for (auto& pic: pictures) {
+
+	for (size_t i = 0; i < active_pictures.size();) {
+		auto& pic = pictures[active_pictures[i] - 1];
+		if (!pic.needs_update) {
+			pic.active = false;
+			pic.inactive_map_frames = map_frames;
+			pic.inactive_battle_frames = battle_frames;
+			active_pictures[i] = active_pictures.back();
+			active_pictures.pop_back();
+			continue;
+		}
 		pic.Update(is_battle);
+		++i;
+	}
+
+	for (auto& player: remote_pictures) {
+		for (auto& pic: player.second) {
+			pic.second.Update(is_battle);
+		}
+	}
+
+	if (Player::IsRPG2k3ECommands()) {
+		++(is_battle ? battle_frames : map_frames);
 	}
 }
 
@@ -21,6 +21,8 @@
 // Headers
 #include <string>
 #include <deque>
+#include <map>
+#include <unordered_map>
 #include "async_handler.h"
 #include <lcf/rpg/savepicture.h>
 #include "sprite_picture.h"
@@ -44,6 +46,14 @@ public:
 	static int GetDefaultNumberOfPictures();
 	static int GetPictureIdForPlayer(int player_id, int pic_id);
 
+	/**
+	 * Inverse of GetPictureIdForPlayer.
+	 *
+	 * @param id picture id
+	 * @return id of the player owning the picture or -1 for local pictures
+	 */
+	static int GetPlayerIdForPicture(int id);
+
 	struct Params {
 		int position_x = 0;
 		int position_y = 0;
@@ -104,6 +114,11 @@ public:
 		lcf::rpg::SavePicture data;
 		FileRequestBinding request_id;
 		bool needs_update = false;
+		/** Picture is listed in the active pictures of Game_Pictures */
+		bool active = false;
+		/** Frame counters of Game_Pictures when the picture became inactive */
+		int inactive_map_frames = 0;
+		int inactive_battle_frames = 0;
 		int origin = 0;
 
 		void Update(bool is_battle);
@@ -140,7 +155,24 @@ private:
 	void RequestPictureSprite(Picture& pic);
 	void OnPictureSpriteReady(FileRequestResult*, int id);
 
+	void Activate(Picture& pic);
+	int GetInactiveFrames(const Picture& pic) const;
+
+	template <typename F>
+	void ForEachPicture(F&& f);
+
+	template <typename P>
+	void EraseRemotePictures(P&& pred);
+
+	/** Local pictures, indexed by id - 1 */
 	std::vector<Picture> pictures;
+	/** Pictures of other players: player id -> (picture id -> picture) */
+	std::unordered_map<int, std::map<int, Picture>> remote_pictures;
+	/** Ids of the local pictures which are updated every frame */
+	std::vector<int> active_pictures;
+	/** Frames elapsed on map and in battle, used to update frames of inactive pictures lazily */
+	int map_frames = 0;
+	int battle_frames = 0;
 	int frame_counter = 0;
 };
 
@@ -454,11 +454,10 @@ bool Game_Player::CheckEventTriggerHere(TriggerSet triggers, bool triggered_by_d
 
 	bool result = false;
 
-	for (auto& ev: Game_Map::GetEvents()) {
+	for (auto* evp = Game_Map::GetNextEventAt(GetX(), GetY()); evp; evp = Game_Map::GetNextEventAt(GetX(), GetY(), evp)) {
+		auto& ev = *evp;
 		const auto trigger = ev.GetTrigger();
 		if (ev.IsActive()
-				&& ev.GetX() == GetX()
-				&& ev.GetY() == GetY()
 				&& ev.GetLayer() != lcf::rpg::EventPage::Layers_same
 				&& trigger.has_value()
 				&& triggers[*trigger]) {
@@ -479,11 +478,10 @@ bool Game_Player::CheckEventTriggerThere(TriggerSet triggers, int x, int y, bool
 	}
 	bool result = false;
 
-	for (auto& ev : Game_Map::GetEvents()) {
+	for (auto* evp = Game_Map::GetNextEventAt(x, y); evp; evp = Game_Map::GetNextEventAt(x, y, evp)) {
+		auto& ev = *evp;
 		const auto trigger = ev.GetTrigger();
 		if (ev.IsActive()
-				&& ev.GetX() == x
-				&& ev.GetY() == y
 				&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
 				&& trigger.has_value()
 				&& triggers[*trigger]) {
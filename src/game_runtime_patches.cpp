@@ -246,6 +246,7 @@ bool RuntimePatches::EncounterRandomnessAlert::HandleEncounter(int troop_id) {
 			Game_Map::SetNeedRefreshForSwitchChange(switch_id);
 		}
 		// Always refresh the map (Original patch does this only for the MEPR variant)
+		Game_Map::SetNeedRefresh(true);
 		Game_Map::Refresh();
 		return true;
 	}
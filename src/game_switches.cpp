@@ -21,6 +21,74 @@
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
 
+namespace {
+	using Word = uint64_t;
+	constexpr int kWordBits = 64;
+	constexpr Word kAllBits = ~Word(0);
+
+	/**
+	 * Calls op(word, mask) for every word overlapping the bits [begin, end).
+	 * The words between the first and the last are passed with all bits set
+	 * so the compiler can vectorize the loop.
+	 */
+	template <typename T, typename F>
+	void ForEachWord(T& words, int begin, int end, F&& op) {
+		if (begin >= end) {
+			return;
+		}
+		const int first_word = begin / kWordBits;
+		const int last_word = (end - 1) / kWordBits;
+		const Word first_mask = kAllBits << (begin % kWordBits);
+		const Word last_mask = kAllBits >> (kWordBits - 1 - (end - 1) % kWordBits);
+
+		if (first_word == last_word) {
+			op(words[first_word], first_mask & last_mask);
+			return;
+		}
+		op(words[first_word], first_mask);
+		for (int i = first_word + 1; i < last_word; ++i) {
+			op(words[i], kAllBits);
+		}
+		op(words[last_word], last_mask);
+	}
+
+	int PopCount(Word w) {
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountll(w);
+#else
+		int count = 0;
+		for (; w != 0; w &= w - 1) {
+			++count;
+		}
+		return count;
+#endif
+	}
+}
+
+void Game_Switches::SetData(const Switches_t& s) {
+	_size = static_cast<int>(s.size());
+	_words.assign((_size + kWordBits - 1) / kWordBits, 0);
+	for (int i = 0; i < _size; ++i) {
+		if (s[i]) {
+			_words[i / kWordBits] |= Word(1) << (i % kWordBits);
+		}
+	}
+}
+
+Game_Switches::Switches_t Game_Switches::GetData() const {
+	Switches_t s(_size);
+	for (int i = 0; i < _size; ++i) {
+		s[i] = (_words[i / kWordBits] >> (i % kWordBits)) & 1;
+	}
+	return s;
+}
+
+void Game_Switches::Resize(int size) {
+	// Bits beyond _size are 0, so growing only needs new zeroed words
+	_words.resize((size + kWordBits - 1) / kWordBits, 0);
+	_size = size;
+}
+
 void Game_Switches::WarnGet(int variable_id) const {
 	Output::Debug("Invalid read sw[{}]!", variable_id);
 	--_warnings;
@@ -34,11 +102,16 @@ bool Game_Switches::Set(int switch_id, bool value) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
+	if (switch_id > _size) {
+		Resize(switch_id);
+	}
+	const int bit = switch_id - 1;
+	const Word mask = Word(1) << (bit % kWordBits);
+	if (value) {
+		_words[bit / kWordBits] |= mask;
+	} else {
+		_words[bit / kWordBits] &= ~mask;
 	}
-	ss[switch_id - 1] = value;
 	return value;
 }
 
@@ -47,12 +120,13 @@ void Game_Switches::SetRange(int first_id, int last_id, bool value) {
 		Output::Debug("Invalid write sw[{},{}] = {}!", first_id, last_id, value);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id, false);
+	if (last_id > _size) {
+		Resize(last_id);
 	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i] = value;
+	if (value) {
+		ForEachWord(_words, std::max(0, first_id - 1), last_id, [](Word& w, Word mask) { w |= mask; });
+	} else {
+		ForEachWord(_words, std::max(0, first_id - 1), last_id, [](Word& w, Word mask) { w &= ~mask; });
 	}
 }
 
@@ -64,12 +138,13 @@ bool Game_Switches::Flip(int switch_id) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
+	if (switch_id > _size) {
+		Resize(switch_id);
 	}
-	ss[switch_id - 1].flip();
-	return ss[switch_id - 1];
+	const int bit = switch_id - 1;
+	auto& w = _words[bit / kWordBits];
+	w ^= Word(1) << (bit % kWordBits);
+	return (w >> (bit % kWordBits)) & 1;
 }
 
 void Game_Switches::FlipRange(int first_id, int last_id) {
@@ -77,13 +152,18 @@ void Game_Switches::FlipRange(int first_id, int last_id) {
 		Output::Debug("Invalid flip sw[{},{}]!", first_id, last_id);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i].flip();
+	if (last_id > _size) {
+		Resize(last_id);
 	}
+	ForEachWord(_words, std::max(0, first_id - 1), last_id, [](Word& w, Word mask) { w ^= mask; });
+}
+
+int Game_Switches::CountRange(int first_id, int last_id) const {
+	int count = 0;
+	ForEachWord(_words, std::max(0, first_id - 1), std::min(last_id, _size), [&count](Word w, Word mask) {
+		count += PopCount(w & mask);
+	});
+	return count;
 }
 
 std::string_view Game_Switches::GetName(int _id) const {
@@ -158,7 +158,7 @@ bool Game_System::BgmPlayedOnce() {
 	return false;
 }
 
-void Game_System::SePlay(const lcf::rpg::Sound& se, bool stop_sounds) {
+void Game_System::SePlay(const lcf::rpg::Sound& se, bool stop_sounds, int tag) {
 	if (se.name.empty()) {
 		return;
 	} else if (se.name == "(OFF)") {
@@ -199,7 +199,7 @@ void Game_System::SePlay(const lcf::rpg::Sound& se, bool stop_sounds) {
 	se_adj.volume = volume;
 	se_adj.tempo = tempo;
 	se_adj.balance = balance;
-	se_request_ids[se.name] = request->Bind(&Game_System::OnSeReady, this, se_adj, stop_sounds);
+	se_request_ids[se.name] = request->Bind(&Game_System::OnSeReady, this, se_adj, stop_sounds, tag);
 	if (EndsWith(se.name, ".script")) {
 		// Is a Ineluki Script File
 		request->SetImportantFile(true);
@@ -575,7 +575,7 @@ void Game_System::OnBgmInelukiReady(FileRequestResult* result) {
 	Audio().BGM_Play(FileFinder::Game().OpenFile(result->file), data.current_music.volume, data.current_music.tempo, data.current_music.fadein, data.current_music.balance);
 }
 
-void Game_System::OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool stop_sounds) {
+void Game_System::OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool stop_sounds, int tag) {
 	auto item = se_request_ids.find(result->file);
 	if (item != se_request_ids.end()) {
 		se_request_ids.erase(item);
@@ -619,7 +619,11 @@ void Game_System::OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool
 		return;
 	}
 
-	Audio().SE_Play(std::move(se_cache), se.volume, se.tempo, se.balance);
+	if (tag > 0) {
+		Audio().SE_PlayTagged(std::move(se_cache), se.volume, se.tempo, se.balance, tag);
+	} else {
+		Audio().SE_Play(std::move(se_cache), se.volume, se.tempo, se.balance);
+	}
 }
 
 void Game_System::OnSeInelukiReady(FileRequestResult* result, lcf::rpg::Sound se) {
@@ -125,8 +125,9 @@ public:
 	 *
 	 * @param se sound data.
 	 * @param stop_sounds If true stops all SEs when playing (OFF)/(...). Only used by the interpreter.
+	 * @param tag When larger than 0 the SE is played through AudioInterface::SE_PlayTagged
 	 */
-	void SePlay(const lcf::rpg::Sound& se, bool stop_sounds = false);
+	void SePlay(const lcf::rpg::Sound& se, bool stop_sounds = false, int tag = 0);
 
 	/**
 	 * Plays the first valid sound in the animation.
@@ -441,7 +442,7 @@ private:
 
 	void OnBgmReady(FileRequestResult* result);
 	void OnBgmInelukiReady(FileRequestResult* result);
-	void OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool stop_sounds);
+	void OnSeReady(FileRequestResult* result, lcf::rpg::Sound se, bool stop_sounds, int tag);
 	void OnSeInelukiReady(FileRequestResult* result, lcf::rpg::Sound se);
 	void OnChangeSystemGraphicReady(FileRequestResult* result);
 private:
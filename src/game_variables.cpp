@@ -128,6 +128,60 @@ constexpr Var_t VarBitShiftRight(Var_t n, Var_t d) {
 	return n >> d;
 };
 
+// Branch free variants of the operations for the range and array functions.
+// They saturate like the operations above but without branches on the
+// operands, so the loops over contiguous variables are vectorized by the
+// compiler. They are lambdas so every operation gets its own inlined loop.
+constexpr auto BulkSet = [](Var_t o, Var_t n) {
+	(void)o;
+	return n;
+};
+
+constexpr auto BulkAdd = [](Var_t l, Var_t r) {
+	const Var_t res = static_cast<Var_t>(static_cast<uint32_t>(l) + static_cast<uint32_t>(r));
+	// On overflow both operands have the sign of the saturated value
+	const Var_t sat = (l >> 31) ^ std::numeric_limits<Var_t>::max();
+	return ((l ^ res) & (r ^ res)) < 0 ? sat : res;
+};
+
+constexpr auto BulkSub = [](Var_t l, Var_t r) {
+	const Var_t res = static_cast<Var_t>(static_cast<uint32_t>(l) - static_cast<uint32_t>(r));
+	const Var_t sat = (l >> 31) ^ std::numeric_limits<Var_t>::max();
+	return ((l ^ r) & (l ^ res)) < 0 ? sat : res;
+};
+
+constexpr auto BulkMult = [](Var_t l, Var_t r) {
+	const int64_t res = static_cast<int64_t>(l) * r;
+	return static_cast<Var_t>(std::min<int64_t>(std::max<int64_t>(res, std::numeric_limits<Var_t>::min()), std::numeric_limits<Var_t>::max()));
+};
+
+constexpr auto BulkDiv = [](Var_t n, Var_t d) {
+	return VarDiv(n, d);
+};
+
+constexpr auto BulkMod = [](Var_t n, Var_t d) {
+	return VarMod(n, d);
+};
+
+constexpr auto BulkBitOr = [](Var_t n, Var_t d) {
+	return n | d;
+};
+
+constexpr auto BulkBitAnd = [](Var_t n, Var_t d) {
+	return n & d;
+};
+
+constexpr auto BulkBitXor = [](Var_t n, Var_t d) {
+	return n ^ d;
+};
+
+constexpr auto BulkBitShiftLeft = [](Var_t n, Var_t d) {
+	return VarBitShiftLeft(n, d);
+};
+
+constexpr auto BulkBitShiftRight = [](Var_t n, Var_t d) {
+	return VarBitShiftRight(n, d);
+};
 }
 
 Game_Variables::Game_Variables(Var_t minval, Var_t maxval)
@@ -198,14 +252,29 @@ void Game_Variables::WriteRange(const int first_id, const int last_id, V&& value
 	}
 }
 
+template <typename F>
+void Game_Variables::WriteRangeConst(const int first_id, const int last_id, const Var_t value, F&& op) {
+	// PrepareRange ensured that the range is allocated.
+	// The limits are copied because the stores could alias them.
+	Var_t* vv = _variables.data();
+	const Var_t min = _min;
+	const Var_t max = _max;
+	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
+		vv[i] = Utils::Clamp(op(vv[i], value), min, max);
+	}
+}
+
 template <typename F>
 void Game_Variables::WriteArray(const int first_id_a, const int last_id_a, const int first_id_b, F&& op) {
-	auto& vv = _variables;
-	int out_b = std::max(0, first_id_b - 1);
-	for (int i = std::max(0, first_id_a - 1); i < last_id_a; ++i) {
-		auto& v_a = vv[i];
-		auto v_b = vv[out_b++];
-		v_a = Utils::Clamp(op(v_a, v_b), _min, _max);
+	// PrepareArray ensured that both ranges are allocated.
+	// The compiler checks at runtime whether the ranges overlap before using the vectorized loop.
+	Var_t* vv = _variables.data();
+	const Var_t min = _min;
+	const Var_t max = _max;
+	const int begin_a = std::max(0, first_id_a - 1);
+	const int offset_b = std::max(0, first_id_b - 1) - begin_a;
+	for (int i = begin_a; i < last_id_a; ++i) {
+		vv[i] = Utils::Clamp(op(vv[i], vv[i + offset_b]), min, max);
 	}
 }
 
@@ -264,179 +333,199 @@ Game_Variables::Var_t Game_Variables::BitShiftRight(int variable_id, Var_t value
 
 void Game_Variables::SetRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSet);
+	WriteRangeConst(first_id, last_id, value, BulkSet);
 }
 
 void Game_Variables::AddRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarAdd);
+	WriteRangeConst(first_id, last_id, value, BulkAdd);
 }
 
 void Game_Variables::SubRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSub);
+	WriteRangeConst(first_id, last_id, value, BulkSub);
 }
 
 void Game_Variables::MultRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMult);
+	WriteRangeConst(first_id, last_id, value, BulkMult);
 }
 
 void Game_Variables::DivRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarDiv);
+	WriteRangeConst(first_id, last_id, value, BulkDiv);
 }
 
 void Game_Variables::ModRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] %= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMod);
+	WriteRangeConst(first_id, last_id, value, BulkMod);
 }
 
 void Game_Variables::BitOrRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] |= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitOr);
+	WriteRangeConst(first_id, last_id, value, BulkBitOr);
 }
 
 void Game_Variables::BitAndRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] &= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitAnd);
+	WriteRangeConst(first_id, last_id, value, BulkBitAnd);
 }
 
 void Game_Variables::BitXorRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] ^= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitXor);
+	WriteRangeConst(first_id, last_id, value, BulkBitXor);
 }
 
 void Game_Variables::BitShiftLeftRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] <<= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitShiftLeft);
+	WriteRangeConst(first_id, last_id, value, BulkBitShiftLeft);
 }
 
 void Game_Variables::BitShiftRightRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] >>= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitShiftRight);
+	WriteRangeConst(first_id, last_id, value, BulkBitShiftRight);
 }
 
 template <typename F>
 void Game_Variables::WriteRangeVariable(int first_id, const int last_id, const int var_id, F&& op) {
 	if (var_id >= first_id && var_id <= last_id) {
 		auto value = Get(var_id);
-		WriteRange(first_id, var_id, [value](){ return value; }, std::forward<F>(op));
+		WriteRangeConst(first_id, var_id, value, op);
 		first_id = var_id + 1;
 	}
 	auto value = Get(var_id);
-	WriteRange(first_id, last_id, [value](){ return value; }, std::forward<F>(op));
+	WriteRangeConst(first_id, last_id, value, op);
+}
+
+template <typename F>
+void Game_Variables::WriteRangeVariableIndirect(int first_id, const int last_id, const int var_id, F&& op) {
+	// The operand only changes after var_id or the variable it points to was written.
+	// Split the range at these variables and write the parts with a constant operand.
+	first_id = std::max(1, first_id);
+	while (first_id <= last_id) {
+		const int target_id = Get(var_id);
+		const auto value = Get(target_id);
+		int split_id = last_id;
+		if (var_id >= first_id && var_id < split_id) {
+			split_id = var_id;
+		}
+		if (target_id >= first_id && target_id < split_id) {
+			split_id = target_id;
+		}
+		WriteRangeConst(first_id, split_id, value, op);
+		first_id = split_id + 1;
+	}
 }
 
 
 void Game_Variables::SetRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = Var({})!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSet);
+	WriteRangeVariable(first_id, last_id, var_id, BulkSet);
 }
 
 void Game_Variables::AddRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarAdd);
+	WriteRangeVariable(first_id, last_id, var_id, BulkAdd);
 }
 
 void Game_Variables::SubRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSub);
+	WriteRangeVariable(first_id, last_id, var_id, BulkSub);
 }
 
 void Game_Variables::MultRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMult);
+	WriteRangeVariable(first_id, last_id, var_id, BulkMult);
 }
 
 void Game_Variables::DivRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarDiv);
+	WriteRangeVariable(first_id, last_id, var_id, BulkDiv);
 }
 
 void Game_Variables::ModRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMod);
+	WriteRangeVariable(first_id, last_id, var_id, BulkMod);
 }
 
 void Game_Variables::BitOrRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] |= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitOr);
+	WriteRangeVariable(first_id, last_id, var_id, BulkBitOr);
 }
 
 void Game_Variables::BitAndRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] &= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitAnd);
+	WriteRangeVariable(first_id, last_id, var_id, BulkBitAnd);
 }
 
 void Game_Variables::BitXorRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] ^= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitXor);
+	WriteRangeVariable(first_id, last_id, var_id, BulkBitXor);
 }
 
 void Game_Variables::BitShiftLeftRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] <<= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitShiftLeft);
+	WriteRangeVariable(first_id, last_id, var_id, BulkBitShiftLeft);
 }
 
 void Game_Variables::BitShiftRightRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] >>= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitShiftRight);
+	WriteRangeVariable(first_id, last_id, var_id, BulkBitShiftRight);
 }
 
 void Game_Variables::SetRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarSet);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkSet);
 }
 
 void Game_Variables::AddRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarAdd);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkAdd);
 }
 
 void Game_Variables::SubRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarSub);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkSub);
 }
 
 void Game_Variables::MultRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarMult);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkMult);
 }
 
 void Game_Variables::DivRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarDiv);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkDiv);
 }
 
 void Game_Variables::ModRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] %= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarMod);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkMod);
 }
 
 void Game_Variables::BitOrRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] |= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarBitOr);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkBitOr);
 }
 
 void Game_Variables::BitAndRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] &= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarBitAnd);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkBitAnd);
 }
 
 void Game_Variables::BitXorRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] ^= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarBitXor);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkBitXor);
 }
 
 void Game_Variables::BitShiftLeftRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] <<= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarBitShiftLeft);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkBitShiftLeft);
 }
 
 void Game_Variables::BitShiftRightRangeVariableIndirect(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] >>= var[var[{}]]!", var_id);
-	WriteRange(first_id, last_id, [this,var_id](){ return Get(Get(var_id)); }, VarBitShiftRight);
+	WriteRangeVariableIndirect(first_id, last_id, var_id, BulkBitShiftRight);
 }
 
 void Game_Variables::SetRangeRandom(int first_id, int last_id, Var_t minval, Var_t maxval) {
@@ -530,7 +619,7 @@ void Game_Variables::SetArray(int first_id_a, int last_id_a, int first_id_b) {
 	// Maniac Patch uses memcpy which is actually a memmove
 	// This ensures overlapping areas are copied properly
 	if (first_id_a < first_id_b) {
-		WriteArray(first_id_a, last_id_a, first_id_b, VarSet);
+		WriteArray(first_id_a, last_id_a, first_id_b, BulkSet);
 	} else {
 		auto& vv = _variables;
 		const int steps = std::max(0, last_id_a - first_id_a + 1);
@@ -546,52 +635,52 @@ void Game_Variables::SetArray(int first_id_a, int last_id_a, int first_id_b) {
 
 void Game_Variables::AddArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] += var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarAdd);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkAdd);
 }
 
 void Game_Variables::SubArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] -= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarSub);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkSub);
 }
 
 void Game_Variables::MultArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] *= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarMult);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkMult);
 }
 
 void Game_Variables::DivArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] /= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarDiv);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkDiv);
 }
 
 void Game_Variables::ModArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] %= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarMod);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkMod);
 }
 
 void Game_Variables::BitOrArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] |= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarBitOr);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkBitOr);
 }
 
 void Game_Variables::BitAndArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] &= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarBitAnd);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkBitAnd);
 }
 
 void Game_Variables::BitXorArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] ^= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarBitXor);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkBitXor);
 }
 
 void Game_Variables::BitShiftLeftArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] <<= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarBitShiftLeft);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkBitShiftLeft);
 }
 
 void Game_Variables::BitShiftRightArray(int first_id_a, int last_id_a, int first_id_b) {
 	PrepareArray(first_id_a, last_id_a, first_id_b, "Invalid write var[{},{}] >>= var[{},{}]!");
-	WriteArray(first_id_a, last_id_a, first_id_b, VarBitShiftRight);
+	WriteArray(first_id_a, last_id_a, first_id_b, BulkBitShiftRight);
 }
 
 void Game_Variables::SwapArray(int first_id_a, int last_id_a, int first_id_b) {
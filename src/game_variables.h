@@ -152,8 +152,12 @@ private:
 		void PrepareArray(const int first_id_a, const int last_id_a, const int first_id_b, const char* warn, Args... args);
 	template <typename V, typename F>
 		void WriteRange(const int first_id, const int last_id, V&& value, F&& op);
+	template <typename F>
+		void WriteRangeConst(const int first_id, const int last_id, const Var_t value, F&& op);
 	template <typename F>
 		void WriteRangeVariable(const int first_id, const int last_id, int var_id, F&& op);
+	template <typename F>
+		void WriteRangeVariableIndirect(const int first_id, const int last_id, int var_id, F&& op);
 	template <typename F>
 		void WriteArray(const int first_id_a, const int last_id_a, const int first_id_b, F&& op);
 
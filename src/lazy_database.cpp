@@ -0,0 +1,196 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "lazy_database.h"
+#include "output.h"
+#include <lcf/data.h>
+#include <lcf/ldb/reader.h>
+#include <lcf/reader_lcf.h>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <sstream>
+
+namespace {
+	constexpr std::string_view ldb_header = "LcfDataBase";
+
+	// Chunk ids of lcf::rpg::Database
+	constexpr uint32_t chunk_troops = 0x0F;
+	constexpr uint32_t chunk_animations = 0x13;
+	constexpr uint32_t chunk_commonevents = 0x19;
+	constexpr uint32_t chunk_battleranimations = 0x20;
+
+	constexpr int num_sections = static_cast<int>(LazyDatabase::Section::LAST);
+
+	constexpr std::array<const char*, num_sections> section_names = {
+		"CommonEvents",
+		"Animations",
+		"Battle"
+	};
+
+	/** Header of the loaded database file */
+	std::string header;
+	std::string encoding;
+	/** Raw chunks of every deferred section */
+	std::array<std::string, num_sections> pending;
+
+	bool ReadBer(std::string_view data, size_t& pos, uint32_t& value) {
+		value = 0;
+		for (int i = 0; i < 5 && pos < data.size(); ++i) {
+			const auto byte = static_cast<uint8_t>(data[pos++]);
+			value = (value << 7) | (byte & 0x7F);
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int GetSection(uint32_t chunk_id) {
+		switch (chunk_id) {
+			case chunk_commonevents:
+				return static_cast<int>(LazyDatabase::Section::CommonEvents);
+			case chunk_animations:
+				return static_cast<int>(LazyDatabase::Section::Animations);
+			case chunk_troops:
+			case chunk_battleranimations:
+				return static_cast<int>(LazyDatabase::Section::Battle);
+			default:
+				return -1;
+		}
+	}
+}
+
+std::vector<LazyDatabase::Chunk> LazyDatabase::ScanChunks(std::string_view ldb) {
+	size_t pos = 0;
+	uint32_t header_size;
+	if (!ReadBer(ldb, pos, header_size) || ldb.substr(pos, header_size) != ldb_header) {
+		return {};
+	}
+	pos += header_size;
+
+	std::vector<Chunk> chunks;
+	while (pos < ldb.size()) {
+		Chunk chunk;
+		chunk.offset = pos;
+		if (!ReadBer(ldb, pos, chunk.id)) {
+			return {};
+		}
+		if (chunk.id == 0) {
+			break;
+		}
+
+		uint32_t size;
+		if (!ReadBer(ldb, pos, size) || size > ldb.size() - pos) {
+			return {};
+		}
+		pos += size;
+		chunk.size = pos - chunk.offset;
+		chunks.push_back(chunk);
+	}
+	return chunks;
+}
+
+std::unique_ptr<lcf::rpg::Database> LazyDatabase::Load(std::istream& is, std::string_view db_encoding) {
+	Clear();
+
+	std::string data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	const auto chunks = ScanChunks(data);
+	if (chunks.empty()) {
+		// Not a database or corrupted, let liblcf report the error
+		std::istringstream ss(std::move(data));
+		return lcf::LDB_Reader::Load(ss, db_encoding);
+	}
+
+	header = data.substr(0, chunks.front().offset);
+	encoding = ToString(db_encoding);
+
+	std::string eager = header;
+	for (const auto& chunk: chunks) {
+		const int section = GetSection(chunk.id);
+		auto& out = section >= 0 ? pending[section] : eager;
+		out.append(data, chunk.offset, chunk.size);
+	}
+	eager.push_back('\0');
+
+	std::istringstream ss(std::move(eager));
+	auto db = lcf::LDB_Reader::Load(ss, encoding);
+	if (!db) {
+		Clear();
+	}
+	return db;
+}
+
+bool LazyDatabase::IsPending(Section section) {
+	return !pending[static_cast<int>(section)].empty();
+}
+
+bool LazyDatabase::HasPendingSections() {
+	return std::any_of(pending.begin(), pending.end(), [](const auto& p) { return !p.empty(); });
+}
+
+void LazyDatabase::LoadSection(Section section) {
+	auto& chunks = pending[static_cast<int>(section)];
+	if (chunks.empty()) {
+		return;
+	}
+
+	// A database containing only the chunks of the section
+	std::string data = header;
+	data += chunks;
+	data.push_back('\0');
+	chunks = {};
+
+	std::istringstream ss(std::move(data));
+	auto db = lcf::LDB_Reader::Load(ss, encoding);
+	if (!db) {
+		Output::Warning("Failed loading database section {}: {}", section_names[static_cast<int>(section)], lcf::LcfReader::GetError());
+		return;
+	}
+
+	switch (section) {
+		case Section::CommonEvents:
+			lcf::Data::commonevents = std::move(db->commonevents);
+			break;
+		case Section::Animations:
+			lcf::Data::animations = std::move(db->animations);
+			break;
+		case Section::Battle:
+			lcf::Data::troops = std::move(db->troops);
+			lcf::Data::battleranimations = std::move(db->battleranimations);
+			break;
+		default:
+			break;
+	}
+
+	Output::Debug("Loaded database section {}", section_names[static_cast<int>(section)]);
+}
+
+void LazyDatabase::LoadPendingSections() {
+	for (int i = 0; i < num_sections; ++i) {
+		LoadSection(static_cast<Section>(i));
+	}
+}
+
+void LazyDatabase::Clear() {
+	header.clear();
+	encoding.clear();
+	for (auto& p: pending) {
+		p = {};
+	}
+}
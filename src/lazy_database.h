@@ -0,0 +1,100 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_LAZY_DATABASE_H
+#define EP_LAZY_DATABASE_H
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "string_view.h"
+#include <lcf/rpg/database.h>
+
+/**
+ * Loads a RPG_RT.ldb without parsing its largest sections.
+ *
+ * The top-level chunks of the database are indexed first. The chunks of
+ * the deferred sections are kept as raw data and all others are parsed.
+ * A deferred section is parsed into lcf::Data when it is loaded.
+ */
+namespace LazyDatabase {
+	/** Sections of the database that are parsed on demand */
+	enum class Section {
+		/** Common events and their command lists */
+		CommonEvents,
+		/** Battle animations */
+		Animations,
+		/** Troops and 2k3 battler animations */
+		Battle,
+		LAST
+	};
+
+	/** A top-level chunk of a database file */
+	struct Chunk {
+		uint32_t id = 0;
+		/** Offset of the chunk header in the file */
+		size_t offset = 0;
+		/** Size of the chunk including its header */
+		size_t size = 0;
+	};
+
+	/**
+	 * Indexes the top-level chunks of a database file.
+	 *
+	 * @param ldb content of the database file
+	 * @return chunks in file order, empty when ldb is not a valid database
+	 */
+	std::vector<Chunk> ScanChunks(std::string_view ldb);
+
+	/**
+	 * Parses a database without its deferred sections.
+	 * Replaces the deferred sections of a previously loaded database.
+	 *
+	 * @param is database file
+	 * @param encoding encoding of the database
+	 * @return database, nullptr on error
+	 */
+	std::unique_ptr<lcf::rpg::Database> Load(std::istream& is, std::string_view encoding = "");
+
+	/**
+	 * @param section section to check
+	 * @return whether the section was not parsed yet
+	 */
+	bool IsPending(Section section);
+
+	/** @return whether any section was not parsed yet */
+	bool HasPendingSections();
+
+	/**
+	 * Parses a deferred section into lcf::Data.
+	 * Does nothing when the section is not pending.
+	 *
+	 * @param section section to load
+	 */
+	void LoadSection(Section section);
+
+	/** Parses all deferred sections into lcf::Data */
+	void LoadPendingSections();
+
+	/** Drops all deferred sections */
+	void Clear();
+}
+
+#endif
@@ -33,6 +33,10 @@
 #include <lcf/reader_lcf.h>
 #include <lcf/reader_util.h>
 #include <lcf/writer_lcf.h>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -177,6 +181,229 @@ struct ProcessAssignmentRet {
 	}
 };
 
+namespace {
+	int32_t SaturatingCast(int64_t value) {
+		return static_cast<int32_t>(Utils::Clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	}
+
+	bool IsUnary(Op op) {
+		return op == Op::Negate || op == Op::Not || op == Op::Flip;
+	}
+
+	bool IsBinary(Op op) {
+		return op >= Op::Add && op <= Op::And;
+	}
+
+	bool IsInplace(Op op) {
+		return op >= Op::AssignInplace && op <= Op::BitShiftRightInplace;
+	}
+
+	int ApplyUnary(Op op, int imm) {
+		switch (op) {
+			case Op::Negate:
+				return -imm;
+			case Op::Not:
+				return !imm ? 0 : 1;
+			case Op::Flip:
+				return ~imm;
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	int ApplyBinary(Op op, int imm, int imm2) {
+		switch (op) {
+			case Op::Add:
+				return SaturatingCast(static_cast<int64_t>(imm) + imm2);
+			case Op::Sub:
+				return SaturatingCast(static_cast<int64_t>(imm) - imm2);
+			case Op::Mul:
+				return SaturatingCast(static_cast<int64_t>(imm) * imm2);
+			case Op::Div:
+				if (imm2 == 0) {
+					return imm;
+				}
+				// Saturates INT_MIN / -1 instead of trapping
+				return SaturatingCast(static_cast<int64_t>(imm) / imm2);
+			case Op::Mod:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return static_cast<int32_t>(static_cast<int64_t>(imm) % imm2);
+			case Op::BitOr:
+				return imm | imm2;
+			case Op::BitAnd:
+				return imm & imm2;
+			case Op::BitXor:
+				return imm ^ imm2;
+			case Op::BitShiftLeft:
+				return imm << imm2;
+			case Op::BitShiftRight:
+				return imm >> imm2;
+			case Op::Equal:
+				return imm == imm2 ? 1 : 0;
+			case Op::GreaterEqual:
+				return imm >= imm2 ? 1 : 0;
+			case Op::LessEqual:
+				return imm <= imm2 ? 1 : 0;
+			case Op::Greater:
+				return imm > imm2 ? 1 : 0;
+			case Op::Less:
+				return imm < imm2 ? 1 : 0;
+			case Op::NotEqual:
+				return imm != imm2 ? 1 : 0;
+			case Op::Or:
+				return !!imm || !!imm2 ? 1 : 0;
+			case Op::And:
+				return !!imm && !!imm2 ? 1 : 0;
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	int ApplyInplace(Op op, const ProcessAssignmentRet& ret, int imm2) {
+		switch (op) {
+			case Op::AssignInplace:
+				return ret.assign(imm2);
+			case Op::AddInplace:
+				return ret.assign(SaturatingCast(static_cast<int64_t>(ret.fetch()) + imm2));
+			case Op::SubInplace:
+				return ret.assign(SaturatingCast(static_cast<int64_t>(ret.fetch()) - imm2));
+			case Op::MulInplace:
+				return ret.assign(SaturatingCast(static_cast<int64_t>(ret.fetch()) * imm2));
+			case Op::DivInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(SaturatingCast(static_cast<int64_t>(ret.fetch()) / imm2));
+			case Op::ModInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(static_cast<int32_t>(static_cast<int64_t>(ret.fetch()) % imm2));
+			case Op::BitOrInplace:
+				return ret.assign(ret.fetch() | imm2);
+			case Op::BitAndInplace:
+				return ret.assign(ret.fetch() & imm2);
+			case Op::BitXorInplace:
+				return ret.assign(ret.fetch() ^ imm2);
+			case Op::BitShiftLeftInplace:
+				return ret.assign(ret.fetch() << imm2);
+			case Op::BitShiftRightInplace:
+				return ret.assign(ret.fetch() >> imm2);
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	struct FunctionInfo {
+		const char* name;
+		int num_args;
+	};
+
+	// Indexed by Fn
+	constexpr FunctionInfo function_info[] = {
+		{ "rnd", 2 },
+		{ "item", 2 },
+		{ "event", 2 },
+		{ "actor", 2 },
+		{ "member", 2 },
+		{ "enemy", 2 },
+		{ "misc", 1 },
+		{ "pow", 2 },
+		{ "sqrt", 2 },
+		{ "sin", 3 },
+		{ "cos", 3 },
+		{ "atan2", 3 },
+		{ "min", 2 },
+		{ "max", 2 },
+		{ "abs", 1 },
+		{ "clamp", 3 },
+		{ "muldiv", 3 },
+		{ "divmul", 3 },
+		{ "between", 3 }
+	};
+
+	constexpr int max_function_args = 3;
+
+	const FunctionInfo* GetFunctionInfo(int fn) {
+		if (fn < 0 || fn >= static_cast<int>(std::size(function_info))) {
+			return nullptr;
+		}
+		return &function_info[fn];
+	}
+
+	/** Pure functions only depend on their arguments and can be constant folded */
+	bool IsPureFunction(Fn fn) {
+		return fn >= Fn::Pow;
+	}
+
+	/**
+	 * Calls an expression function.
+	 * The arguments are encoded in reverse order, args[0] is the last parameter.
+	 */
+	int CallFunction(Fn fn, const int* args, const Game_BaseInterpreterContext& ip) {
+		switch (fn) {
+			case Fn::Rand:
+				return ControlVariables::Random(args[1], args[0]);
+			case Fn::Item:
+				return ControlVariables::Item(args[1], args[0]);
+			case Fn::Event:
+				return ControlVariables::Event(args[1], args[0], ip);
+			case Fn::Actor:
+				return ControlVariables::Actor(args[1], args[0]);
+			case Fn::Party:
+				return ControlVariables::Party(args[1], args[0]);
+			case Fn::Enemy:
+				return ControlVariables::Enemy(args[1], args[0]);
+			case Fn::Misc:
+				return ControlVariables::Other(args[0]);
+			case Fn::Pow:
+				return ControlVariables::Pow(args[1], args[0]);
+			case Fn::Sqrt:
+				return ControlVariables::Sqrt(args[1], args[0]);
+			case Fn::Sin:
+				return ControlVariables::Sin(args[2], args[1], args[0]);
+			case Fn::Cos:
+				return ControlVariables::Cos(args[2], args[1], args[0]);
+			case Fn::Atan2:
+				return ControlVariables::Atan2(args[2], args[1], args[0]);
+			case Fn::Min:
+				return ControlVariables::Min(args[1], args[0]);
+			case Fn::Max:
+				return ControlVariables::Max(args[1], args[0]);
+			case Fn::Abs:
+				return ControlVariables::Abs(args[0]);
+			case Fn::Clamp:
+				return ControlVariables::Clamp(args[2], args[1], args[0]);
+			case Fn::Muldiv:
+				return ControlVariables::Muldiv(args[2], args[1], args[0]);
+			case Fn::Divmul:
+				return ControlVariables::Divmul(args[2], args[1], args[0]);
+			case Fn::Between:
+				return ControlVariables::Between(args[2], args[1], args[0]);
+		}
+		assert(false);
+		return 0;
+	}
+
+	std::vector<int32_t> DecodeOpCodes(Span<const int32_t> op_codes) {
+		std::vector<int32_t> ops;
+		ops.reserve(op_codes.size() * 4);
+		for (auto &o: op_codes) {
+			auto uo = static_cast<uint32_t>(o);
+			ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
+			ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
+			ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
+			ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+		}
+		return ops;
+	}
+}
+
 ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip);
 
 int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
@@ -192,18 +419,42 @@ int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 	auto op = static_cast<Op>(*it);
 	++it;
 
+	// Malformed expressions can end in the middle of an operation
+	auto next = [&]() {
+		return it != end ? *it++ : 0;
+	};
+
+	if (IsUnary(op)) {
+		imm = Process(it, end, ip);
+		return ApplyUnary(op, imm);
+	}
+
+	if (IsBinary(op)) {
+		imm = Process(it, end, ip);
+		imm2 = Process(it, end, ip);
+		return ApplyBinary(op, imm, imm2);
+	}
+
+	if (IsInplace(op)) {
+		auto ret = ProcessAssignment(it, end, ip);
+		imm2 = Process(it, end, ip);
+		return ApplyInplace(op, ret, imm2);
+	}
+
 	// When entering the switch it is on the first argument
 	switch (op) {
 		case Op::Null:
-			it++;
+			if (it != end) {
+				++it;
+			}
 			return 0;
 		case Op::U8:
 		case Op::UX8:
-			value = *it++;
+			value = next();
 			return value;
 		case Op::U16:
 		case Op::UX16:
-			imm = *it++;
+			imm = next();
 			if (it == end) {
 				return 0;
 			}
@@ -212,7 +463,7 @@ int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 			return value;
 		case Op::S32:
 		case Op::SX32:
-			imm = *it++;
+			imm = next();
 			if (it == end) {
 				return 0;
 			}
@@ -239,162 +490,14 @@ int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 		case Op::SwitchIndirect:
 			imm = Process(it, end, ip);
 			return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(imm));
-		case Op::Negate:
-			imm = Process(it, end, ip);
-			return -imm;
-		case Op::Not:
-			imm = Process(it, end, ip);
-			return !imm ? 0 : 1;
-		case Op::Flip:
-			imm = Process(it, end, ip);
-			return ~imm;
-		case Op::AssignInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(imm2);
-		}
-		case Op::AddInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::SubInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::MulInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::DivInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() / imm2);
-		}
-		case Op::ModInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() % imm2);
-		}
-		case Op::BitOrInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() | imm2);
-		}
-		case Op::BitAndInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() & imm2);
-		}
-		case Op::BitXorInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() ^ imm2);
-		}
-		case Op::BitShiftLeftInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() << imm2);
-		}
-		case Op::BitShiftRightInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() >> imm2);
-		}
-		case Op::Add:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Sub:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Mul:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Div:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
-			}
-			return imm / imm2;
-		case Op::Mod:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
-			}
-			return imm % imm2;
-		case Op::BitOr:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm | imm2;
-		case Op::BitAnd:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm & imm2;
-		case Op::BitXor:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm ^ imm2;
-		case Op::BitShiftLeft:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm << imm2;
-		case Op::BitShiftRight:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >> imm2;
-		case Op::Equal:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm == imm2 ? 1 : 0;
-		case Op::GreaterEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >= imm2 ? 1 : 0;
-		case Op::LessEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm <= imm2 ? 1 : 0;
-		case Op::Greater:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm > imm2 ? 1 : 0;
-		case Op::Less:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm < imm2 ? 1 : 0;
-		case Op::NotEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm != imm2 ? 1 : 0;
-		case Op::Or:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm || !!imm2 ? 1 : 0;
-		case Op::And:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm && !!imm2 ? 1 : 0;
 		case Op::Ternary:
 			imm = Process(it, end, ip);
 			imm2 = Process(it, end, ip);
 			imm3 = Process(it, end, ip);
 			return imm != 0 ? imm2 : imm3;
-		case Op::Function:
-			imm = *it++; // function
-			imm2 = *it++; // arguments
+		case Op::Function: {
+			imm = next(); // function
+			imm2 = next(); // arguments
 
 			if ((imm2 & 0x80) != 0) {
 				// Argument count is 4 bytes, that mode is not supported
@@ -402,135 +505,26 @@ int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator e
 				return 0;
 			}
 
-			switch (static_cast<Fn>(imm)) {
-				case Fn::Rand:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression rnd args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Random(Process(it, end, ip), imm3);
-				case Fn::Item:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression item args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Item(Process(it, end, ip), imm3);
-				case Fn::Event:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression event args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Event(Process(it, end, ip), imm3, ip);
-				case Fn::Actor:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression actor args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Actor(Process(it, end, ip), imm3);
-				case Fn::Party:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression member args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Party(Process(it, end, ip), imm3);
-				case Fn::Enemy:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression enemy args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Enemy(Process(it, end, ip), imm3);
-					break;
-				case Fn::Misc:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression misc args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Other(Process(it, end, ip));
-				case Fn::Pow:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression pow args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Pow(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sqrt:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression sqrt args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Sqrt(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sin:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression sin args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Sin(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Cos:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression cos args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Cos(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Atan2:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression atan2 args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Atan2(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Min:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression min args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Min(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Max:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression max args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Max(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Abs:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression abs args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Abs(Process(it, end, ip));
-				case Fn::Clamp:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression clamp args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Clamp(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Muldiv:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression muldiv args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Muldiv(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Divmul:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression divmul args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Divmul(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Between:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression between args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Between(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				default:
-					Output::Warning("Maniac: Expression Unknown Func {}", imm);
-					for (int i = 0; i < imm2; ++i) {
-						Process(it, end, ip);
-					}
-					return 0;
+			auto* info = GetFunctionInfo(imm);
+			if (!info) {
+				Output::Warning("Maniac: Expression Unknown Func {}", imm);
+				for (int i = 0; i < imm2; ++i) {
+					Process(it, end, ip);
+				}
+				return 0;
 			}
+
+			if (imm2 != info->num_args) {
+				Output::Warning("Maniac: Expression {} args {} != {}", info->name, imm2, info->num_args);
+				return 0;
+			}
+
+			int args[max_function_args];
+			for (int i = 0; i < imm2; ++i) {
+				args[i] = Process(it, end, ip);
+			}
+			return CallFunction(static_cast<Fn>(imm), args, ip);
+		}
 		default:
 			Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
 			return 0;
@@ -563,28 +557,14 @@ ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::
 	}
 }
 
-int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto &o: op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
+int32_t ManiacPatch::InterpretExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	std::vector<int32_t> ops = DecodeOpCodes(op_codes);
 	auto beg = ops.begin();
 	return Process(beg, ops.end(), interpreter);
 }
 
-std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto& o : op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
+std::vector<int32_t> ManiacPatch::InterpretExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	std::vector<int32_t> ops = DecodeOpCodes(op_codes);
 
 	if (ops.empty()) {
 		return {};
@@ -605,6 +585,476 @@ std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes,
 	return results;
 }
 
+/*
+Compiled expressions
+
+The op codes are compiled once into a flat program for a small stack machine.
+Constant subexpressions of pure operations are folded and variable and switch
+reads with a constant id are resolved at compile time. Operations with a
+constant right operand, and the common v[a] <op> c shape, get their own
+instructions.
+
+The program has the same side effects in the same order as Process.
+Warnings about malformed expressions are only reported when compiling.
+*/
+
+namespace {
+	enum class VmOp : uint8_t {
+		Const, // push a
+		Var, // push v[a]
+		Switch, // push s[a]
+		VarDynamic, // v[pop]
+		SwitchDynamic, // s[pop]
+		VarIndirect, // v[v[pop]]
+		SwitchIndirect, // s[v[pop]]
+		Unary, // a: Op
+		Binary, // a: Op
+		BinaryConst, // a: Op, b: right operand
+		VarBinaryConst, // a: Op, b: variable id, c: right operand
+		Ternary,
+		Inplace, // a: Op, b: Op of the target
+		Function, // a: Fn, b: argument count
+		Discard, // a: count, pops count and pushes 0
+		Yield // moves the result to the results of ParseExpressions
+	};
+
+	struct Instruction {
+		VmOp op;
+		int32_t a = 0;
+		int32_t b = 0;
+		int32_t c = 0;
+	};
+
+	struct CompiledExpression {
+		std::vector<int32_t> source;
+		bool multiple = false;
+		std::vector<Instruction> code;
+		int max_depth = 0;
+	};
+
+	class ExpressionCompiler {
+	public:
+		ExpressionCompiler(std::vector<int32_t> ops, std::vector<Instruction>& code, const Game_BaseInterpreterContext& ip)
+			: ops(std::move(ops)), code(code), ip(ip) {}
+
+		void CompileOne() {
+			Compile();
+		}
+
+		void CompileAll() {
+			if (ops.empty()) {
+				return;
+			}
+			while (true) {
+				Compile();
+				Emit({VmOp::Yield});
+				if (pos >= ops.size() || static_cast<Op>(ops[pos]) == Op::Null) {
+					break;
+				}
+			}
+		}
+
+		int GetMaxDepth() const {
+			return max_depth;
+		}
+
+	private:
+		bool AtEnd() const {
+			return pos >= ops.size();
+		}
+
+		int Next() {
+			// Process reads past the end on malformed input, use 0 instead
+			return pos < ops.size() ? ops[pos++] : (++pos, 0);
+		}
+
+		void Emit(Instruction instr) {
+			switch (instr.op) {
+				case VmOp::Const:
+				case VmOp::Var:
+				case VmOp::Switch:
+					++depth;
+					break;
+				case VmOp::Binary:
+				case VmOp::Inplace:
+					--depth;
+					break;
+				case VmOp::Ternary:
+					depth -= 2;
+					break;
+				case VmOp::Function:
+				case VmOp::Discard:
+					depth -= (instr.op == VmOp::Function ? instr.b : instr.a) - 1;
+					break;
+				case VmOp::Yield:
+					--depth;
+					break;
+				default:
+					break;
+			}
+			max_depth = std::max(max_depth, depth);
+			code.push_back(instr);
+		}
+
+		/** @return whether the last count instructions are constants */
+		bool LastAreConst(int count) const {
+			if (static_cast<int>(code.size()) < count) {
+				return false;
+			}
+			return std::all_of(code.end() - count, code.end(), [](const Instruction& i) { return i.op == VmOp::Const; });
+		}
+
+		/** Removes the last count constants and returns their values in push order */
+		void PopConsts(int count, int* values) {
+			for (int i = 0; i < count; ++i) {
+				values[i] = code[code.size() - count + i].a;
+			}
+			code.resize(code.size() - count);
+			depth -= count;
+		}
+
+		void Compile() {
+			if (AtEnd()) {
+				Emit({VmOp::Const, 0});
+				return;
+			}
+
+			auto op = static_cast<Op>(Next());
+
+			if (IsUnary(op)) {
+				Compile();
+				if (LastAreConst(1)) {
+					code.back().a = ApplyUnary(op, code.back().a);
+				} else {
+					Emit({VmOp::Unary, static_cast<int32_t>(op)});
+				}
+				return;
+			}
+
+			if (IsBinary(op)) {
+				Compile();
+				Compile();
+				CompileBinary(op);
+				return;
+			}
+
+			if (IsInplace(op)) {
+				Op target = Op::Null;
+				if (AtEnd()) {
+					Emit({VmOp::Const, 0});
+				} else {
+					target = static_cast<Op>(ops[pos]);
+					switch (target) {
+						case Op::Var:
+						case Op::Switch:
+						case Op::VarIndirect:
+						case Op::SwitchIndirect:
+							++pos;
+							break;
+						default:
+							break;
+					}
+					Compile();
+				}
+				Compile();
+				Emit({VmOp::Inplace, static_cast<int32_t>(op), static_cast<int32_t>(target)});
+				return;
+			}
+
+			int imm, imm2, imm3, value;
+
+			switch (op) {
+				case Op::Null:
+					++pos;
+					Emit({VmOp::Const, 0});
+					return;
+				case Op::U8:
+				case Op::UX8:
+					Emit({VmOp::Const, Next()});
+					return;
+				case Op::U16:
+				case Op::UX16:
+					imm = Next();
+					if (AtEnd()) {
+						Emit({VmOp::Const, 0});
+						return;
+					}
+					imm2 = Next();
+					Emit({VmOp::Const, (imm2 << 8) + imm});
+					return;
+				case Op::S32:
+				case Op::SX32:
+					imm = Next();
+					if (AtEnd()) {
+						Emit({VmOp::Const, 0});
+						return;
+					}
+					imm2 = Next();
+					if (AtEnd()) {
+						Emit({VmOp::Const, 0});
+						return;
+					}
+					imm3 = Next();
+					if (AtEnd()) {
+						Emit({VmOp::Const, 0});
+						return;
+					}
+					value = Next();
+					Emit({VmOp::Const, (value << 24) + (imm3 << 16) + (imm2 << 8) + imm});
+					return;
+				case Op::Var:
+				case Op::Switch:
+					Compile();
+					if (LastAreConst(1)) {
+						code.back().op = op == Op::Var ? VmOp::Var : VmOp::Switch;
+					} else {
+						Emit({op == Op::Var ? VmOp::VarDynamic : VmOp::SwitchDynamic});
+					}
+					return;
+				case Op::VarIndirect:
+					Compile();
+					Emit({VmOp::VarIndirect});
+					return;
+				case Op::SwitchIndirect:
+					Compile();
+					Emit({VmOp::SwitchIndirect});
+					return;
+				case Op::Ternary:
+					Compile();
+					Compile();
+					Compile();
+					if (LastAreConst(3)) {
+						int values[3];
+						PopConsts(3, values);
+						Emit({VmOp::Const, values[0] != 0 ? values[1] : values[2]});
+					} else {
+						Emit({VmOp::Ternary});
+					}
+					return;
+				case Op::Function:
+					CompileFunction();
+					return;
+				default:
+					Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
+					Emit({VmOp::Const, 0});
+					return;
+			}
+		}
+
+		void CompileBinary(Op op) {
+			if (LastAreConst(2)) {
+				int values[2];
+				PopConsts(2, values);
+				Emit({VmOp::Const, ApplyBinary(op, values[0], values[1])});
+				return;
+			}
+
+			if (LastAreConst(1)) {
+				int rhs;
+				PopConsts(1, &rhs);
+				if (!code.empty() && code.back().op == VmOp::Var) {
+					auto& instr = code.back();
+					instr = {VmOp::VarBinaryConst, static_cast<int32_t>(op), instr.a, rhs};
+				} else {
+					code.push_back({VmOp::BinaryConst, static_cast<int32_t>(op), rhs});
+				}
+				return;
+			}
+
+			Emit({VmOp::Binary, static_cast<int32_t>(op)});
+		}
+
+		void CompileFunction() {
+			int fn = Next();
+			int num_args = Next();
+
+			if ((num_args & 0x80) != 0) {
+				Output::Warning("Maniac: Expression func long args unsupported");
+				Emit({VmOp::Const, 0});
+				return;
+			}
+
+			auto* info = GetFunctionInfo(fn);
+			if (!info) {
+				Output::Warning("Maniac: Expression Unknown Func {}", fn);
+				// The arguments are still evaluated for their side effects
+				for (int i = 0; i < num_args; ++i) {
+					Compile();
+				}
+				if (num_args == 0) {
+					Emit({VmOp::Const, 0});
+				} else {
+					Emit({VmOp::Discard, num_args});
+				}
+				return;
+			}
+
+			if (num_args != info->num_args) {
+				Output::Warning("Maniac: Expression {} args {} != {}", info->name, num_args, info->num_args);
+				Emit({VmOp::Const, 0});
+				return;
+			}
+
+			for (int i = 0; i < num_args; ++i) {
+				Compile();
+			}
+
+			if (IsPureFunction(static_cast<Fn>(fn)) && LastAreConst(num_args)) {
+				int args[max_function_args];
+				PopConsts(num_args, args);
+				Emit({VmOp::Const, CallFunction(static_cast<Fn>(fn), args, ip)});
+				return;
+			}
+
+			Emit({VmOp::Function, fn, num_args});
+		}
+
+		std::vector<int32_t> ops;
+		std::vector<Instruction>& code;
+		const Game_BaseInterpreterContext& ip;
+		size_t pos = 0;
+		int depth = 0;
+		int max_depth = 0;
+	};
+
+	template <typename F>
+	void Run(const CompiledExpression& expr, const Game_BaseInterpreterContext& ip, F&& yield) {
+		constexpr int small_stack = 32;
+		int32_t small[small_stack];
+		std::vector<int32_t> large;
+		int32_t* stack = small;
+		if (expr.max_depth > small_stack) {
+			large.resize(expr.max_depth);
+			stack = large.data();
+		}
+		int sp = 0;
+
+		for (const auto& instr: expr.code) {
+			switch (instr.op) {
+				case VmOp::Const:
+					stack[sp++] = instr.a;
+					break;
+				case VmOp::Var:
+					stack[sp++] = Main_Data::game_variables->Get(instr.a);
+					break;
+				case VmOp::Switch:
+					stack[sp++] = Main_Data::game_switches->GetInt(instr.a);
+					break;
+				case VmOp::VarDynamic:
+					stack[sp - 1] = Main_Data::game_variables->Get(stack[sp - 1]);
+					break;
+				case VmOp::SwitchDynamic:
+					stack[sp - 1] = Main_Data::game_switches->GetInt(stack[sp - 1]);
+					break;
+				case VmOp::VarIndirect:
+					stack[sp - 1] = Main_Data::game_variables->GetIndirect(stack[sp - 1]);
+					break;
+				case VmOp::SwitchIndirect:
+					stack[sp - 1] = Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(stack[sp - 1]));
+					break;
+				case VmOp::Unary:
+					stack[sp - 1] = ApplyUnary(static_cast<Op>(instr.a), stack[sp - 1]);
+					break;
+				case VmOp::Binary:
+					--sp;
+					stack[sp - 1] = ApplyBinary(static_cast<Op>(instr.a), stack[sp - 1], stack[sp]);
+					break;
+				case VmOp::BinaryConst:
+					stack[sp - 1] = ApplyBinary(static_cast<Op>(instr.a), stack[sp - 1], instr.b);
+					break;
+				case VmOp::VarBinaryConst:
+					stack[sp++] = ApplyBinary(static_cast<Op>(instr.a), Main_Data::game_variables->Get(instr.b), instr.c);
+					break;
+				case VmOp::Ternary:
+					sp -= 2;
+					stack[sp - 1] = stack[sp - 1] != 0 ? stack[sp] : stack[sp + 1];
+					break;
+				case VmOp::Inplace: {
+					--sp;
+					ProcessAssignmentRet ret = {static_cast<Op>(instr.b), stack[sp - 1]};
+					stack[sp - 1] = ApplyInplace(static_cast<Op>(instr.a), ret, stack[sp]);
+					break;
+				}
+				case VmOp::Function:
+					sp -= instr.b;
+					stack[sp] = CallFunction(static_cast<Fn>(instr.a), &stack[sp], ip);
+					++sp;
+					break;
+				case VmOp::Discard:
+					sp -= instr.a;
+					stack[sp++] = 0;
+					break;
+				case VmOp::Yield:
+					yield(stack[--sp]);
+					break;
+			}
+		}
+
+		if (sp > 0) {
+			yield(stack[sp - 1]);
+		}
+	}
+
+	size_t HashOpCodes(Span<const int32_t> op_codes, bool multiple) {
+		// FNV-1a
+		uint64_t hash = 14695981039346656037ull ^ static_cast<uint64_t>(multiple);
+		for (auto o: op_codes) {
+			hash = (hash ^ static_cast<uint32_t>(o)) * 1099511628211ull;
+		}
+		return static_cast<size_t>(hash);
+	}
+
+	constexpr size_t max_cached_expressions = 4096;
+	std::unordered_multimap<size_t, CompiledExpression> expression_cache;
+
+	const CompiledExpression& GetCompiledExpression(Span<const int32_t> op_codes, bool multiple, const Game_BaseInterpreterContext& ip) {
+		const size_t hash = HashOpCodes(op_codes, multiple);
+		auto range = expression_cache.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			const auto& expr = it->second;
+			if (expr.multiple == multiple && std::equal(expr.source.begin(), expr.source.end(), op_codes.begin(), op_codes.end())) {
+				return expr;
+			}
+		}
+
+		if (expression_cache.size() >= max_cached_expressions) {
+			// Generated or self-modifying code, start over instead of tracking usage
+			expression_cache.clear();
+		}
+
+		CompiledExpression expr;
+		expr.source.assign(op_codes.begin(), op_codes.end());
+		expr.multiple = multiple;
+		ExpressionCompiler compiler(DecodeOpCodes(op_codes), expr.code, ip);
+		if (multiple) {
+			compiler.CompileAll();
+		} else {
+			compiler.CompileOne();
+		}
+		expr.max_depth = compiler.GetMaxDepth();
+
+		return expression_cache.emplace(hash, std::move(expr))->second;
+	}
+}
+
+int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto& expr = GetCompiledExpression(op_codes, false, interpreter);
+	int32_t result = 0;
+	Run(expr, interpreter, [&result](int32_t value) { result = value; });
+	return result;
+}
+
+std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto& expr = GetCompiledExpression(op_codes, true, interpreter);
+	std::vector<int32_t> results;
+	Run(expr, interpreter, [&results](int32_t value) { results.push_back(value); });
+	return results;
+}
+
+void ManiacPatch::ClearExpressionCache() {
+	expression_cache.clear();
+}
+
 std::array<bool, 50> ManiacPatch::GetKeyRange() {
 	std::array<Input::Keys::InputKey, 50> keys = {
 		Input::Keys::A,
@@ -28,9 +28,40 @@
 class Game_BaseInterpreterContext;
 
 namespace ManiacPatch {
+	/**
+	 * Evaluates a Maniac expression.
+	 * The expression is compiled on first use and the compiled form is cached.
+	 *
+	 * @param op_codes encoded expression
+	 * @param interpreter interpreter context
+	 * @return result of the expression
+	 */
 	int32_t ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates a list of Maniac expressions terminated by a Null operation.
+	 * The expressions are compiled on first use and the compiled form is cached.
+	 *
+	 * @param op_codes encoded expressions
+	 * @param interpreter interpreter context
+	 * @return results of the expressions
+	 */
 	std::vector<int32_t> ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
 
+	/**
+	 * Like ParseExpression but walks the encoded expression without compiling it.
+	 * Used as reference for the compiled expressions.
+	 */
+	int32_t InterpretExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Like ParseExpressions but walks the encoded expressions without compiling them.
+	 */
+	std::vector<int32_t> InterpretExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/** Drops all compiled expressions */
+	void ClearExpressionCache();
+
 	std::array<bool, 50> GetKeyRange();
 
 	bool CheckString(std::string_view str_l, std::string_view str_r, int op, bool ignore_case);
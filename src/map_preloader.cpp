@@ -0,0 +1,240 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "map_preloader.h"
+#include "async_handler.h"
+#include "filefinder.h"
+#include "game_map.h"
+#include "output.h"
+#include "player.h"
+#include <lcf/data.h>
+#include <lcf/lmu/reader.h>
+#include <lcf/reader_util.h>
+#include <algorithm>
+
+namespace {
+	struct PendingMap {
+		int map_id = 0;
+		FileRequestBinding request;
+		bool file_ready = false;
+		bool failed = false;
+		/** Frames left until the map is parsed after the file is ready */
+		int delay = 0;
+	};
+
+	std::vector<PendingMap> pending_maps;
+	std::vector<int> preloaded_maps;
+	int budget = MapPreloader::default_budget;
+	int simulated_latency = 0;
+	MapPreloader::Loader loader;
+
+	MapPreloader::LoadResult LoadMap(int map_id) {
+		bool is_easyrpg;
+		auto map_file = Game_Map::FindMapFile(map_id, is_easyrpg);
+		if (map_file.empty()) {
+			return {};
+		}
+
+		auto map_stream = FileFinder::Game().OpenInputStream(map_file);
+		if (!map_stream) {
+			return {};
+		}
+
+		std::unique_ptr<lcf::rpg::Map> map;
+		if (is_easyrpg) {
+			map = lcf::LMU_Reader::LoadXml(map_stream);
+		} else {
+			map = lcf::LMU_Reader::Load(map_stream, Player::encoding);
+		}
+		return { std::move(map_file), std::move(map) };
+	}
+
+	int GetTriggerRank(int trigger) {
+		switch (trigger) {
+			case lcf::rpg::EventPage::Trigger_touched:
+			case lcf::rpg::EventPage::Trigger_collision:
+				return 0;
+			case lcf::rpg::EventPage::Trigger_action:
+				return 1;
+			default:
+				return 2;
+		}
+	}
+
+	void RequestAssets(const lcf::rpg::Map& map) {
+		if (auto* chipset = lcf::ReaderUtil::GetElement(lcf::Data::chipsets, map.chipset_id)) {
+			if (!chipset->chipset_name.empty()) {
+				auto* request = AsyncHandler::RequestFile("ChipSet", chipset->chipset_name);
+				request->SetGraphicFile(true);
+				request->Start();
+			}
+		}
+
+		if (map.parallax_flag && !map.parallax_name.empty()) {
+			auto* request = AsyncHandler::RequestFile("Panorama", map.parallax_name);
+			request->SetGraphicFile(true);
+			request->Start();
+		}
+	}
+}
+
+std::vector<int> MapPreloader::CollectTeleportTargets(const lcf::rpg::Map& map, int map_id) {
+	// Destination and best trigger rank in order of appearance
+	std::vector<std::pair<int, int>> targets;
+
+	for (const auto& ev: map.events) {
+		for (const auto& page: ev.pages) {
+			const int rank = GetTriggerRank(page.trigger);
+			for (const auto& com: page.event_commands) {
+				if (static_cast<lcf::rpg::EventCommand::Code>(com.code) != lcf::rpg::EventCommand::Code::Teleport
+						|| com.parameters.empty()) {
+					continue;
+				}
+
+				const int target_id = com.parameters[0];
+				if (target_id <= 0 || target_id == map_id) {
+					continue;
+				}
+
+				auto it = std::find_if(targets.begin(), targets.end(), [&](const auto& t) { return t.first == target_id; });
+				if (it == targets.end()) {
+					targets.emplace_back(target_id, rank);
+				} else {
+					it->second = std::min(it->second, rank);
+				}
+			}
+		}
+	}
+
+	std::stable_sort(targets.begin(), targets.end(), [](const auto& a, const auto& b) {
+		return a.second < b.second;
+	});
+
+	std::vector<int> result;
+	result.reserve(targets.size());
+	for (const auto& t: targets) {
+		result.push_back(t.first);
+	}
+	return result;
+}
+
+void MapPreloader::Start(const lcf::rpg::Map& map, int map_id) {
+	Clear();
+
+	// Keep one slot of the cache for the current map
+	const int max_maps = std::min(budget, Game_Map::MapFiles::GetCapacity() - 1);
+	if (max_maps <= 0) {
+		return;
+	}
+
+	auto targets = CollectTeleportTargets(map, map_id);
+	if (static_cast<int>(targets.size()) > max_maps) {
+		targets.resize(max_maps);
+	}
+
+	for (int target_id: targets) {
+		pending_maps.push_back({});
+		pending_maps.back().map_id = target_id;
+	}
+
+	for (auto& pm: pending_maps) {
+		// Not important: a speculative download must not block the game.
+		// Game_Map::RequestMap upgrades the request when the teleport happens.
+		auto* request = AsyncHandler::RequestFile(Game_Map::ConstructMapName(pm.map_id, false));
+		const int target_id = pm.map_id;
+		pm.request = request->Bind([target_id](FileRequestResult* result) {
+			auto it = std::find_if(pending_maps.begin(), pending_maps.end(), [&](const auto& p) { return p.map_id == target_id; });
+			if (it == pending_maps.end()) {
+				return;
+			}
+			if (!result->success) {
+				it->failed = true;
+				return;
+			}
+			it->file_ready = true;
+			it->delay = simulated_latency;
+		});
+		request->Start();
+	}
+}
+
+void MapPreloader::Update() {
+	pending_maps.erase(std::remove_if(pending_maps.begin(), pending_maps.end(), [](const auto& pm) {
+		return pm.failed;
+	}), pending_maps.end());
+
+	for (auto& pm: pending_maps) {
+		if (pm.file_ready && pm.delay > 0) {
+			--pm.delay;
+		}
+	}
+
+	auto it = std::find_if(pending_maps.begin(), pending_maps.end(), [](const auto& pm) {
+		return pm.file_ready && pm.delay == 0;
+	});
+	if (it == pending_maps.end()) {
+		return;
+	}
+
+	const int map_id = it->map_id;
+	pending_maps.erase(it);
+
+	auto result = loader ? loader(map_id) : LoadMap(map_id);
+	if (!result.map) {
+		Output::Debug("Preload of Map {} failed", map_id);
+		return;
+	}
+
+	if (!Game_Map::MapFiles::Find(result.map_file)) {
+		Game_Map::MapFiles::Insert(result.map_file, result.map);
+	}
+	RequestAssets(*result.map);
+	preloaded_maps.push_back(map_id);
+}
+
+void MapPreloader::Clear() {
+	pending_maps.clear();
+	preloaded_maps.clear();
+}
+
+void MapPreloader::SetBudget(int max_maps) {
+	budget = std::max(max_maps, 0);
+}
+
+int MapPreloader::GetBudget() {
+	return budget;
+}
+
+void MapPreloader::SetLoader(Loader new_loader) {
+	loader = std::move(new_loader);
+}
+
+void MapPreloader::SetSimulatedLatency(int frames) {
+	simulated_latency = std::max(frames, 0);
+}
+
+std::vector<int> MapPreloader::GetPendingMaps() {
+	std::vector<int> result;
+	for (const auto& pm: pending_maps) {
+		result.push_back(pm.map_id);
+	}
+	return result;
+}
+
+std::vector<int> MapPreloader::GetPreloadedMaps() {
+	return preloaded_maps;
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MAP_PRELOADER_H
+#define EP_MAP_PRELOADER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <lcf/rpg/fwd.h>
+
+/**
+ * Speculatively loads the maps the current map teleports to.
+ *
+ * When a map is set up the constant Teleport destinations of its events
+ * are collected, touch and collision triggered pages first. Their files
+ * are requested in the background and, once available, parsed into
+ * Game_Map::MapFiles at most one map per frame while also requesting
+ * their chipset and panorama. A following teleport to one of these maps
+ * then hits the cache.
+ */
+namespace MapPreloader {
+	/** Result of loading a map */
+	struct LoadResult {
+		/** Path of the map file, the key in Game_Map::MapFiles */
+		std::string map_file;
+		std::shared_ptr<const lcf::rpg::Map> map;
+	};
+
+	/** Parses a map by id */
+	using Loader = std::function<LoadResult(int map_id)>;
+
+	/** Number of maps preloaded by default */
+	constexpr int default_budget = 4;
+
+	/**
+	 * Collects the destinations of Teleport commands in the events of a map.
+	 *
+	 * @param map map to scan
+	 * @param map_id id of the map, not included in the result
+	 * @return unique map ids, destinations of touch triggered pages first
+	 */
+	std::vector<int> CollectTeleportTargets(const lcf::rpg::Map& map, int map_id);
+
+	/**
+	 * Drops the preloads of the previous map and starts preloading the
+	 * teleport destinations of a map.
+	 *
+	 * @param map map that was set up
+	 * @param map_id id of the map
+	 */
+	void Start(const lcf::rpg::Map& map, int map_id);
+
+	/** Parses the next map whose file is available. Called once per frame. */
+	void Update();
+
+	/** Cancels all pending preloads */
+	void Clear();
+
+	/**
+	 * @param max_maps how many maps are preloaded per map, 0 disables
+	 *   preloading. Limited by the capacity of Game_Map::MapFiles.
+	 */
+	void SetBudget(int max_maps);
+
+	/** @return how many maps are preloaded per map */
+	int GetBudget();
+
+	/**
+	 * Replaces how maps are parsed.
+	 *
+	 * @param loader loader to use, nullptr restores the default
+	 */
+	void SetLoader(Loader loader);
+
+	/**
+	 * Delays every map by some frames after its file is available.
+	 * Simulates slow downloads in tests.
+	 *
+	 * @param frames additional frames
+	 */
+	void SetSimulatedLatency(int frames);
+
+	/** @return ids of the maps still waiting to be preloaded */
+	std::vector<int> GetPendingMaps();
+
+	/** @return ids of the maps preloaded since the last Start */
+	std::vector<int> GetPreloadedMaps();
+}
+
+#endif
@@ -10,6 +10,146 @@
 
 std::map<std::string, std::array<int, 96>> sprite_y_offsets;
 
+namespace {
+	/**
+	 * Shared bitmap holding the rendered names of all nametags.
+	 *
+	 * Names are 12 pixel high and packed into rows. Nametags with the same
+	 * text and system graphic share a slot, released slots are reused by
+	 * later names that fit. A toned copy of the whole atlas is kept for the
+	 * current screen tone, so nametags without a flash need no own bitmap.
+	 */
+	class NametagAtlas {
+	public:
+		int Acquire(const std::string& text, const BitmapRef& sys);
+		void Release(int slot);
+
+		const Rect& GetRect(int slot) const {
+			return slots[slot].rect;
+		}
+
+		const Bitmap& GetBitmap() const {
+			return *bitmap;
+		}
+
+		const Bitmap& GetToned(const Tone& tone);
+
+	private:
+		enum { WIDTH = 512, ROW_HEIGHT = 12 };
+
+		struct Slot {
+			std::string text;
+			BitmapRef sys;
+			/** Area of the rendered name */
+			Rect rect;
+			/** Width reserved in the row */
+			int capacity = 0;
+			int refs = 0;
+		};
+
+		int Allocate(int width);
+		void Grow();
+
+		BitmapRef bitmap;
+		BitmapRef toned;
+		Tone toned_tone;
+		std::vector<Slot> slots;
+		int row_x = 0;
+		int row_y = 0;
+	};
+
+	NametagAtlas nametag_atlas;
+
+	const std::array<int, 96>* FindSpriteYOffsets(const std::string& sprite_name);
+}
+
+int NametagAtlas::Acquire(const std::string& text, const BitmapRef& sys) {
+	for (int i = 0; i < static_cast<int>(slots.size()); ++i) {
+		auto& slot = slots[i];
+		if (slot.refs > 0 && slot.sys == sys && slot.text == text) {
+			++slot.refs;
+			return i;
+		}
+	}
+
+	// FIXME: Text::GetSize is broken and always returns a height of 0, use 12 for now
+	auto size = Text::GetSize(*Font::NameText(), text);
+	const int width = std::clamp(size.width, 1, static_cast<int>(WIDTH));
+
+	// Render separately so that shadows are clipped like on an own bitmap
+	auto nick_img = Bitmap::Create(width, ROW_HEIGHT);
+	Text::Draw(*nick_img, 0, 0, *Font::NameText(), *sys, 0, text);
+
+	const int index = Allocate(width);
+	auto& slot = slots[index];
+	slot.text = text;
+	slot.sys = sys;
+	slot.rect.width = width;
+	slot.refs = 1;
+
+	const Rect area = { slot.rect.x, slot.rect.y, slot.capacity, ROW_HEIGHT };
+	bitmap->ClearRect(area);
+	bitmap->Blit(slot.rect.x, slot.rect.y, *nick_img, nick_img->GetRect(), Opacity::Opaque());
+	if (toned) {
+		toned->ClearRect(area);
+		toned->ToneBlit(slot.rect.x, slot.rect.y, *bitmap, slot.rect, toned_tone, Opacity::Opaque());
+	}
+
+	return index;
+}
+
+void NametagAtlas::Release(int slot) {
+	auto& s = slots[slot];
+	if (--s.refs == 0) {
+		s.text.clear();
+		s.sys.reset();
+	}
+}
+
+const Bitmap& NametagAtlas::GetToned(const Tone& tone) {
+	if (!toned || toned_tone != tone) {
+		toned = Bitmap::Create(bitmap->width(), bitmap->height(), true);
+		toned->ToneBlit(0, 0, *bitmap, bitmap->GetRect(), tone, Opacity::Opaque());
+		toned_tone = tone;
+	}
+	return *toned;
+}
+
+int NametagAtlas::Allocate(int width) {
+	for (int i = 0; i < static_cast<int>(slots.size()); ++i) {
+		if (slots[i].refs == 0 && slots[i].capacity >= width) {
+			return i;
+		}
+	}
+
+	if (row_x + width > WIDTH) {
+		row_x = 0;
+		row_y += ROW_HEIGHT;
+	}
+	if (!bitmap || row_y + ROW_HEIGHT > bitmap->height()) {
+		Grow();
+	}
+
+	Slot slot;
+	slot.rect = { row_x, row_y, width, ROW_HEIGHT };
+	slot.capacity = width;
+	row_x += width;
+
+	slots.push_back(std::move(slot));
+	return static_cast<int>(slots.size()) - 1;
+}
+
+void NametagAtlas::Grow() {
+	const int height = bitmap ? bitmap->height() * 2 : ROW_HEIGHT * 8;
+	auto grown = Bitmap::Create(WIDTH, height, true);
+	if (bitmap) {
+		grown->Blit(0, 0, *bitmap, bitmap->GetRect(), Opacity::Opaque());
+	}
+	grown->SetId("nametags");
+	bitmap = std::move(grown);
+	toned.reset();
+}
+
 ChatName::ChatName(int id, PlayerOther& player, std::string nickname)
 	:player(player),
 	nickname(std::move(nickname)),
@@ -18,18 +158,30 @@ ChatName::ChatName(int id, PlayerOther& player, std::string nickname)
 	DrawableMgr::Register(this);
 }
 
+ChatName::~ChatName() {
+	ReleaseNickSlot();
+}
+
+void ChatName::ReleaseNickSlot() {
+	if (nick_slot >= 0) {
+		nametag_atlas.Release(nick_slot);
+		nick_slot = -1;
+	}
+	effects_img.reset();
+}
+
 void ChatName::Draw(Bitmap& dst) {
 	auto nametag_mode = GMI().GetNametagMode();
 	
 	if (nametag_mode == Game_Multiplayer::NametagMode::NONE || nickname.empty() || !player.sprite.get()) {
-		nick_img.reset();
+		ReleaseNickSlot();
 		dirty = true;
 		return;
 	}
 
 	if (nametag_mode_cache != nametag_mode) {
 		nametag_mode_cache = nametag_mode;
-		nick_img.reset();
+		ReleaseNickSlot();
 		dirty = true;
 	}
 
@@ -42,12 +194,8 @@ void ChatName::Draw(Bitmap& dst) {
 			nick_trim = nickname.substr(0, std::min(3, (int)nickname.size()));
 		}
 
-		// FIXME: Text::GetSize is broken and always returns a height of 0, use 12 for now
-		auto rect = Text::GetSize(*Font::NameText(), nick_trim);
-		nick_img = Bitmap::Create(rect.width, 12);
-		nick_img->SetId(fmt::format("nametag:{}", nickname));
-
-		Text::Draw(*nick_img, 0, 0, *Font::NameText(), *(sys_graphic ? sys_graphic : Cache::SystemOrBlack()), 0, nick_trim);
+		ReleaseNickSlot();
+		nick_slot = nametag_atlas.Acquire(nick_trim, sys_graphic ? sys_graphic : Cache::SystemOrBlack());
 
 		dirty = false;
 
@@ -59,32 +207,52 @@ void ChatName::Draw(Bitmap& dst) {
 		effects_dirty = true;
 	}
 
+	if (player.ch->IsSpriteHidden()) {
+		return;
+	}
+
+	const auto& nick_rect = nametag_atlas.GetRect(nick_slot);
+	int x = player.ch->GetScreenX() - nick_rect.width / 2;
+	int y = (player.ch->GetScreenY() - player.sprite->GetHeight()) + GetSpriteYOffset();
+
+	if (transparent && base_opacity > 16) {
+		SetBaseOpacity(base_opacity - 1);
+	} else if (!transparent && base_opacity < 32) {
+		SetBaseOpacity(base_opacity + 1);
+	}
+
+	if (x >= dst.width() || y >= dst.height() || x + nick_rect.width <= 0 || y + nick_rect.height <= 0) {
+		// Offscreen, effects are applied when it becomes visible
+		return;
+	}
+
 	if (effects_dirty) {
 		auto tone = player.sprite->GetTone();
 		auto flash = player.sprite->GetCharacter()->GetFlashColor();
 
-		effects_img.reset(); // maybe not needed?
-
-		if (tone == Tone() && flash.alpha == 0) {
-			effects_img = nick_img;
+		effects_tone = tone;
+		if (flash.alpha == 0) {
+			effects_img.reset();
 		} else {
-			effects_img = Cache::SpriteEffect(nick_img, nick_img->GetRect(), false, false, tone, flash);
+			// Same as Cache::SpriteEffect but without caching a bitmap that changes
+			effects_img = Bitmap::Create(nick_rect.width, nick_rect.height, true);
+			if (tone != Tone()) {
+				effects_img->ToneBlit(0, 0, nametag_atlas.GetBitmap(), nick_rect, tone, Opacity::Opaque());
+				effects_img->BlendBlit(0, 0, *effects_img, effects_img->GetRect(), flash, Opacity::Opaque());
+			} else {
+				effects_img->BlendBlit(0, 0, nametag_atlas.GetBitmap(), nick_rect, flash, Opacity::Opaque());
+			}
 		}
 
 		effects_dirty = false;
 	}
 
-	if (!player.ch->IsSpriteHidden()) {
-		int x = player.ch->GetScreenX() - nick_img->GetWidth() / 2;
-		int y = (player.ch->GetScreenY() - player.sprite->GetHeight()) + GetSpriteYOffset();
-
-		if (transparent && base_opacity > 16) {
-			SetBaseOpacity(base_opacity - 1);
-		} else if (!transparent && base_opacity < 32) {
-			SetBaseOpacity(base_opacity + 1);
-		}
-
+	if (effects_img) {
 		dst.Blit(x, y, *effects_img, effects_img->GetRect(), Opacity(GetOpacity()));
+	} else if (effects_tone == Tone()) {
+		dst.Blit(x, y, nametag_atlas.GetBitmap(), nick_rect, Opacity(GetOpacity()));
+	} else {
+		dst.Blit(x, y, nametag_atlas.GetToned(effects_tone), nick_rect, Opacity(GetOpacity()));
 	}
 }
 
@@ -111,76 +279,91 @@ int ChatName::GetOpacity() {
 }
 
 int ChatName::GetSpriteYOffset() {
-	std::string sprite_name = player.ch->GetSpriteName();
-	if (!sprite_y_offsets.count(sprite_name)) {
-		auto filename = FileFinder::FindImage("CharSet", sprite_name);
-		if (filename == "") {
+	const auto& sprite_name = player.ch->GetSpriteName();
+	if (!sprite_offsets || sprite_offsets_name != sprite_name) {
+		sprite_offsets = FindSpriteYOffsets(sprite_name);
+		if (!sprite_offsets) {
 			return 0;
 		}
+		sprite_offsets_name = sprite_name;
+	}
 
-		auto offset_array = std::array<int, 96>{ 0 };
+	auto frame = player.ch->GetAnimFrame();
+	if (frame >= lcf::rpg::EventPage::Frame_middle2) {
+		frame = lcf::rpg::EventPage::Frame_middle;
+	}
 
-		const int BASE_OFFSET = -13;
-		const size_t BGRA = 4;
+	int ret = (*sprite_offsets)[player.ch->GetSpriteIndex() * 12 + player.ch->GetFacing() * 3 + frame];
 
-		auto image = Cache::Charset(sprite_name);
+	if (ret != 32) {
+		last_valid_sprite_y_offset = ret;
+	} else {
+		return last_valid_sprite_y_offset;
+	}
+
+	return ret;
+}
+
+namespace {
+const std::array<int, 96>* FindSpriteYOffsets(const std::string& sprite_name) {
+	auto it = sprite_y_offsets.find(sprite_name);
+	if (it != sprite_y_offsets.end()) {
+		return &it->second;
+	}
 
-		for (int hi = 0; hi < image->height() / 128; ++hi) {
-			for (int wi = 0; wi < image->width() / 72; ++wi) {
-				for (int fi = 0; fi < 4; ++fi) {
-					for (int afi = 0; afi < 3; ++afi) {
-						int i = ((hi << 2) + wi) * 12 + (fi * 3) + afi;
+	auto filename = FileFinder::FindImage("CharSet", sprite_name);
+	if (filename == "") {
+		return nullptr;
+	}
 
-						int start_x = wi * 72 + afi * 24;
-						int start_y = hi * 128 + fi * 32;
+	auto offset_array = std::array<int, 96>{ 0 };
 
-						int y = start_y;
+	const int BASE_OFFSET = -13;
+	const size_t BGRA = 4;
 
-						bool offset_found = false;
+	auto image = Cache::Charset(sprite_name);
 
-						for (; y < start_y + 32; ++y) {
-							for (int x = start_x; x < start_x + 24; ++x) {
-								size_t index = BGRA * (y * image->width() + x);
-								auto pixels = reinterpret_cast<unsigned char*>(image->pixels());
-								if (pixels[index + 3] != 0) { // check if alpha is not 0 (fully transparent)
-									offset_found = true;
-									break;
-								}
-							}
-							
-							if (offset_found) {
+	for (int hi = 0; hi < image->height() / 128; ++hi) {
+		for (int wi = 0; wi < image->width() / 72; ++wi) {
+			for (int fi = 0; fi < 4; ++fi) {
+				for (int afi = 0; afi < 3; ++afi) {
+					int i = ((hi << 2) + wi) * 12 + (fi * 3) + afi;
+
+					int start_x = wi * 72 + afi * 24;
+					int start_y = hi * 128 + fi * 32;
+
+					int y = start_y;
+
+					bool offset_found = false;
+
+					for (; y < start_y + 32; ++y) {
+						for (int x = start_x; x < start_x + 24; ++x) {
+							size_t index = BGRA * (y * image->width() + x);
+							auto pixels = reinterpret_cast<unsigned char*>(image->pixels());
+							if (pixels[index + 3] != 0) { // check if alpha is not 0 (fully transparent)
+								offset_found = true;
 								break;
 							}
 						}
-
+						
 						if (offset_found) {
-							if (y > start_y + 15) {
-								y = start_y + 15;
-							}
-							offset_array[i] = BASE_OFFSET + (y - start_y);
-						} else {
-							offset_array[i] = 32;
+							break;
 						}
 					}
+
+					if (offset_found) {
+						if (y > start_y + 15) {
+							y = start_y + 15;
+						}
+						offset_array[i] = BASE_OFFSET + (y - start_y);
+					} else {
+						offset_array[i] = 32;
+					}
 				}
 			}
-
-			sprite_y_offsets[sprite_name] = std::array<int, 96>(offset_array);
 		}
 	}
 
-	auto frame = player.ch->GetAnimFrame();
-	if (frame >= lcf::rpg::EventPage::Frame_middle2) {
-		frame = lcf::rpg::EventPage::Frame_middle;
-	}
-
-	int ret = sprite_y_offsets[sprite_name][player.ch->GetSpriteIndex() * 12 + player.ch->GetFacing() * 3 + frame];
-
-	if (ret != 32) {
-		last_valid_sprite_y_offset = ret;
-	} else {
-		return last_valid_sprite_y_offset;
-	}
-
-	return ret;
+	return &(sprite_y_offsets[sprite_name] = offset_array);
+}
 }
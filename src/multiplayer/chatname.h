@@ -1,6 +1,7 @@
 #ifndef EP_CHATNAME_H
 #define EP_CHATNAME_H
 
+#include <array>
 #include <queue>
 
 #include "game_multiplayer.h"
@@ -10,6 +11,7 @@ struct PlayerOther;
 class ChatName : public Drawable {
 public:
 	ChatName(int id, PlayerOther& player, std::string nickname);
+	~ChatName() override;
 
 	void Draw(Bitmap& dst) override;
 
@@ -24,9 +26,15 @@ public:
 private:
 	PlayerOther& player;
 	std::string nickname;
-	BitmapRef nick_img;
+	/** Slot of the rendered name in the shared nametag atlas, -1 when none */
+	int nick_slot = -1;
 	BitmapRef sys_graphic;
+	/** Own copy of the name while it is flashing */
 	BitmapRef effects_img;
+	Tone effects_tone;
+	/** Charset the sprite offsets were looked up for */
+	std::string sprite_offsets_name;
+	const std::array<int, 96>* sprite_offsets = nullptr;
 	std::shared_ptr<int> request_id;
 	bool transparent;
 	int base_opacity = 32;
@@ -37,6 +45,7 @@ private:
 	int last_valid_sprite_y_offset;
 	
 	void SetBaseOpacity(int val);
+	void ReleaseNickSlot();
 	int GetOpacity();
 	int GetSpriteYOffset();
 };
@@ -356,48 +356,7 @@ void Game_Multiplayer::InitConnection() {
 	connection.RegisterHandler<SEPacket>("se", [this] (SEPacket& p) {
 		if (players.find(p.id) == players.end()) return;
 		if (settings.enable_sounds) {
-			auto& player = players[p.id];
-
-			int px = Main_Data::game_player->GetX();
-			int py = Main_Data::game_player->GetY();
-			int ox = player.ch->GetX();
-			int oy = player.ch->GetY();
-
-			int hmw = Game_Map::GetTilesX() / 2;
-			int hmh = Game_Map::GetTilesY() / 2;
-
-			int rx;
-			int ry;
-
-			if (Game_Map::LoopHorizontal() && px - ox >= hmw) {
-				rx = Game_Map::GetTilesX() - (px - ox);
-			} else if (Game_Map::LoopHorizontal() && px - ox < hmw * -1) {
-				rx = Game_Map::GetTilesX() + (px - ox);
-			} else {
-				rx = px - ox;
-			}
-
-			if (Game_Map::LoopVertical() && py - oy >= hmh) {
-				ry = Game_Map::GetTilesY() - (py - oy);
-			} else if (Game_Map::LoopVertical() && py - oy < hmh * -1) {
-				ry = Game_Map::GetTilesY() + (py - oy);
-			} else {
-				ry = py - oy;
-			}
-
-			int dist = std::sqrt(rx * rx + ry * ry);
-
-			float dist_volume = 75.0f - ((float)dist * 10.0f);
-			float sound_volume_multiplier = float(p.snd.volume) / 100.0f;
-			int real_volume = std::max((int)(dist_volume * sound_volume_multiplier), 0);
-
-			lcf::rpg::Sound sound;
-			sound.name = p.snd.name;
-			sound.volume = real_volume;
-			sound.tempo = p.snd.tempo;
-			sound.balance = p.snd.balance;
-
-			Main_Data::game_system->SePlay(sound);
+			spatial_audio.Queue(p.id, p.snd);
 		}
 	});
 
@@ -514,6 +473,7 @@ void Game_Multiplayer::Initialize() {
 	}
 
 	players.clear();
+	spatial_audio.Clear();
 	sync_switches.clear();
 	sync_vars.clear();
 	sync_events.clear();
@@ -769,12 +729,42 @@ void Game_Multiplayer::SwitchSet(int switch_id, int value_bin) {
 	}
 }
 
+void Game_Multiplayer::SwitchRangeSet(int first_id, int last_id) {
+	// Only visit the synced switches instead of every switch in the range
+	std::vector<int> ids;
+	for (int switch_id : sync_switches) {
+		if (switch_id >= first_id && switch_id <= last_id) {
+			ids.push_back(switch_id);
+		}
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	for (int switch_id : ids) {
+		connection.SendPacketAsync<Messages::C2S::SyncSwitchPacket>(switch_id, Main_Data::game_switches->GetInt(switch_id));
+	}
+}
+
 void Game_Multiplayer::VariableSet(int var_id, int value) {
 	if (std::find(sync_vars.begin(), sync_vars.end(), var_id) != sync_vars.end()) {
 		connection.SendPacketAsync<Messages::C2S::SyncVariablePacket>(var_id, value);
 	}
 }
 
+void Game_Multiplayer::VariableRangeSet(int first_id, int last_id) {
+	// Only visit the synced variables instead of every variable in the range
+	std::vector<int> ids;
+	for (int var_id : sync_vars) {
+		if (var_id >= first_id && var_id <= last_id) {
+			ids.push_back(var_id);
+		}
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	for (int var_id : ids) {
+		connection.SendPacketAsync<Messages::C2S::SyncVariablePacket>(var_id, Main_Data::game_variables->Get(var_id));
+	}
+}
+
 void Game_Multiplayer::ApplyScreenTone() {
 	ApplyTone(Main_Data::game_screen->GetTone());
 }
@@ -870,6 +860,8 @@ void Game_Multiplayer::Update() {
 			}
 		}
 
+		spatial_audio.Update(players);
+
 		if (!switching_room && !switched_room) {
 			switched_room = true;
 		}
@@ -9,6 +9,7 @@
 #include "../tone.h"
 #include <lcf/rpg/sound.h>
 #include "yno_connection.h"
+#include "spatial_audio.h"
 
 class PlayerOther;
 
@@ -47,7 +48,9 @@ public:
 	void ApplyTone(Tone tone);
 	void ApplyScreenTone();
 	void SwitchSet(int switch_id, int value);
+	void SwitchRangeSet(int first_id, int last_id);
 	void VariableSet(int var_id, int value);
+	void VariableRangeSet(int first_id, int last_id);
 
 	struct {
 		bool enable_sounds{ true };
@@ -79,6 +82,7 @@ public:
 	NametagMode nametag_mode{NametagMode::CLASSIC};
 
 	std::map<int, PlayerOther> players;
+	SpatialAudio spatial_audio;
 	std::vector<PlayerOther> dc_players;
 	std::vector<int> sync_switches;
 	std::vector<int> sync_vars;
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include "spatial_audio.h"
+#include "playerother.h"
+#include "../audio.h"
+#include "../game_map.h"
+#include "../game_player.h"
+#include "../game_playerother.h"
+#include "../game_system.h"
+#include "../main_data.h"
+#include "../utils.h"
+
+namespace {
+	// Frames to wait for an SE to start before it is not tracked anymore
+	// (file request failed or the audio backend does not support tags)
+	constexpr int start_timeout = 120;
+}
+
+int SpatialAudio::Offset(int listener, int source, int size, bool loop) {
+	int d = source - listener;
+	if (loop && size > 0) {
+		int half = size / 2;
+		if (d >= half) {
+			d -= size;
+		} else if (d < -half) {
+			d += size;
+		}
+	}
+	return d;
+}
+
+SpatialAudio::Mix SpatialAudio::Calculate(int rx, int ry, int volume, int balance) {
+	float dist = std::sqrt(static_cast<float>(rx * rx + ry * ry));
+	float t = std::min(dist / max_distance, 1.0f);
+	// Smoothstep falloff: flat near the listener and fading out softly
+	float gain = 1.0f - t * t * (3.0f - 2.0f * t);
+
+	Mix mix;
+	mix.volume = static_cast<int>(near_volume * gain * volume / 100.0f);
+
+	float pan = Utils::Clamp(rx / max_distance, -1.0f, 1.0f);
+	mix.balance = Utils::Clamp(balance + static_cast<int>(std::lround(pan * max_pan)), 0, 100);
+	return mix;
+}
+
+bool SpatialAudio::GetMix(const std::map<int, PlayerOther>& players, int player_id, int volume, int balance, Mix& mix) const {
+	auto it = players.find(player_id);
+	if (it == players.end() || !it->second.ch) {
+		return false;
+	}
+
+	auto& ch = it->second.ch;
+	int rx = Offset(Main_Data::game_player->GetX(), ch->GetX(), Game_Map::GetTilesX(), Game_Map::LoopHorizontal());
+	int ry = Offset(Main_Data::game_player->GetY(), ch->GetY(), Game_Map::GetTilesY(), Game_Map::LoopVertical());
+	mix = Calculate(rx, ry, volume, balance);
+	return true;
+}
+
+void SpatialAudio::Queue(int player_id, const lcf::rpg::Sound& sound) {
+	pending.push_back({ player_id, sound, {} });
+}
+
+void SpatialAudio::Update(const std::map<int, PlayerOther>& players) {
+	if (!pending.empty()) {
+		// Cull inaudible SEs before anything is requested or decoded
+		std::vector<Pending> audible;
+		for (auto& p : pending) {
+			if (GetMix(players, p.player_id, p.sound.volume, p.sound.balance, p.mix) && p.mix.volume > 0) {
+				audible.push_back(std::move(p));
+			}
+		}
+		pending.clear();
+
+		// The same SE from several players is only played once, at the
+		// position of the loudest one
+		std::stable_sort(audible.begin(), audible.end(), [](const Pending& a, const Pending& b) {
+			return a.mix.volume > b.mix.volume;
+		});
+
+		int started = 0;
+		for (size_t i = 0; i < audible.size() && started < max_per_frame; ++i) {
+			auto& p = audible[i];
+			bool duplicate = std::any_of(audible.begin(), audible.begin() + i, [&](const Pending& q) {
+				return q.sound.name == p.sound.name;
+			});
+			if (duplicate) {
+				continue;
+			}
+
+			int tag = next_tag;
+			next_tag = next_tag == std::numeric_limits<int>::max() ? 1 : next_tag + 1;
+
+			lcf::rpg::Sound sound = p.sound;
+			sound.volume = p.mix.volume;
+			sound.balance = p.mix.balance;
+			Main_Data::game_system->SePlay(sound, false, tag);
+
+			playing.push_back({ tag, p.player_id, p.sound.volume, p.sound.balance, p.mix, 0, false });
+			++started;
+		}
+	}
+
+	// Follow the players with the SEs that are still playing
+	for (auto it = playing.begin(); it != playing.end();) {
+		auto& p = *it;
+		++p.age;
+
+		bool keep;
+		if (!Audio().SE_IsPlaying(p.tag)) {
+			keep = !p.started && p.age <= start_timeout;
+		} else {
+			p.started = true;
+			Mix mix;
+			// When the player left the SE finishes at the last position
+			keep = GetMix(players, p.player_id, p.volume, p.balance, mix);
+			if (keep && (mix.volume != p.mix.volume || mix.balance != p.mix.balance)) {
+				Audio().SE_Adjust(p.tag, mix.volume, mix.balance);
+				p.mix = mix;
+			}
+		}
+
+		it = keep ? std::next(it) : playing.erase(it);
+	}
+}
+
+void SpatialAudio::Clear() {
+	pending.clear();
+	playing.clear();
+}
@@ -0,0 +1,101 @@
+#ifndef EP_SPATIAL_AUDIO_H
+#define EP_SPATIAL_AUDIO_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <lcf/rpg/sound.h>
+
+struct PlayerOther;
+
+/**
+ * Positional playback of sound effects from remote players.
+ *
+ * SEs received during a frame are batched and played in Update: gain and
+ * stereo pan are derived from the position relative to the local player
+ * (aware of looping maps), inaudible SEs are dropped before the file is
+ * requested and identical SEs from several players are only played once.
+ * Volume and balance of SEs that are still playing follow the players
+ * while they move.
+ */
+class SpatialAudio {
+public:
+	/** Distance in tiles at which SEs become inaudible */
+	static constexpr float max_distance = 7.5f;
+	/** Volume at distance 0, in percent of the SE volume */
+	static constexpr int near_volume = 75;
+	/** Largest balance offset from the center for SEs at the side */
+	static constexpr int max_pan = 40;
+	/** Most SEs started per frame, the loudest ones win */
+	static constexpr int max_per_frame = 8;
+
+	struct Mix {
+		int volume;
+		int balance;
+	};
+
+	/**
+	 * Queues a SE of a remote player for the next Update.
+	 *
+	 * @param player_id id of the remote player
+	 * @param sound sound as sent by the player
+	 */
+	void Queue(int player_id, const lcf::rpg::Sound& sound);
+
+	/**
+	 * Plays the queued SEs and adjusts the playing SEs.
+	 * Must be called once per frame.
+	 *
+	 * @param players remote players of the room
+	 */
+	void Update(const std::map<int, PlayerOther>& players);
+
+	/** Drops the queue and stops tracking playing SEs, e.g. on room change */
+	void Clear();
+
+	/**
+	 * Calculates the audible volume and balance of a SE.
+	 *
+	 * @param rx horizontal tile offset of the source to the listener
+	 * @param ry vertical tile offset of the source to the listener
+	 * @param volume volume of the SE
+	 * @param balance balance of the SE
+	 */
+	static Mix Calculate(int rx, int ry, int volume, int balance);
+
+	/**
+	 * Offset from the listener to the source along one axis, on looping
+	 * maps the shorter way around the map is taken.
+	 *
+	 * @param listener listener coordinate
+	 * @param source source coordinate
+	 * @param size map size along the axis
+	 * @param loop whether the map loops along the axis
+	 */
+	static int Offset(int listener, int source, int size, bool loop);
+
+private:
+	struct Pending {
+		int player_id;
+		lcf::rpg::Sound sound;
+		Mix mix;
+	};
+
+	struct Playing {
+		int tag;
+		int player_id;
+		int volume;
+		int balance;
+		Mix mix;
+		int age;
+		bool started;
+	};
+
+	bool GetMix(const std::map<int, PlayerOther>& players, int player_id, int volume, int balance, Mix& mix) const;
+
+	std::vector<Pending> pending;
+	std::vector<Playing> playing;
+	int next_tag = 1;
+};
+
+#endif
@@ -85,6 +85,9 @@
 /** File name for additional metadata, such as multi-game save imports. */
 #define META_NAME "Meta.ini"
 
+/** File name of the path index in the save directory, see FileFinder::LoadPathIndex. */
+#define PATH_INDEX_NAME "EasyRPG.pathindex"
+
 /**
  * RPG_RT.exe (official engine) filename.
  * Not used by emscripten.
@@ -31,6 +31,7 @@
 #  include <emscripten.h>
 #endif
 
+#include "asset_manifest.h"
 #include "async_handler.h"
 #include "audio.h"
 #include "cache.h"
@@ -47,6 +48,7 @@
 #include "game_map.h"
 #include "game_enemyparty.h"
 #include "game_ineluki.h"
+#include "game_interpreter_profiler.h"
 #include "game_party.h"
 #include "game_player.h"
 #include "game_switches.h"
@@ -63,9 +65,11 @@
 #include <lcf/ldb/reader.h>
 #include <lcf/lmt/reader.h>
 #include <lcf/lsd/reader.h>
+#include "lazy_database.h"
 #include "main_data.h"
 #include "output.h"
 #include "player.h"
+#include "save_writer.h"
 #include <lcf/reader_lcf.h>
 #include <lcf/reader_util.h>
 #include "scene_battle.h"
@@ -117,6 +121,8 @@ namespace Player {
 	bool no_rtp_flag;
 	std::string rtp_path;
 	bool no_audio_flag;
+	bool lazy_database_flag;
+	bool path_index_flag;
 	bool is_easyrpg_project;
 	std::string encoding;
 	std::string escape_symbol;
@@ -131,6 +137,7 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	std::string profile_events_path;
 	std::string command_line;
 	int rng_seed = -1;
 	Game_ConfigPlayer player_config;
@@ -201,6 +208,10 @@ void Player::Init(std::vector<std::string> args) {
 	Input::Init(cfg.input, replay_input_path, record_input_path);
 	Input::AddRecordingData(Input::RecordingData::CommandLine, command_line);
 
+	if (!profile_events_path.empty()) {
+		Game_Interpreter_Profiler::Init(profile_events_path);
+	}
+
 	player_config = std::move(cfg.player);
 
 	last_auto_screenshot = Game_Clock::now();
@@ -358,6 +369,7 @@ void Player::Update(bool update_scene) {
 
 	Audio().Update();
 	Input::Update();
+	SaveWriter::Update();
 
 	// Game events can query full screen status and change their behavior, so this needs to
 	// be a game key and not a system key.
@@ -427,7 +439,10 @@ void Player::Exit() {
 	auto ret = FileFinder::Root().OpenOutputStream("/tmp/message.png", std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
 	if (ret) Output::TakeScreenshot(ret);
 #endif
+	Game_Interpreter_Profiler::Quit();
+	FileFinder::SavePathIndex();
 	Player::ResetGameObjects();
+	SaveWriter::Quit();
 	Font::Dispose();
 	Graphics::Quit();
 	Output::Quit();
@@ -446,6 +461,8 @@ Game_Config Player::ParseCommandLine() {
 	start_map_id = -1;
 	no_rtp_flag = false;
 	no_audio_flag = false;
+	lazy_database_flag = false;
+	path_index_flag = false;
 	is_easyrpg_project = false;
 	Game_Battle::battle_test.enabled = false;
 
@@ -581,6 +598,27 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--profile-events")) {
+			if (arg.NumValues() > 0) {
+				profile_events_path = arg.Value(0);
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--lazy-database")) {
+			lazy_database_flag = true;
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--path-index")) {
+			path_index_flag = true;
+			continue;
+		}
+		if (cp.ParseNext(arg, 2, "--convert-index")) {
+			if (arg.NumValues() < 2) {
+				Output::Warning("--convert-index requires an input and an output file");
+				exit(EXIT_FAILURE);
+			}
+			exit(ConvertIndex(arg.Value(0), arg.Value(1)) ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
 		/*if (cp.ParseNext(arg, 1, "--load-game-id")) {
 			if (arg.ParseValue(0, li_value)) {
 				load_game_id = li_value;
@@ -724,6 +762,10 @@ void Player::CreateGameObjects() {
 	// Special handling for games with altered files
 	FileFinder::SetGameFilesystem(HookFilesystem::Detect(FileFinder::Game()));
 
+	if (path_index_flag) {
+		FileFinder::LoadPathIndex();
+	}
+
 	// Check for translation-related directories and load language names.
 	translation.InitTranslations();
 
@@ -945,6 +987,9 @@ void Player::RestoreBaseResolution() {
 }
 
 void Player::ResetGameObjects() {
+	// Flush pending savegame writes, they commit the DynRPG plugin state
+	SaveWriter::Wait();
+
 	// The init order is important
 	ManiacPatch::GlobalSave::Save(true);
 
@@ -1037,6 +1082,7 @@ void Player::GuessNonStandardExtensions() {
 void Player::LoadDatabase() {
 	// Load lcf::Database
 	lcf::Data::Clear();
+	LazyDatabase::Clear();
 
 	if (is_easyrpg_project) {
 		std::string edb = FileFinder::Game().FindFile(DATABASE_NAME_EASYRPG);
@@ -1080,7 +1126,9 @@ void Player::LoadDatabase() {
 			return;
 		}
 
-		auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
+		auto db = lazy_database_flag
+			? LazyDatabase::Load(ldb_stream, encoding)
+			: lcf::LDB_Reader::Load(ldb_stream, encoding);
 		if (!db) {
 			Output::ErrorStr(lcf::LcfReader::GetError());
 			return;
@@ -1170,8 +1218,12 @@ static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
 }
 
 void Player::LoadSavegame(const std::string& save_name, int save_id) {
+	SaveWriter::Wait();
 	Output::Debug("Loading Save {}", save_name);
 
+	// The save state refers to animations and common events
+	Game_Map::LoadDeferredDatabase();
+
 	bool load_on_map = Scene::instance->type == Scene::Map;
 
 	if (!load_on_map) {
@@ -1286,6 +1338,8 @@ static void OnMapFileReady(FileRequestResult*) {
 }
 
 void Player::SetupNewGame() {
+	Game_Map::LoadDeferredDatabase();
+
 	Main_Data::game_system->BgmFade(800, true);
 	Main_Data::game_system->ResetFrameCounter();
 	auto title = Scene::Find(Scene::Title);
@@ -1331,6 +1385,8 @@ void Player::SetupBattleTest() {
 		Output::Debug("BattleTest Mode 2k troop=({}) background=({})", args.troop_id, args.background);
 	}
 
+	LazyDatabase::LoadPendingSections();
+
 	auto* troop = lcf::ReaderUtil::GetElement(lcf::Data::troops, args.troop_id);
 	if (troop == nullptr) {
 		Output::Error("BattleTest: Invalid Monster Party ID {}", args.troop_id);
@@ -1364,7 +1420,11 @@ std::string Player::GetEncoding() {
 		std::string ldb = FileFinder::Game().FindFile(fileext_map.MakeFilename(RPG_RT_PREFIX, SUFFIX_LDB));
 		auto ldb_stream = FileFinder::Game().OpenInputStream(ldb);
 		if (ldb_stream) {
-			auto db = lcf::LDB_Reader::Load(ldb_stream);
+			// Detection only needs the system and terms. The deferred sections
+			// are dropped by LoadDatabase.
+			auto db = lazy_database_flag
+				? LazyDatabase::Load(ldb_stream)
+				: lcf::LDB_Reader::Load(ldb_stream);
 			if (db) {
 				std::vector<std::string> encodings = lcf::ReaderUtil::DetectEncodings(*db);
 
@@ -1442,6 +1502,28 @@ std::string Player::GetFullVersionString() {
 	return std::string(GAME_TITLE) + " " + Version::GetVersionString();
 }
 
+bool Player::ConvertIndex(std::string_view in_file, std::string_view out_file) {
+	auto is = FileFinder::Root().OpenInputStream(in_file);
+	if (!is) {
+		Output::Warning("Cannot open {}", in_file);
+		return false;
+	}
+
+	auto os = FileFinder::Root().OpenOutputStream(out_file, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+	if (!os) {
+		Output::Warning("Cannot open {} for writing", out_file);
+		return false;
+	}
+
+	if (!AssetManifest::ConvertJson(is, os)) {
+		Output::Warning("Converting {} failed: Not a valid index.json", in_file);
+		return false;
+	}
+
+	Output::Info("Converted {} to {}", in_file, out_file);
+	return true;
+}
+
 void Player::PrintUsage() {
 	std::cout <<
 R"(EasyRPG Player - An open source interpreter for RPG Maker 2000/2003 games.
@@ -1457,6 +1539,10 @@ Engine options:
                                  skills.
  -c, --config-path P  Set a custom configuration path. When not specified, the
                       configuration folder in the users home directory is used.
+ --convert-index IN OUT
+                      Convert the index.json IN of a web deployment to the
+                      faster binary format, written to OUT, and exit. OUT
+                      replaces index.json on the web server.
  --encoding N         Instead of autodetecting the encoding or using the one in
                       RPG_RT.ini, the encoding N is used.
  --enemyai-algo A     Which EnemyAI algorithm to use.
@@ -1485,6 +1571,9 @@ Engine options:
  --language LANG      Load the game translation in language/LANG folder.
  --language-path PATH Use the translations at PATH instead of the translations
                       in the language folder.
+ --lazy-database      Parse common events, animations and battle data of the
+                      database when a game starts instead of before the title
+                      scene.
  --load-game-id N     Skip the title scene and load SaveN.lsd (N is padded to
                       two digits).
  --log-file FILE      Path to the logfile. The Player will write diagnostic
@@ -1516,6 +1605,12 @@ Engine options:
  --patch-powermode    Enable PowerMode 2003 Patch by Firesta.
  --no-patch           Disable all engine patches. To disable a single patch,
                       prefix any of the patch options with --no-
+ --path-index         Store the directory structure of the game in the save
+                      directory and use it on the next start instead of
+                      scanning the game directories.
+ --profile-events FILE
+                      Record execution counts and times of all events and
+                      write them to FILE when exiting.
  --project-path PATH  Instead of using the working directory, the game in PATH
                       is used.
  --record-input FILE  Record all button inputs to FILE.
@@ -321,6 +321,16 @@ namespace Player {
 	/** @return full version string */
 	std::string GetFullVersionString();
 
+	/**
+	 * Converts the index.json of a web deployment to a binary AssetManifest.
+	 * Used by --convert-index.
+	 *
+	 * @param in_file path to the index.json
+	 * @param out_file path the manifest is written to
+	 * @return whether the conversion succeeded
+	 */
+	bool ConvertIndex(std::string_view in_file, std::string_view out_file);
+
 	/** Output program usage information on stdout */
 	void PrintUsage();
 
@@ -381,6 +391,12 @@ namespace Player {
 	/** Mutes audio playback */
 	extern bool no_audio_flag;
 
+	/** Defers parsing of the large database sections until a game starts */
+	extern bool lazy_database_flag;
+
+	/** Uses a path index of the game directories that is kept in the save directory */
+	extern bool path_index_flag;
+
 	/** Is this project using EasyRPG files, or the RPG_RT format? */
 	extern bool is_easyrpg_project;
 
@@ -399,6 +415,9 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Path to write the event profiler statistics to */
+	extern std::string profile_events_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
@@ -0,0 +1,121 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "save_header.h"
+#include <lcf/lsd/reader.h>
+#include <sstream>
+#include <string>
+
+namespace {
+	constexpr std::string_view lsd_header = "LcfSaveData";
+
+	// Chunk id of lcf::rpg::Save::title
+	constexpr uint32_t chunk_title = 0x64;
+
+	// A title holds four face names and the hero name
+	constexpr uint32_t max_title_size = 4096;
+
+	/** Reads a BER compressed integer and appends its bytes to out */
+	bool ReadBer(std::istream& is, std::string& out, uint32_t& value) {
+		value = 0;
+		for (int i = 0; i < 5; ++i) {
+			const int ch = is.get();
+			if (ch == std::char_traits<char>::eof()) {
+				return false;
+			}
+			out.push_back(static_cast<char>(ch));
+			value = (value << 7) | (ch & 0x7F);
+			if ((ch & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ReadBytes(std::istream& is, std::string& out, uint32_t size) {
+		const size_t offset = out.size();
+		out.resize(offset + size);
+		is.read(&out[offset], size);
+		return static_cast<uint32_t>(is.gcount()) == size;
+	}
+
+	/**
+	 * Checks that the chunks following the title fit into the file.
+	 * Only the chunk headers are read, the data is skipped.
+	 */
+	bool ValidateChunks(std::istream& is) {
+		const auto pos = is.tellg();
+		is.seekg(0, std::ios_base::end);
+		const auto file_size = is.tellg();
+		is.seekg(pos);
+		if (pos < 0 || file_size < 0 || !is) {
+			return false;
+		}
+
+		std::string scratch;
+		uint32_t chunk_id;
+		uint32_t size;
+		for (;;) {
+			if (is.peek() == std::char_traits<char>::eof()) {
+				// Savegames written without the end of struct marker
+				is.clear();
+				return true;
+			}
+			if (!ReadBer(is, scratch, chunk_id)) {
+				return false;
+			}
+			if (chunk_id == 0) {
+				return true;
+			}
+			if (!ReadBer(is, scratch, size) || is.tellg() + static_cast<std::streamoff>(size) > file_size) {
+				return false;
+			}
+			is.seekg(size, std::ios_base::cur);
+			scratch.clear();
+		}
+	}
+}
+
+std::unique_ptr<lcf::rpg::Save> SaveHeader::Load(std::istream& is, std::string_view encoding) {
+	// A savegame containing only the header and the title chunk
+	std::string data;
+
+	uint32_t size;
+	if (!ReadBer(is, data, size) || size != lsd_header.size() || !ReadBytes(is, data, size)
+			|| std::string_view(data).substr(data.size() - size) != lsd_header) {
+		return nullptr;
+	}
+
+	uint32_t chunk_id;
+	if (!ReadBer(is, data, chunk_id) || chunk_id != chunk_title) {
+		return nullptr;
+	}
+	if (!ReadBer(is, data, size) || size > max_title_size || !ReadBytes(is, data, size)) {
+		return nullptr;
+	}
+	data.push_back('\0');
+
+	// A truncated savegame is only noticed when the remaining chunks are compared
+	// against the file size. Then it is parsed completely and marked as corrupted.
+	if (!ValidateChunks(is)) {
+		return nullptr;
+	}
+
+	std::istringstream ss(std::move(data));
+	return lcf::LSD_Reader::Load(ss, encoding);
+}
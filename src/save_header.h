@@ -0,0 +1,48 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_SAVE_HEADER_H
+#define EP_SAVE_HEADER_H
+
+#include <istream>
+#include <memory>
+#include "string_view.h"
+#include <lcf/rpg/save.h>
+
+/**
+ * Reads the title of a savegame without parsing the whole file.
+ *
+ * The title (party faces, hero name and level, timestamp) is the first
+ * chunk of a LSD file. Only the file header and this chunk are parsed, the
+ * remaining chunks are skipped after checking that they fit into the file,
+ * so listing the save slots does not depend on the size of the savegames.
+ */
+namespace SaveHeader {
+	/**
+	 * Parses the title of a savegame.
+	 *
+	 * @param is savegame, must be seekable
+	 * @param encoding encoding of the strings
+	 * @return savegame in which only the title is set, nullptr when the
+	 *   file does not start with a title or is truncated. Then the whole
+	 *   file must be parsed.
+	 */
+	std::unique_ptr<lcf::rpg::Save> Load(std::istream& is, std::string_view encoding);
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "save_writer.h"
+#include <lcf/lsd/reader.h>
+#include <algorithm>
+#include <list>
+#include <sstream>
+#include <vector>
+
+#ifdef HAVE_ASYNC_SAVE
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+#endif
+
+namespace {
+	struct Job {
+		lcf::rpg::Save save;
+		lcf::EngineVersion engine;
+		std::string encoding;
+		SaveWriter::Callback callback;
+		std::string data;
+		bool success = false;
+		bool started = false;
+		bool done = false;
+	};
+
+	/** Queued savegames, oldest first. Elements stay in place while the worker uses them. */
+	std::list<Job> jobs;
+
+	void Run(Job& job) {
+		std::ostringstream os;
+		job.success = lcf::LSD_Reader::Save(os, job.save, job.engine, job.encoding);
+		job.data = os.str();
+		job.save = {};
+	}
+
+#ifdef HAVE_ASYNC_SAVE
+	std::mutex mutex;
+	/** Signals new jobs and shutdown to the worker */
+	std::condition_variable job_cv;
+	/** Signals finished jobs to Wait */
+	std::condition_variable done_cv;
+	bool stop = false;
+
+	void StopWorker(std::thread& thread) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		job_cv.notify_one();
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	/** Joins the thread on exit, a running std::thread must not be destroyed */
+	struct Worker {
+		std::thread thread;
+
+		~Worker() {
+			StopWorker(thread);
+		}
+	} worker;
+
+	void WorkerMain() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			auto it = std::find_if(jobs.begin(), jobs.end(), [](const auto& job) { return !job.started; });
+			if (it == jobs.end()) {
+				if (stop) {
+					return;
+				}
+				job_cv.wait(lock);
+				continue;
+			}
+
+			it->started = true;
+			lock.unlock();
+			Run(*it);
+			lock.lock();
+			it->done = true;
+			done_cv.notify_all();
+		}
+	}
+#endif
+
+	/** Removes the finished jobs at the front of the queue */
+	std::vector<Job> TakeFinished() {
+#ifdef HAVE_ASYNC_SAVE
+		std::lock_guard<std::mutex> lock(mutex);
+#endif
+		std::vector<Job> finished;
+		while (!jobs.empty() && jobs.front().done) {
+			finished.push_back(std::move(jobs.front()));
+			jobs.pop_front();
+		}
+		return finished;
+	}
+}
+
+void SaveWriter::Serialize(lcf::rpg::Save save, lcf::EngineVersion engine, std::string encoding, Callback callback) {
+	Job job;
+	job.save = std::move(save);
+	job.engine = engine;
+	job.encoding = std::move(encoding);
+	job.callback = std::move(callback);
+
+#ifdef HAVE_ASYNC_SAVE
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(std::move(job));
+		if (!worker.thread.joinable()) {
+			stop = false;
+			worker.thread = std::thread(WorkerMain);
+		}
+	}
+	job_cv.notify_one();
+#else
+	Run(job);
+	job.started = true;
+	job.done = true;
+	jobs.push_back(std::move(job));
+#endif
+}
+
+void SaveWriter::Update() {
+	for (auto& job: TakeFinished()) {
+		if (job.callback) {
+			job.callback(job.success, job.data);
+		}
+	}
+}
+
+void SaveWriter::Wait() {
+#ifdef HAVE_ASYNC_SAVE
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done_cv.wait(lock, [] {
+			return std::all_of(jobs.begin(), jobs.end(), [](const auto& job) { return job.done; });
+		});
+	}
+#endif
+	Update();
+}
+
+int SaveWriter::GetPendingCount() {
+#ifdef HAVE_ASYNC_SAVE
+	std::lock_guard<std::mutex> lock(mutex);
+#endif
+	return static_cast<int>(jobs.size());
+}
+
+void SaveWriter::Quit() {
+	Wait();
+
+#ifdef HAVE_ASYNC_SAVE
+	StopWorker(worker.thread);
+#endif
+}
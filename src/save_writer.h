@@ -0,0 +1,68 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EP_SAVE_WRITER_H
+#define EP_SAVE_WRITER_H
+
+#include <functional>
+#include <string>
+#include "string_view.h"
+#include <lcf/rpg/save.h>
+#include <lcf/saveopt.h>
+
+/**
+ * Serializes savegames in the background.
+ *
+ * The game state is copied into a lcf::rpg::Save on the main thread and
+ * handed over. The expensive LSD serialization then runs on a worker
+ * thread when the Player is built with HAVE_ASYNC_SAVE. The callbacks
+ * always run on the main thread, in the order the savegames were queued.
+ */
+namespace SaveWriter {
+	/**
+	 * Receives a serialized savegame on the main thread.
+	 *
+	 * @param success whether serialization succeeded
+	 * @param data content of the LSD file
+	 */
+	using Callback = std::function<void(bool success, std::string_view data)>;
+
+	/**
+	 * Queues a savegame for serialization.
+	 *
+	 * @param save snapshot of the game state
+	 * @param engine engine the savegame is written for
+	 * @param encoding encoding of the strings
+	 * @param callback invoked by Update or Wait when serialized
+	 */
+	void Serialize(lcf::rpg::Save save, lcf::EngineVersion engine, std::string encoding, Callback callback);
+
+	/** Invokes the callbacks of the serialized savegames. Called once per frame. */
+	void Update();
+
+	/** Blocks until all queued savegames are serialized and invokes their callbacks */
+	void Wait();
+
+	/** @return number of savegames whose callback did not run yet */
+	int GetPendingCount();
+
+	/** Waits for all queued savegames and stops the worker thread */
+	void Quit();
+}
+
+#endif
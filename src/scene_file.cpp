@@ -26,6 +26,8 @@
 #include "input.h"
 #include <lcf/lsd/reader.h>
 #include "player.h"
+#include "save_header.h"
+#include "save_writer.h"
 #include "scene_file.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
@@ -103,7 +105,13 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 			return;
 		}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		// Only the title is shown, skip parsing the rest of the savegame
+		std::unique_ptr<lcf::rpg::Save> savegame = SaveHeader::Load(save_stream, Player::encoding);
+		if (!savegame) {
+			save_stream.clear();
+			save_stream.seekg(0, std::ios::beg);
+			savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		}
 
 		if (savegame) {
 			PopulatePartyFaces(win, id, *savegame);
@@ -119,7 +127,8 @@ void Scene_File::Start() {
 	CreateHelpWindow();
 	border_top = Scene_File::MakeBorderSprite(32);
 
-	// Refresh File Finder Save Folder
+	// Finish background saves and refresh File Finder Save Folder
+	SaveWriter::Wait();
 	fs = FileFinder::Save();
 
 	for (int i = 0; i < Main_Data::game_constants->MaxSaveFiles(); i++) {
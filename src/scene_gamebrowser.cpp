@@ -22,6 +22,7 @@
 #include "options.h"
 #include "scene_settings.h"
 #include "audio_midi.h"
+#include "audio_midi_cache.h"
 #include "audio_secache.h"
 #include "cache.h"
 #include "game_system.h"
@@ -50,6 +51,7 @@ void Scene_GameBrowser::Continue(SceneType /* prev_scene */) {
 
 	Cache::ClearAll();
 	AudioSeCache::Clear();
+	AudioMidiCache::Clear();
 	MidiDecoder::Reset();
 	lcf::Data::Clear();
 	Player::ResetGameObjects();
@@ -395,10 +395,13 @@ void Scene_Map::OnAsyncSuspend(F&& f, AsyncOp aop, bool is_preupdate) {
 
 	if (aop.GetType() == AsyncOp::eSave) {
 		auto savefs = FileFinder::Save();
-		bool success = Scene_Save::Save(savefs, aop.GetSaveSlot());
 		if (aop.GetSaveResultVar() > 0) {
+			// The event reads the result right away
+			bool success = Scene_Save::Save(savefs, aop.GetSaveSlot());
 			Main_Data::game_variables->Set(aop.GetSaveResultVar(), success ? 1 : 0);
 			Game_Map::SetNeedRefresh(true);
+		} else {
+			Scene_Save::SaveAsync(savefs, aop.GetSaveSlot());
 		}
 	}
 
@@ -41,6 +41,7 @@
 #include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
+#include "save_writer.h"
 #include "scene_save.h"
 #include "translation.h"
 #include "version.h"
@@ -60,7 +61,7 @@ void Scene_Save::Start() {
 }
 
 void Scene_Save::Action(int index) {
-	Save(fs, index + 1);
+	SaveAsync(fs, index + 1);
 
 	Scene::Pop();
 }
@@ -77,6 +78,9 @@ std::string Scene_Save::GetSaveFilename(const FilesystemView& fs, int slot_id) {
 }
 
 bool Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save) {
+	// A pending background save of the same slot must not overwrite this one
+	SaveWriter::Wait();
+
 	const auto filename = GetSaveFilename(fs, slot_id);
 	Output::Debug("Saving to {}", filename);
 
@@ -90,7 +94,7 @@ bool Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save)
 	return Save(save_stream, slot_id, prepare_save);
 }
 
-bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+lcf::rpg::Save Scene_Save::CreateSaveData(int slot_id, bool prepare_save) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -153,16 +157,62 @@ bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 			sme.map_id = 0;
 		}
 	}
-	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
-	bool res = lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
 
-	Main_Data::game_dynrpg->Save(slot_id);
+	return save;
+}
+
+bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	auto save = CreateSaveData(slot_id, prepare_save);
+
+	bool res = lcf::LSD_Reader::Save(os, save, GetLcfEngine(), Player::encoding);
+
+	if (res) {
+		Main_Data::game_dynrpg->Save(slot_id);
+	}
 
 	AsyncHandler::SaveFilesystem(slot_id);
 
 	return res;
 }
 
+void Scene_Save::SaveAsync(const FilesystemView& fs, int slot_id, std::function<void(bool)> callback) {
+	auto filename = GetSaveFilename(fs, slot_id);
+	Output::Debug("Saving to {} in the background", filename);
+
+	// Plugin state must match the snapshot, not the state when the write finished
+	auto dynrpg_data = Main_Data::game_dynrpg->CreateSaveData();
+
+	auto on_serialized = [filename, slot_id, dynrpg_data = std::move(dynrpg_data), callback = std::move(callback)](bool success, std::string_view data) {
+		if (success) {
+			auto save_stream = FileFinder::Save().OpenOutputStream(filename);
+			if (save_stream) {
+				save_stream.write(data.data(), data.size());
+				success = save_stream.good();
+			} else {
+				success = false;
+			}
+		}
+
+		if (success) {
+			Main_Data::game_dynrpg->WriteSaveData(slot_id, dynrpg_data);
+		} else {
+			Output::Warning("Failed saving to {}", filename);
+		}
+
+		AsyncHandler::SaveFilesystem(slot_id);
+
+		if (callback) {
+			callback(success);
+		}
+	};
+
+	SaveWriter::Serialize(CreateSaveData(slot_id, true), GetLcfEngine(), Player::encoding, std::move(on_serialized));
+}
+
+lcf::EngineVersion Scene_Save::GetLcfEngine() {
+	return Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+}
+
 bool Scene_Save::IsSlotValid(int) {
 	return true;
 }
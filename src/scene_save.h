@@ -19,9 +19,12 @@
 #define EP_SCENE_SAVE_H
 
 // Headers
+#include <functional>
 #include <vector>
 #include "scene.h"
 #include "scene_file.h"
+#include <lcf/rpg/save.h>
+#include <lcf/saveopt.h>
 
 /**
  * Scene_Item class.
@@ -42,6 +45,29 @@ public:
 	static std::string GetSaveFilename(const FilesystemView& tree, int slot_id);
 	static bool Save(const FilesystemView& tree, int slot_id, bool prepare_save = true);
 	static bool Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Saves the game without blocking on the serialization.
+	 * The game state is captured immediately, the file is written by a
+	 * later SaveWriter::Update.
+	 *
+	 * @param tree save directory
+	 * @param slot_id save slot
+	 * @param callback invoked with the result after the file was written
+	 */
+	static void SaveAsync(const FilesystemView& tree, int slot_id, std::function<void(bool)> callback = {});
+
+	/**
+	 * Captures the current game state.
+	 *
+	 * @param slot_id save slot
+	 * @param prepare_save whether to update the save count and version
+	 * @return savegame
+	 */
+	static lcf::rpg::Save CreateSaveData(int slot_id, bool prepare_save = true);
+
+	/** @return LSD format of the simulated engine */
+	static lcf::EngineVersion GetLcfEngine();
 };
 
 #endif
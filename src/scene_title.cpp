@@ -25,6 +25,7 @@
 #include "scene_title.h"
 #include "scene_language.h"
 #include "audio.h"
+#include "audio_midi_cache.h"
 #include "audio_secache.h"
 #include "cache.h"
 #include "game_battle.h"
@@ -89,6 +90,7 @@ void Scene_Title::Continue(SceneType prev_scene) {
 		// e.g. by pressing F12, except the Title Load menu
 		Cache::ClearAll();
 		AudioSeCache::Clear();
+		AudioMidiCache::Clear();
 
 		Player::ResetGameObjects();
 		if (Player::IsPatchKeyPatch()) {
@@ -97,6 +97,7 @@
 #  define SUPPORT_JOYSTICK_AXIS
 #  define SUPPORT_FILE_BROWSER
 #  define SYSTEM_DESKTOP_LINUX_BSD_MACOS
+#  define USE_MMAP
 #endif
 
 #ifdef USE_SDL
@@ -108,7 +109,7 @@
 #  define JOYSTICK_TRIGGER_SENSIBILITY 0.2
 #endif
 
-#if defined(HAVE_LIBSAMPLERATE) || defined(HAVE_LIBSPEEXDSP)
+#if defined(HAVE_LIBSAMPLERATE) || defined(HAVE_LIBSPEEXDSP) || defined(WANT_BUILTIN_RESAMPLER)
 #  define USE_AUDIO_RESAMPLER
 #endif
 
@@ -32,6 +32,7 @@
 #include "main_data.h"
 #include "game_actors.h"
 #include "game_map.h"
+#include "lazy_database.h"
 #include "player.h"
 #include "output.h"
 #include "utils.h"
@@ -222,6 +223,8 @@ void Translation::SelectLanguageAsync(FileRequestResult*, std::string_view lang_
 	// Rewrite our database+messages (unless we are on the Default language).
 	// Note that map Message boxes are changed on map load, to avoid slowdown here.
 	if (!current_language.lang_dir.empty()) {
+		// The rewrite covers the deferred sections as well
+		LazyDatabase::LoadPendingSections();
 		RewriteDatabase();
 		RewriteTreemapNames();
 		RewriteBattleEventMessages();
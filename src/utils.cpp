@@ -558,6 +558,18 @@ void Utils::SwapByteOrder(uint32_t& ui) {
 #endif
 }
 
+void Utils::SwapByteOrder(uint64_t& ul) {
+#ifdef WORDS_BIGENDIAN
+	uint32_t lo = static_cast<uint32_t>(ul);
+	uint32_t hi = static_cast<uint32_t>(ul >> 32);
+	SwapByteOrder(lo);
+	SwapByteOrder(hi);
+	ul = (static_cast<uint64_t>(lo) << 32) | hi;
+#else
+	(void)ul;
+#endif
+}
+
 void Utils::SwapByteOrder(double& d) {
 #ifdef WORDS_BIGENDIAN
 	uint32_t *p = reinterpret_cast<uint32_t *>(&d);
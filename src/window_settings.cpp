@@ -344,6 +344,10 @@ void Window_Settings::RefreshAudioMidi() {
 		}
 	}
 
+	if (cfg.midi_prerender.IsOptionVisible()) {
+		AddOption(cfg.midi_prerender, []() { Audio().SetMidiPrerenderEnabled(Audio().GetConfig().midi_prerender.Toggle()); });
+	}
+
 	AddOption(MenuItem("> Information <", "The first active and working option is used for MIDI", ""), [](){});
 	GetFrame().options.back().help2 = "Changes take effect when a new MIDI file is played";
 }
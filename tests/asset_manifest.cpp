@@ -0,0 +1,135 @@
+#include "asset_manifest.h"
+#include "doctest.h"
+#include <sstream>
+#include <string>
+
+static AssetManifest::Entries MakeEntries(int num_dirs, int num_files) {
+	AssetManifest::Entries entries;
+	for (int i = 0; i < num_dirs; ++i) {
+		for (int j = 0; j < num_files; ++j) {
+			auto name = "Dir" + std::to_string(i) + "/File" + std::to_string(j) + ".png";
+			entries.emplace_back("dir" + std::to_string(i) + "/file" + std::to_string(j) + ".png", name);
+		}
+	}
+	return entries;
+}
+
+TEST_SUITE_BEGIN("AssetManifest");
+
+TEST_CASE("Empty") {
+	AssetManifest manifest;
+	CHECK(manifest.empty());
+	CHECK_EQ(manifest.size(), 0);
+	CHECK_FALSE(manifest.Find("rpg_rt.ldb"));
+	CHECK(AssetManifest::IsManifest(manifest.GetData()));
+}
+
+TEST_CASE("Find") {
+	auto manifest = AssetManifest::Build(MakeEntries(20, 50), 2);
+	REQUIRE_EQ(manifest.size(), 1000);
+	CHECK_EQ(manifest.GetIndexVersion(), 2);
+
+	for (int i = 0; i < 20; ++i) {
+		for (int j = 0; j < 50; ++j) {
+			auto value = manifest.Find("dir" + std::to_string(i) + "/file" + std::to_string(j) + ".png");
+			REQUIRE(value);
+			REQUIRE_EQ(*value, "Dir" + std::to_string(i) + "/File" + std::to_string(j) + ".png");
+		}
+	}
+
+	CHECK_FALSE(manifest.Find(""));
+	CHECK_FALSE(manifest.Find("dir0"));
+	CHECK_FALSE(manifest.Find("dir0/file0"));
+	CHECK_FALSE(manifest.Find("Dir0/File0.png"));
+	CHECK_FALSE(manifest.Find("dir20/file0.png"));
+}
+
+TEST_CASE("Duplicates") {
+	auto manifest = AssetManifest::Build({ { "b", "1" }, { "a", "2" }, { "b", "3" } }, 1);
+	CHECK_EQ(manifest.size(), 2);
+	CHECK_EQ(*manifest.Find("a"), "2");
+	CHECK_EQ(*manifest.Find("b"), "3");
+}
+
+TEST_CASE("ForEach") {
+	auto manifest = AssetManifest::Build({ { "charset/hero.png", "CharSet/Hero.png" }, { "meta.ini", "Meta.ini" }, { "charset/enemy.png", "CharSet/Enemy.png" } }, 2);
+
+	std::string keys;
+	std::string values;
+	manifest.ForEach([&](std::string_view key, std::string_view value) {
+		keys += std::string(key) + ";";
+		values += std::string(value) + ";";
+	});
+	CHECK_EQ(keys, "charset/enemy.png;charset/hero.png;meta.ini;");
+	CHECK_EQ(values, "CharSet/Enemy.png;CharSet/Hero.png;Meta.ini;");
+}
+
+TEST_CASE("FromData") {
+	auto manifest = AssetManifest::Build(MakeEntries(5, 40), 2);
+	auto loaded = AssetManifest::FromData(manifest.GetData());
+	REQUIRE(loaded);
+	CHECK_EQ(loaded->size(), 200);
+	CHECK_EQ(loaded->GetIndexVersion(), 2);
+	CHECK_EQ(*loaded->Find("dir4/file39.png"), "Dir4/File39.png");
+
+	CHECK_FALSE(AssetManifest::FromData(""));
+	CHECK_FALSE(AssetManifest::FromData("{\"cache\": {}}"));
+	CHECK_FALSE(AssetManifest::FromData(manifest.GetData().substr(0, 40)));
+
+	// Damaged entries are not found
+	auto data = manifest.GetData();
+	data.resize(data.size() - 100);
+	auto truncated = AssetManifest::FromData(data);
+	REQUIRE(truncated);
+	CHECK_FALSE(truncated->Find("dir4/file39.png"));
+	CHECK_EQ(*truncated->Find("dir0/file0.png"), "Dir0/File0.png");
+}
+
+#ifdef HAVE_NLOHMANN_JSON
+TEST_CASE("FromJson") {
+	auto legacy = AssetManifest::FromJson(R"({ "rpg_rt.ldb": "RPG_RT.ldb", "charset/hero.png": "CharSet/Hero.png" })");
+	REQUIRE(legacy);
+	CHECK_EQ(legacy->GetIndexVersion(), 1);
+	CHECK_EQ(legacy->size(), 2);
+	CHECK_EQ(*legacy->Find("charset/hero.png"), "CharSet/Hero.png");
+
+	auto manifest = AssetManifest::FromJson(R"({
+		"metadata": { "version": 2 },
+		"cache": {
+			"rpg_rt.ldb": "RPG_RT.ldb",
+			"charset": {
+				"_dirname": "CharSet",
+				"hero": "Hero.png",
+				"sub": { "_dirname": "Sub", "a": "A.png" }
+			}
+		}
+	})");
+	REQUIRE(manifest);
+	CHECK_EQ(manifest->GetIndexVersion(), 2);
+	CHECK_EQ(manifest->size(), 3);
+	CHECK_EQ(*manifest->Find("rpg_rt.ldb"), "RPG_RT.ldb");
+	CHECK_EQ(*manifest->Find("charset/hero"), "CharSet/Hero.png");
+	CHECK_EQ(*manifest->Find("charset/sub/a"), "CharSet/Sub/A.png");
+	CHECK_FALSE(manifest->Find("charset/_dirname"));
+
+	CHECK_FALSE(AssetManifest::FromJson("{ invalid"));
+}
+
+TEST_CASE("ConvertJson") {
+	std::istringstream is(R"({ "metadata": { "version": 2 }, "cache": { "title": { "_dirname": "Title", "title": "Title.png" } } })");
+	std::ostringstream os;
+	REQUIRE(AssetManifest::ConvertJson(is, os));
+
+	auto manifest = AssetManifest::FromData(os.str());
+	REQUIRE(manifest);
+	CHECK_EQ(manifest->GetIndexVersion(), 2);
+	CHECK_EQ(*manifest->Find("title/title"), "Title/Title.png");
+
+	std::istringstream invalid("{ invalid");
+	std::ostringstream invalid_os;
+	CHECK_FALSE(AssetManifest::ConvertJson(invalid, invalid_os));
+	CHECK(invalid_os.str().empty());
+}
+#endif
+
+TEST_SUITE_END();
@@ -0,0 +1,108 @@
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "audio_midi_cache.h"
+#include "doctest.h"
+
+#ifdef WANT_FMMIDI
+#  include "audio_decoder_midi.h"
+#  include "audio_midi.h"
+#  include "decoder_fmmidi.h"
+#endif
+
+TEST_SUITE_BEGIN("AudioMidiCache");
+
+#ifdef WANT_FMMIDI
+namespace {
+// Sets the channel volume and holds a single note for 5 seconds
+std::vector<uint8_t> MakeMidi() {
+	return {
+		'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, 0, 96,
+		'M', 'T', 'r', 'k', 0, 0, 0, 17,
+		0x00, 0xB0, 0x07, 0x7F,
+		0x00, 0x90, 0x3C, 0x64,
+		0x87, 0x40, 0x80, 0x3C, 0x40,
+		0x00, 0xFF, 0x2F, 0x00
+	};
+}
+
+std::unique_ptr<AudioDecoderMidi> MakeLiveDecoder(int volume) {
+	auto dec = std::make_unique<AudioDecoderMidi>(std::make_unique<FmMidiDecoder>());
+	Filesystem_Stream::InputStream is(new Filesystem_Stream::InputMemoryStreamBuf(MakeMidi()), "test.mid");
+	REQUIRE(dec->Open(std::move(is)));
+	REQUIRE(dec->SetFormat(EP_MIDI_FREQ, AudioDecoderBase::Format::S16, 2));
+	dec->SetVolume(volume);
+	return dec;
+}
+
+std::vector<uint8_t> Render(AudioDecoderBase& dec) {
+	std::vector<uint8_t> out(EP_MIDI_FREQ * 2 * sizeof(int16_t));
+	REQUIRE_EQ(dec.Decode(out.data(), out.size()), out.size());
+	return out;
+}
+
+// Level after the mixer applied the volume of the decoder
+double Level(AudioDecoderBase& dec) {
+	auto pcm = Render(dec);
+	auto* samples = reinterpret_cast<const int16_t*>(pcm.data());
+	size_t num_samples = pcm.size() / sizeof(int16_t);
+
+	// Skip the attack of the note
+	double sum = 0.0;
+	for (size_t i = num_samples / 4; i < num_samples; ++i) {
+		sum += static_cast<double>(samples[i]) * samples[i];
+	}
+	double rms = std::sqrt(sum / (num_samples - num_samples / 4));
+	return rms * dec.GetVolume().left_volume / 100.0;
+}
+}
+
+TEST_CASE("Volume matches live playback") {
+	auto data = std::make_shared<AudioMidiData>();
+	auto render = MakeLiveDecoder(100);
+	data->midi_volume = render->SupportsMidiMessages();
+	data->buffer = Render(*render);
+	REQUIRE(data->midi_volume);
+
+	for (int volume : { 100, 75, 50, 25 }) {
+		auto live = MakeLiveDecoder(volume);
+		AudioMidiDecoder cached(data);
+		cached.SetVolume(volume);
+
+		double live_level = Level(*live);
+		double cached_level = Level(cached);
+		REQUIRE_GT(live_level, 0.0);
+
+		INFO("Volume ", volume, ": live ", live_level, ", cached ", cached_level);
+		CHECK_LT(std::abs(20.0 * std::log10(cached_level / live_level)), 0.1);
+	}
+}
+
+#endif
+
+TEST_CASE("Volume without MIDI messages") {
+	auto data = std::make_shared<AudioMidiData>();
+	data->midi_volume = false;
+
+	AudioMidiDecoder dec(data);
+	for (int volume : { 100, 75, 50, 25, 0 }) {
+		dec.SetVolume(volume);
+		CHECK_EQ(dec.GetVolume().left_volume, doctest::Approx(AudioDecoderBase::AdjustVolume(volume)));
+		CHECK_EQ(dec.GetVolume().right_volume, doctest::Approx(AudioDecoderBase::AdjustVolume(volume)));
+	}
+}
+
+TEST_CASE("Fade") {
+	auto data = std::make_shared<AudioMidiData>();
+	AudioMidiDecoder dec(data);
+
+	dec.SetVolume(100);
+	dec.SetFade(0, std::chrono::milliseconds(1000));
+	dec.Update(std::chrono::milliseconds(500));
+	// Half of the volume is about a quarter of the gain
+	CHECK_EQ(dec.GetVolume().left_volume, doctest::Approx(100.0 * std::pow(63.0 / 127.0, 2)));
+	dec.Update(std::chrono::milliseconds(500));
+	CHECK_EQ(dec.GetVolume().left_volume, doctest::Approx(0.0f));
+}
+
+TEST_SUITE_END();
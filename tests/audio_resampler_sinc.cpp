@@ -0,0 +1,144 @@
+#include <cmath>
+#include <vector>
+#include "audio_resampler_sinc.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("SincResampler");
+
+namespace {
+constexpr double amplitude = 0.5;
+
+std::vector<float> MakeSine(int frames, int channels, double freq, double rate) {
+	std::vector<float> out(frames * channels);
+	for (int i = 0; i < frames; ++i) {
+		for (int c = 0; c < channels; ++c) {
+			out[i * channels + c] = amplitude * std::sin(2 * M_PI * freq * i / rate);
+		}
+	}
+	return out;
+}
+
+// Feeds the input in small chunks like the AudioResampler does
+std::vector<float> Resample(SincResampler& r, const std::vector<float>& in, int channels) {
+	std::vector<float> out;
+	std::vector<float> buf(300 * channels);
+	int pos = 0;
+	int frames = in.size() / channels;
+	while (true) {
+		int in_frames = std::min(128, frames - pos);
+		int out_frames = 300;
+		r.Process(&in[pos * channels], in_frames, buf.data(), out_frames);
+		pos += in_frames;
+		out.insert(out.end(), buf.begin(), buf.begin() + out_frames * channels);
+		if (out_frames == 0) {
+			break;
+		}
+	}
+	return out;
+}
+
+// Signal to noise ratio against the ideal sine in dB
+double Snr(const std::vector<float>& out, int channels, double freq, double rate) {
+	double err = 0.0;
+	double sig = 0.0;
+	int frames = out.size() / channels;
+	for (int i = 100; i < frames - 100; ++i) {
+		double ideal = amplitude * std::sin(2 * M_PI * freq * i / rate);
+		for (int c = 0; c < channels; ++c) {
+			double d = out[i * channels + c] - ideal;
+			err += d * d;
+			sig += ideal * ideal;
+		}
+	}
+	return 10 * std::log10(sig / err);
+}
+
+void TestQuality(SincResampler::Quality quality, double min_snr) {
+	for (auto rates: { std::make_pair(22050, 44100), std::make_pair(32000, 44100), std::make_pair(48000, 44100) }) {
+		SincResampler r(2, quality);
+		r.SetRate(rates.first, rates.second);
+		auto out = Resample(r, MakeSine(rates.first, 2, 1000, rates.first), 2);
+
+		// Only the latency of half a filter is missing at the end
+		REQUIRE_LE(static_cast<int>(out.size() / 2), rates.second);
+		REQUIRE_GE(static_cast<int>(out.size() / 2), rates.second - r.GetTaps());
+		REQUIRE_GT(Snr(out, 2, 1000, rates.second), min_snr);
+	}
+}
+}
+
+TEST_CASE("Linear") {
+	TestQuality(SincResampler::Quality::Linear, 25);
+}
+
+TEST_CASE("Low") {
+	TestQuality(SincResampler::Quality::Low, 50);
+}
+
+TEST_CASE("Medium") {
+	TestQuality(SincResampler::Quality::Medium, 70);
+}
+
+TEST_CASE("High") {
+	TestQuality(SincResampler::Quality::High, 90);
+}
+
+TEST_CASE("LinearIntegerRatio") {
+	// Upsampling by 2 keeps every input sample and places the mean between them
+	SincResampler r(1, SincResampler::Quality::Linear);
+	r.SetRate(1, 2);
+
+	std::vector<float> in = { 0.0f, 0.5f, 1.0f, -1.0f };
+	std::vector<float> out(8);
+	int in_frames = in.size();
+	int out_frames = out.size();
+	r.Process(in.data(), in_frames, out.data(), out_frames);
+
+	// The last input frame is the right neighbour of the next output frame
+	REQUIRE_EQ(out_frames, 6);
+	REQUIRE_EQ(out[0], 0.0f);
+	REQUIRE_EQ(out[1], 0.25f);
+	REQUIRE_EQ(out[2], 0.5f);
+	REQUIRE_EQ(out[3], 0.75f);
+	REQUIRE_EQ(out[4], 1.0f);
+	REQUIRE_EQ(out[5], 0.0f);
+}
+
+TEST_CASE("ConsumesOnlyNeededInput") {
+	SincResampler r(2, SincResampler::Quality::Low);
+	r.SetRate(2, 1);
+
+	auto in = MakeSine(1000, 2, 1000, 44100);
+	int in_frames = 1000;
+	int out_frames = 10;
+	r.Process(in.data(), in_frames, std::vector<float>(20).data(), out_frames);
+
+	REQUIRE_EQ(out_frames, 10);
+	REQUIRE_LT(in_frames, 1000);
+	REQUIRE_LE(in_frames, 10 * 2 + r.GetTaps());
+}
+
+TEST_CASE("RateChange") {
+	// Pitch changes during playback must not lose the stream position
+	SincResampler r(1, SincResampler::Quality::Medium);
+	r.SetRate(22050, 44100);
+
+	auto in = MakeSine(22050, 1, 440, 22050);
+	std::vector<float> out(88200);
+	int in_frames = 11025;
+	int out_frames = 88200;
+	r.Process(in.data(), in_frames, out.data(), out_frames);
+	int first_in = in_frames;
+	int first_out = out_frames;
+
+	r.SetRate(22050 * 2, 44100);
+	in_frames = 22050 - first_in;
+	out_frames = 88200 - first_out;
+	r.Process(&in[first_in], in_frames, &out[first_out], out_frames);
+
+	REQUIRE_EQ(first_in + in_frames, 22050);
+	REQUIRE_GE(out_frames, 11025 - r.GetTaps());
+	REQUIRE_LE(out_frames, 11025 + r.GetTaps());
+}
+
+TEST_SUITE_END();
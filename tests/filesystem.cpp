@@ -3,6 +3,8 @@
 #include "main_data.h"
 #include "doctest.h"
 #include "player.h"
+#include <cstdio>
+#include <sstream>
 
 TEST_SUITE_BEGIN("Filesystem");
 
@@ -88,4 +90,88 @@ TEST_CASE("FindFile") {
 	Player::escape_symbol = "";
 }
 
+TEST_CASE("PathIndex") {
+	auto ext = Utils::MakeSvArray(".png");
+	std::stringstream ss;
+
+	{
+		auto fs = FileFinder::Root().Create(EP_TEST_PATH "/filesystem/test.zip");
+		REQUIRE(!fs.FindFile("game/charset", "chara1", ext).empty());
+		REQUIRE(fs.GetOwner().SaveIndex(ss));
+	}
+
+	const auto index = ss.str();
+
+	auto fs = FileFinder::Root().Create(EP_TEST_PATH "/filesystem/test.zip");
+	REQUIRE(fs.GetOwner().LoadIndex(ss));
+	CHECK(!fs.FindFile("game/charset", "chara1", ext).empty());
+	CHECK(!fs.FindFile("game/exfont", ext).empty());
+	CHECK(fs.FindFile("game/charset", "!!!nonexistant!!!").empty());
+	CHECK(!fs.FindFile("game/charset", "chara1", ext).empty());
+
+	std::stringstream invalid("!!!invalid!!!");
+	CHECK(!fs.GetOwner().LoadIndex(invalid));
+
+	std::stringstream truncated(index.substr(0, index.size() - 1));
+	CHECK(!fs.GetOwner().LoadIndex(truncated));
+}
+
+TEST_CASE("PathIndex: Removed file") {
+	auto root = FileFinder::Root();
+	REQUIRE(root.MakeDirectory("path_index_test/Title", false));
+	REQUIRE(root.OpenOutputStream("path_index_test/Title/Title.png"));
+
+	auto fs = root.Create("path_index_test");
+	REQUIRE(fs);
+	auto ext = Utils::MakeSvArray(".bmp", ".png");
+	REQUIRE(!fs.FindFile("title/title", ext).empty());
+
+	std::stringstream ss;
+	REQUIRE(fs.GetOwner().SaveIndex(ss));
+
+	// Game was patched after the index was written
+	REQUIRE(std::rename("path_index_test/Title/Title.png", "path_index_test/Title/title.bmp") == 0);
+
+	fs.GetOwner().ClearCache("");
+	REQUIRE(fs.GetOwner().LoadIndex(ss));
+
+	auto name = std::get<1>(FileFinder::GetPathAndFilename(fs.FindFile("title/title", ext)));
+	CHECK(name == "title.bmp");
+	CHECK(fs.FindFile("title/title.png").empty());
+
+	std::remove("path_index_test/Title/title.bmp");
+	std::remove("path_index_test/Title");
+	std::remove("path_index_test");
+	fs.GetOwner().ClearCache("");
+}
+
+TEST_CASE("PathIndex: Added file") {
+	auto root = FileFinder::Root();
+	REQUIRE(root.MakeDirectory("path_index_test/Title", false));
+	REQUIRE(root.OpenOutputStream("path_index_test/Title/Title.png"));
+
+	auto fs = root.Create("path_index_test");
+	REQUIRE(fs);
+	REQUIRE(!fs.FindFile("title/title.png").empty());
+
+	std::stringstream ss;
+	REQUIRE(fs.GetOwner().SaveIndex(ss));
+	fs.GetOwner().ClearCache("");
+	REQUIRE(fs.GetOwner().LoadIndex(ss));
+
+	// Verifies the directory of the index
+	CHECK(!fs.FindFile("title/title.png").empty());
+	CHECK(!fs.FindFile("title/title.png").empty());
+
+	// A file missing in a verified directory still enumerates it again
+	REQUIRE(root.OpenOutputStream("path_index_test/Title/Title2.png"));
+	CHECK(!fs.FindFile("title/title2.png").empty());
+
+	std::remove("path_index_test/Title/Title.png");
+	std::remove("path_index_test/Title/Title2.png");
+	std::remove("path_index_test/Title");
+	std::remove("path_index_test");
+	fs.GetOwner().ClearCache("");
+}
+
 TEST_SUITE_END();
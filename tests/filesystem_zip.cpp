@@ -3,9 +3,11 @@
 #include "main_data.h"
 #include "doctest.h"
 #include "player.h"
+#include <fmt/format.h>
 
 #define ZIP_PATH EP_TEST_PATH "/filesystem/test.zip"
 #define ZIP_FOLDER_PATH EP_TEST_PATH "/filesystem/folder.zip"
+#define ZIP64_PATH EP_TEST_PATH "/filesystem/zip64.zip"
 
 TEST_SUITE_BEGIN("Filesystem ZIP");
 
@@ -67,4 +69,53 @@ TEST_CASE("File IO error") {
 	CHECK(!fs.OpenOutputStream("not_supported"));
 }
 
+TEST_CASE("Zip64") {
+	auto fs = FileFinder::Root().Create(ZIP64_PATH);
+	REQUIRE(fs);
+	CHECK(fs.GetFilesize("large") == 400 * 4096);
+
+	auto is = fs.OpenInputStream("text");
+	CHECK(is);
+
+	std::string line_out;
+	CHECK(Utils::ReadLine(is, line_out));
+	CHECK(line_out == "hello");
+	CHECK(Utils::ReadLine(is, line_out));
+	CHECK(line_out == "world");
+}
+
+TEST_CASE("Large file seeking") {
+	// Every 4096 byte block of "large" starts with "block <index>"
+	auto fs = FileFinder::Root().Create(ZIP64_PATH);
+	auto is = fs.OpenInputStream("large");
+	REQUIRE(is);
+	CHECK(is.GetSize() == 400 * 4096);
+
+	std::string line_out;
+	auto check_block = [&](int block) {
+		CHECK(Utils::ReadLine(is, line_out));
+		CHECK(line_out == fmt::format("block {:06d}", block));
+	};
+
+	is.seekg(300 * 4096);
+	check_block(300);
+
+	// Backwards, before and after a checkpoint
+	is.seekg(10 * 4096, std::ios_base::beg);
+	check_block(10);
+	is.seekg(260 * 4096, std::ios_base::beg);
+	check_block(260);
+
+	is.seekg(-4096, std::ios_base::end);
+	check_block(399);
+	CHECK(is.tellg() == 399 * 4096 + 13);
+
+	is.seekg(4096 - 13, std::ios_base::cur);
+	CHECK(is.peek() == EOF);
+
+	is.clear();
+	is.seekg(0);
+	check_block(0);
+}
+
 TEST_SUITE_END();
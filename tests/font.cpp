@@ -88,6 +88,29 @@ TEST_CASE("FontGlyphChar") {
 	check(U'下', Point(cwf, 0));
 }
 
+TEST_CASE("FontGlyphCache") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto system = Cache::SysBlack();
+	auto render = [&](char32_t glyph) {
+		auto surface = Bitmap::Create(cwf * 2, ch * 2);
+		font->Render(*surface, 1, 1, *system, 0, glyph);
+		auto* pixels = reinterpret_cast<uint8_t*>(surface->pixels());
+		return std::vector<uint8_t>(pixels, pixels + surface->pitch() * surface->height());
+	};
+
+	const auto first = render(U'ぽ');
+	REQUIRE_EQ(render(U'ぽ'), first);
+
+	// More glyphs than fit into the atlas
+	auto surface = Bitmap::Create(width, height);
+	for (char32_t i = 0x4E00; i < 0x4E00 + 5000; ++i) {
+		font->Render(*surface, 0, 0, *system, 0, i);
+	}
+
+	REQUIRE_EQ(render(U'ぽ'), first);
+}
+
 TEST_CASE("FontGlyphCharEx") {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::exfont;
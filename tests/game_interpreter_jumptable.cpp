@@ -0,0 +1,145 @@
+#include "game_interpreter_jumptable.h"
+#include "doctest.h"
+#include <algorithm>
+#include <random>
+
+using Cmd = lcf::rpg::EventCommand::Code;
+using CommandList = std::vector<lcf::rpg::EventCommand>;
+
+static lcf::rpg::EventCommand MakeCommand(Cmd code, int indent, std::vector<int32_t> params = {}) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+// Reference implementations: the linear scans the interpreter used before
+
+static int ScanNextConditional(const CommandList& list, int index, std::initializer_list<Cmd> codes, int indent) {
+	if (index >= static_cast<int>(list.size())) {
+		return index;
+	}
+	for (++index; index < static_cast<int>(list.size()); ++index) {
+		const auto& com = list[index];
+		if (com.indent > indent) {
+			continue;
+		}
+		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+			break;
+		}
+	}
+	return index;
+}
+
+static int ScanLoopStart(const CommandList& list, int index, int indent) {
+	for (int idx = index; idx >= 0; idx--) {
+		if (list[idx].indent > indent)
+			continue;
+		if (list[idx].indent < indent)
+			return -1;
+		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
+			continue;
+		return idx;
+	}
+	return index;
+}
+
+static int ScanLabel(const CommandList& list, int label_id) {
+	for (int idx = 0; idx < static_cast<int>(list.size()); idx++) {
+		if (static_cast<Cmd>(list[idx].code) == Cmd::Label
+				&& !list[idx].parameters.empty() && list[idx].parameters[0] == label_id) {
+			return idx;
+		}
+	}
+	return -1;
+}
+
+TEST_SUITE_BEGIN("Game_Interpreter_JumpTable");
+
+TEST_CASE("Branch") {
+	CommandList list = {
+		MakeCommand(Cmd::ConditionalBranch, 0),
+		MakeCommand(Cmd::ConditionalBranch, 1),
+		MakeCommand(Cmd::ElseBranch, 1),
+		MakeCommand(Cmd::EndBranch, 1),
+		MakeCommand(Cmd::ElseBranch, 0),
+		MakeCommand(Cmd::EndBranch, 0),
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE(table.IsBuiltFor(list));
+	REQUIRE_EQ(table.FindNextConditional(0, { Cmd::ElseBranch, Cmd::EndBranch }, 0), 4);
+	REQUIRE_EQ(table.FindNextConditional(1, { Cmd::ElseBranch, Cmd::EndBranch }, 1), 2);
+	REQUIRE_EQ(table.FindNextConditional(4, { Cmd::EndBranch }, 0), 5);
+	REQUIRE_EQ(table.FindNextConditional(5, { Cmd::EndBranch }, 0), 6);
+}
+
+TEST_CASE("Loop") {
+	CommandList list = {
+		MakeCommand(Cmd::Loop, 0),
+		MakeCommand(Cmd::Loop, 1),
+		MakeCommand(Cmd::BreakLoop, 2),
+		MakeCommand(Cmd::EndLoop, 1),
+		MakeCommand(Cmd::BreakLoop, 1),
+		MakeCommand(Cmd::EndLoop, 0),
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindLoopStart(5, 0), 0);
+	REQUIRE_EQ(table.FindLoopStart(3, 1), 1);
+	REQUIRE_EQ(table.FindNextConditional(2, { Cmd::EndLoop }, 1), 3);
+	REQUIRE_EQ(table.FindNextEndLoop(4), 5);
+	REQUIRE_EQ(table.FindNextEndLoop(5), 6);
+}
+
+TEST_CASE("Label") {
+	CommandList list = {
+		MakeCommand(Cmd::Label, 0, { 2 }),
+		MakeCommand(Cmd::Label, 0, { 1 }),
+		MakeCommand(Cmd::Label, 0, { 2 }),
+		MakeCommand(Cmd::Label, 0),
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindLabel(1), 1);
+	REQUIRE_EQ(table.FindLabel(2), 0);
+	REQUIRE_EQ(table.FindLabel(3), -1);
+}
+
+TEST_CASE("MatchesLinearScan") {
+	// Random lists including broken indentation
+	const Cmd codes[] = { Cmd::Loop, Cmd::EndLoop, Cmd::Label, Cmd::ConditionalBranch,
+		Cmd::ElseBranch, Cmd::EndBranch, Cmd::ShowMessage, Cmd::Wait };
+	std::mt19937 rng(1);
+
+	for (int t = 0; t < 200; ++t) {
+		CommandList list(1 + rng() % 40);
+		int indent = 0;
+		for (auto& com: list) {
+			indent = std::max(0, indent + static_cast<int>(rng() % 5) - 2);
+			auto code = codes[rng() % 8];
+			if (code == Cmd::Label) {
+				com = MakeCommand(code, indent, { static_cast<int32_t>(rng() % 4) });
+			} else {
+				com = MakeCommand(code, indent);
+			}
+		}
+		Game_Interpreter_JumpTable table(list);
+
+		for (int i = 0; i < static_cast<int>(list.size()); ++i) {
+			for (int k = 0; k < 6; ++k) {
+				REQUIRE_EQ(table.FindNextConditional(i, { Cmd::ElseBranch, Cmd::EndBranch }, k),
+					ScanNextConditional(list, i, { Cmd::ElseBranch, Cmd::EndBranch }, k));
+				REQUIRE_EQ(table.FindNextConditional(i, { Cmd::EndLoop }, k),
+					ScanNextConditional(list, i, { Cmd::EndLoop }, k));
+				REQUIRE_EQ(table.FindLoopStart(i, k), ScanLoopStart(list, i, k));
+			}
+		}
+		for (int label_id = 0; label_id < 5; ++label_id) {
+			REQUIRE_EQ(table.FindLabel(label_id), ScanLabel(list, label_id));
+		}
+	}
+}
+
+TEST_SUITE_END();
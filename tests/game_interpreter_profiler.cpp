@@ -0,0 +1,99 @@
+#include "game_interpreter_profiler.h"
+#include "doctest.h"
+#include <algorithm>
+
+using Cmd = lcf::rpg::EventCommand::Code;
+using EventType = Game_Interpreter_Shared::EventType;
+
+static lcf::rpg::SaveEventExecFrame MakeFrame(EventType type, int event_id, std::vector<Cmd> codes) {
+	lcf::rpg::SaveEventExecFrame frame;
+	frame.maniac_event_info = type == EventType::BattleEvent ? 0x40 : (static_cast<int>(type) << 4);
+	frame.maniac_event_id = event_id;
+	for (auto code: codes) {
+		lcf::rpg::EventCommand com;
+		com.code = static_cast<int>(code);
+		frame.commands.push_back(com);
+	}
+	return frame;
+}
+
+static void Execute(Game_Interpreter_Profiler::UpdateScope& update, lcf::rpg::SaveEventExecFrame& frame, int num) {
+	for (int i = 0; i < num; ++i) {
+		Game_Interpreter_Profiler::CommandScope cmd(update, frame);
+		frame.current_command = (frame.current_command + 1) % frame.commands.size();
+	}
+}
+
+TEST_SUITE_BEGIN("Game_Interpreter_Profiler");
+
+TEST_CASE("Disabled") {
+	auto frame = MakeFrame(EventType::CommonEvent, 1, { Cmd::Wait });
+	{
+		Game_Interpreter_Profiler::UpdateScope update;
+		Execute(update, frame, 3);
+	}
+
+	REQUIRE(Game_Interpreter_Profiler::GetEventStats().empty());
+	REQUIRE(Game_Interpreter_Profiler::GetCommandStats().empty());
+}
+
+TEST_CASE("Count") {
+	Game_Interpreter_Profiler::Init("");
+
+	auto ce = MakeFrame(EventType::CommonEvent, 5, { Cmd::ControlVars, Cmd::Wait });
+	auto battle = MakeFrame(EventType::BattleEvent, 2, { Cmd::ControlVars });
+
+	for (int i = 0; i < 3; ++i) {
+		Game_Interpreter_Profiler::UpdateScope update;
+		Execute(update, ce, 2 + i);
+		Execute(update, battle, 1);
+	}
+
+	auto events = Game_Interpreter_Profiler::GetEventStats();
+	REQUIRE_EQ(events.size(), 2);
+	std::sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.type < b.type; });
+
+	REQUIRE_EQ(events[0].type, EventType::CommonEvent);
+	REQUIRE_EQ(events[0].event_id, 5);
+	REQUIRE_EQ(events[0].updates, 3);
+	REQUIRE_EQ(events[0].commands, 9);
+	REQUIRE_EQ(events[0].max_commands_per_update, 4);
+
+	REQUIRE_EQ(events[1].type, EventType::BattleEvent);
+	REQUIRE_EQ(events[1].updates, 3);
+	REQUIRE_EQ(events[1].commands, 3);
+	REQUIRE_EQ(events[1].max_commands_per_update, 1);
+
+	auto commands = Game_Interpreter_Profiler::GetCommandStats();
+	REQUIRE_EQ(commands.size(), 2);
+	std::sort(commands.begin(), commands.end(), [](const auto& a, const auto& b) { return a.code < b.code; });
+	REQUIRE_EQ(commands[0].code, static_cast<int>(Cmd::ControlVars));
+	REQUIRE_EQ(commands[0].count, 8);
+	REQUIRE_EQ(commands[1].code, static_cast<int>(Cmd::Wait));
+	REQUIRE_EQ(commands[1].count, 4);
+
+	Game_Interpreter_Profiler::Quit();
+	REQUIRE_FALSE(Game_Interpreter_Profiler::IsEnabled());
+	REQUIRE(Game_Interpreter_Profiler::GetEventStats().empty());
+}
+
+TEST_CASE("UpdateStats") {
+	Game_Interpreter_Profiler::Init("");
+
+	Game_Interpreter::UpdateStats frame;
+	frame.executed = 2;
+	frame.skipped = 10;
+	Game_Interpreter_Profiler::AddUpdateStats(frame);
+	frame.executed = 3;
+	frame.skipped = 0;
+	Game_Interpreter_Profiler::AddUpdateStats(frame);
+
+	auto stats = Game_Interpreter_Profiler::GetUpdateStats();
+	REQUIRE_EQ(stats.executed, 5);
+	REQUIRE_EQ(stats.skipped, 10);
+
+	Game_Interpreter_Profiler::Quit();
+	REQUIRE_EQ(Game_Interpreter_Profiler::GetUpdateStats().executed, 0);
+}
+
+TEST_SUITE_END();
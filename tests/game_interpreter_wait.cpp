@@ -0,0 +1,64 @@
+#include "game_interpreter.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "scene.h"
+#include "mock_game.h"
+#include "doctest.h"
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+static lcf::rpg::EventCommand MakeCommand(Cmd code, std::vector<int32_t> params) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int>(code);
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+// Wait 0.5s, then V[1] = 1
+static std::vector<lcf::rpg::EventCommand> WaitThenSet() {
+	return {
+		MakeCommand(Cmd::Wait, { 5 }),
+		MakeCommand(Cmd::ControlVars, { 0, 1, 1, 0, 0, 1 }),
+	};
+}
+
+// Updates until V[1] is set and returns the number of updates
+static int UpdatesUntilSet(Game_Interpreter& interpreter) {
+	int updates = 0;
+	while (Main_Data::game_variables->Get(1) == 0 && updates < 1000) {
+		interpreter.Update();
+		++updates;
+	}
+	return updates;
+}
+
+TEST_SUITE_BEGIN("Game_Interpreter_Wait");
+
+TEST_CASE("WaitTime") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+	Scene::instance = std::make_shared<Scene>();
+	Main_Data::game_variables->SetWarning(0);
+
+	// The foreground interpreter always runs the full command loop
+	Game_Interpreter main_interpreter(true);
+	main_interpreter.Push<InterpreterExecutionType::Parallel, InterpreterEventType::CommonEvent>(WaitThenSet(), 1);
+	Game_Interpreter::ResetUpdateStats();
+	const int expected = UpdatesUntilSet(main_interpreter);
+	REQUIRE_EQ(expected, 31);
+	REQUIRE_EQ(Game_Interpreter::GetUpdateStats().skipped, 0);
+
+	Main_Data::game_variables->Set(1, 0);
+
+	Game_Interpreter interpreter;
+	interpreter.Push<InterpreterExecutionType::Parallel, InterpreterEventType::CommonEvent>(WaitThenSet(), 1);
+	Game_Interpreter::ResetUpdateStats();
+	REQUIRE_EQ(UpdatesUntilSet(interpreter), expected);
+
+	const auto stats = Game_Interpreter::GetUpdateStats();
+	REQUIRE_EQ(stats.executed, 2);
+	REQUIRE_EQ(stats.skipped, expected - 2);
+
+	Scene::instance.reset();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,180 @@
+#include "game_map.h"
+#include "mock_game.h"
+#include "test_mock_actor.h"
+#include "doctest.h"
+#include <random>
+
+namespace {
+
+Game_Event* LinearEventAt(int x, int y, bool require_active) {
+	auto& events = Game_Map::GetEvents();
+	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
+		if (iter->IsInPosition(x, y) && (!require_active || iter->IsActive())) {
+			return &*iter;
+		}
+	}
+	return nullptr;
+}
+
+std::vector<Game_Event*> LinearEventsAt(int x, int y) {
+	std::vector<Game_Event*> result;
+	for (auto& ev: Game_Map::GetEvents()) {
+		if (ev.IsInPosition(x, y)) {
+			result.push_back(&ev);
+		}
+	}
+	return result;
+}
+
+std::vector<Game_Event*> IndexedEventsAt(int x, int y) {
+	std::vector<Game_Event*> result;
+	for (auto* ev = Game_Map::GetNextEventAt(x, y); ev; ev = Game_Map::GetNextEventAt(x, y, ev)) {
+		result.push_back(ev);
+	}
+	return result;
+}
+
+void RequireMatchesLinearScan() {
+	for (int y = 0; y < Game_Map::GetTilesY(); ++y) {
+		for (int x = 0; x < Game_Map::GetTilesX(); ++x) {
+			REQUIRE_EQ(IndexedEventsAt(x, y), LinearEventsAt(x, y));
+			REQUIRE_EQ(Game_Map::GetEventAt(x, y, false), LinearEventAt(x, y, false));
+			REQUIRE_EQ(Game_Map::GetEventAt(x, y, true), LinearEventAt(x, y, true));
+			auto events = LinearEventsAt(x, y);
+			REQUIRE_EQ(Game_Map::CheckEvent(x, y), events.empty() ? 0 : events.front()->GetId());
+		}
+	}
+}
+
+}
+
+TEST_SUITE_BEGIN("Game_Map_Events");
+
+TEST_CASE("IndexMatchesLinearScan") {
+	const MockGame mg(MockMap::ePass40x30);
+	std::mt19937 rng(1);
+
+	auto random_x = [&]() { return static_cast<int>(rng() % Game_Map::GetTilesX()); };
+	auto random_y = [&]() { return static_cast<int>(rng() % Game_Map::GetTilesY()); };
+
+	for (int i = 0; i < 200; ++i) {
+		// Few positions to get many events on the same tile
+		REQUIRE(Game_Map::CloneMapEvent(Game_Map::GetMapId(), 1, random_x() % 8, random_y() % 8, 0, ""));
+	}
+	RequireMatchesLinearScan();
+
+	for (int round = 0; round < 10; ++round) {
+		auto& events = Game_Map::GetEvents();
+		for (int i = 0; i < 100; ++i) {
+			auto& ev = events[rng() % events.size()];
+			switch (rng() % 3) {
+				case 0:
+					ev.SetX(random_x());
+					break;
+				case 1:
+					ev.SetY(random_y());
+					break;
+				default:
+					ev.MoveTo(ev.GetMapId(), random_x() % 8, random_y() % 8);
+					break;
+			}
+		}
+		RequireMatchesLinearScan();
+
+		const int id = events[rng() % events.size()].GetId();
+		if (id != 1) {
+			Game_Map::DestroyMapEvent(id, true);
+			Game_Map::UpdateUnderlyingEventReferences();
+		}
+		REQUIRE(Game_Map::CloneMapEvent(Game_Map::GetMapId(), 1, random_x(), random_y(), 0, ""));
+		RequireMatchesLinearScan();
+	}
+}
+
+TEST_CASE("MoveWhileIterating") {
+	const MockGame mg(MockMap::ePass40x30);
+
+	for (int i = 0; i < 4; ++i) {
+		REQUIRE(Game_Map::CloneMapEvent(Game_Map::GetMapId(), 1, 3, 3, 0, ""));
+	}
+	auto& events = Game_Map::GetEvents();
+
+	// Like a scan over all events: moved events are skipped when already visited
+	// and visited when they move to the position before they are reached.
+	std::vector<int> visited;
+	for (auto* ev = Game_Map::GetNextEventAt(3, 3); ev; ev = Game_Map::GetNextEventAt(3, 3, ev)) {
+		visited.push_back(ev->GetId());
+		if (ev == &events[1]) {
+			events[1].SetX(4);
+			events[2].SetX(4);
+			events[0].SetX(3);
+			events[0].SetY(3);
+		}
+	}
+	REQUIRE_EQ(visited, std::vector<int>{ events[1].GetId(), events[3].GetId(), events[4].GetId() });
+}
+
+TEST_CASE("RefreshOnItemChange") {
+	const MockGame mg(MockMap::ePass40x30);
+	lcf::Data::items.resize(2);
+	lcf::Data::items[0].ID = 1;
+	lcf::Data::items[1].ID = 2;
+
+	auto map = MakeMockMap(MockMap::ePass40x30);
+	auto& page = map->events.back().pages.back();
+	page.condition.flags.item = true;
+	page.condition.item_id = 1;
+	Game_Map::Setup(std::move(map));
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetEvent(1)->GetActivePage());
+
+	// Like the shop or the battle loot, which don't refresh the map themselves
+	Main_Data::game_party->AddItem(1, 1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE(Game_Map::GetEvent(1)->GetActivePage());
+
+	// The page condition didn't change
+	Main_Data::game_party->AddItem(1, 1);
+	Main_Data::game_party->AddItem(2, 1);
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+
+	Main_Data::game_party->RemoveItem(1, 2);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetEvent(1)->GetActivePage());
+}
+
+TEST_CASE("RefreshOnEquippedItemChange") {
+	const MockGame mg(MockMap::ePass40x30);
+
+	// Actors need a full database, keep the map data of MockGame
+	auto terrains = lcf::Data::terrains;
+	auto chipsets = lcf::Data::chipsets;
+	InitEmptyDB();
+	lcf::Data::terrains = terrains;
+	lcf::Data::chipsets = chipsets;
+	Main_Data::game_actors = std::make_unique<Game_Actors>();
+	Main_Data::game_actors->GetActor(1)->SetEquipment(1, 1);
+
+	auto map = MakeMockMap(MockMap::ePass40x30);
+	auto& page = map->events.back().pages.back();
+	page.condition.flags.item = true;
+	page.condition.item_id = 1;
+	Game_Map::Setup(std::move(map));
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetEvent(1)->GetActivePage());
+
+	// The actor joins with the item equipped
+	Main_Data::game_party->AddActor(1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE(Game_Map::GetEvent(1)->GetActivePage());
+
+	Main_Data::game_party->RemoveActor(1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetEvent(1)->GetActivePage());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,57 @@
+#include "game_map.h"
+#include "doctest.h"
+
+static std::shared_ptr<const lcf::rpg::Map> MakeMap(int width) {
+	auto map = std::make_shared<lcf::rpg::Map>();
+	map->width = width;
+	return map;
+}
+
+TEST_SUITE_BEGIN("Game_Map_MapFiles");
+
+TEST_CASE("FindInsert") {
+	Game_Map::MapFiles::Clear();
+	REQUIRE(Game_Map::MapFiles::Find("Map0001.lmu") == nullptr);
+
+	Game_Map::MapFiles::Insert("Map0001.lmu", MakeMap(20));
+	Game_Map::MapFiles::Insert("Map0002.lmu", MakeMap(30));
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 2);
+	REQUIRE_EQ(Game_Map::MapFiles::Find("Map0001.lmu")->width, 20);
+	REQUIRE_EQ(Game_Map::MapFiles::Find("Map0002.lmu")->width, 30);
+
+	// Replaces the old entry
+	Game_Map::MapFiles::Insert("Map0001.lmu", MakeMap(40));
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 2);
+	REQUIRE_EQ(Game_Map::MapFiles::Find("Map0001.lmu")->width, 40);
+
+	Game_Map::MapFiles::Clear();
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 0);
+}
+
+TEST_CASE("LeastRecentlyUsed") {
+	Game_Map::MapFiles::Clear();
+	Game_Map::MapFiles::SetCapacity(2);
+
+	Game_Map::MapFiles::Insert("Map0001.lmu", MakeMap(1));
+	Game_Map::MapFiles::Insert("Map0002.lmu", MakeMap(2));
+	REQUIRE(Game_Map::MapFiles::Find("Map0001.lmu") != nullptr);
+
+	// Map0002 was used least recently
+	Game_Map::MapFiles::Insert("Map0003.lmu", MakeMap(3));
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 2);
+	REQUIRE(Game_Map::MapFiles::Find("Map0002.lmu") == nullptr);
+	REQUIRE(Game_Map::MapFiles::Find("Map0001.lmu") != nullptr);
+	REQUIRE(Game_Map::MapFiles::Find("Map0003.lmu") != nullptr);
+
+	Game_Map::MapFiles::SetCapacity(1);
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 1);
+	REQUIRE(Game_Map::MapFiles::Find("Map0003.lmu") != nullptr);
+
+	Game_Map::MapFiles::SetCapacity(0);
+	Game_Map::MapFiles::Insert("Map0004.lmu", MakeMap(4));
+	REQUIRE_EQ(Game_Map::MapFiles::GetSize(), 0);
+
+	Game_Map::MapFiles::SetCapacity(Game_Map::MapFiles::default_capacity);
+}
+
+TEST_SUITE_END();
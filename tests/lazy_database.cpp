@@ -0,0 +1,142 @@
+#include "lazy_database.h"
+#include "doctest.h"
+#include "game_map.h"
+#include "game_screen.h"
+#include "main_data.h"
+#include <lcf/data.h>
+#include <lcf/ldb/reader.h>
+#include <lcf/reader_util.h>
+#include <algorithm>
+#include <sstream>
+
+static std::string MakeDatabase() {
+	lcf::rpg::Database db;
+
+	db.actors.resize(2);
+	db.actors[0].ID = 1;
+	db.actors[0].name = lcf::DBString("Alex");
+	db.actors[1].ID = 2;
+	db.actors[1].name = lcf::DBString("Brian");
+
+	db.commonevents.resize(3);
+	for (int i = 0; i < 3; ++i) {
+		auto& ce = db.commonevents[i];
+		ce.ID = i + 1;
+		ce.name = lcf::DBString("CE" + std::to_string(i + 1));
+		lcf::rpg::EventCommand com;
+		com.code = static_cast<int>(lcf::rpg::EventCommand::Code::ShowMessage);
+		com.string = lcf::DBString("Hello");
+		ce.event_commands.resize(i + 1, com);
+	}
+
+	db.animations.resize(1);
+	db.animations[0].ID = 1;
+	db.animations[0].name = lcf::DBString("Slash");
+
+	db.troops.resize(1);
+	db.troops[0].ID = 1;
+	db.troops[0].name = lcf::DBString("Slime x2");
+
+	std::stringstream ss;
+	lcf::LDB_Reader::Save(ss, db, "UTF-8");
+	return ss.str();
+}
+
+TEST_SUITE_BEGIN("LazyDatabase");
+
+TEST_CASE("ScanChunks") {
+	const auto ldb = MakeDatabase();
+	const auto chunks = LazyDatabase::ScanChunks(ldb);
+	REQUIRE_FALSE(chunks.empty());
+
+	auto has_chunk = [&](uint32_t id) {
+		return std::any_of(chunks.begin(), chunks.end(), [&](const auto& c) { return c.id == id; });
+	};
+	REQUIRE(has_chunk(0x0B)); // actors
+	REQUIRE(has_chunk(0x13)); // animations
+	REQUIRE(has_chunk(0x19)); // commonevents
+
+	for (size_t i = 1; i < chunks.size(); ++i) {
+		REQUIRE_EQ(chunks[i].offset, chunks[i - 1].offset + chunks[i - 1].size);
+	}
+
+	REQUIRE(LazyDatabase::ScanChunks("").empty());
+	REQUIRE(LazyDatabase::ScanChunks("\x0bLcfMapUnit").empty());
+	// Truncated
+	REQUIRE(LazyDatabase::ScanChunks(std::string_view(ldb).substr(0, ldb.size() - 2)).empty());
+}
+
+TEST_CASE("Load") {
+	std::istringstream is(MakeDatabase());
+	auto db = LazyDatabase::Load(is, "UTF-8");
+	REQUIRE(db);
+
+	REQUIRE_EQ(db->actors.size(), 2);
+	REQUIRE_EQ(lcf::ToString(db->actors[1].name), "Brian");
+	REQUIRE(db->commonevents.empty());
+	REQUIRE(db->animations.empty());
+	REQUIRE(db->troops.empty());
+
+	REQUIRE(LazyDatabase::HasPendingSections());
+	REQUIRE(LazyDatabase::IsPending(LazyDatabase::Section::CommonEvents));
+	REQUIRE(LazyDatabase::IsPending(LazyDatabase::Section::Animations));
+	REQUIRE(LazyDatabase::IsPending(LazyDatabase::Section::Battle));
+
+	lcf::Data::data = std::move(*db);
+
+	LazyDatabase::LoadSection(LazyDatabase::Section::CommonEvents);
+	REQUIRE_FALSE(LazyDatabase::IsPending(LazyDatabase::Section::CommonEvents));
+	REQUIRE_EQ(lcf::Data::commonevents.size(), 3);
+	REQUIRE_EQ(lcf::ToString(lcf::Data::commonevents[2].name), "CE3");
+	REQUIRE_EQ(lcf::Data::commonevents[2].event_commands.size(), 3);
+	REQUIRE_EQ(lcf::ToString(lcf::Data::commonevents[2].event_commands[0].string), "Hello");
+	REQUIRE(lcf::Data::animations.empty());
+	REQUIRE_EQ(lcf::Data::actors.size(), 2);
+
+	LazyDatabase::LoadPendingSections();
+	REQUIRE_FALSE(LazyDatabase::HasPendingSections());
+	REQUIRE_EQ(lcf::Data::animations.size(), 1);
+	REQUIRE_EQ(lcf::ToString(lcf::Data::animations[0].name), "Slash");
+	REQUIRE_EQ(lcf::Data::troops.size(), 1);
+	REQUIRE_EQ(lcf::ToString(lcf::Data::troops[0].name), "Slime x2");
+
+	lcf::Data::Clear();
+}
+
+TEST_CASE("LoadSavegame") {
+	std::istringstream is(MakeDatabase());
+	auto db = LazyDatabase::Load(is, "UTF-8");
+	REQUIRE(db);
+	lcf::Data::data = std::move(*db);
+
+	Game_Map::Init();
+	REQUIRE(Game_Map::GetCommonEvents().empty());
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+
+	// A battle animation was playing when the game was saved
+	lcf::rpg::SaveScreen screen;
+	screen.battleanim_active = true;
+	screen.battleanim_id = 1;
+	screen.battleanim_frame = 2;
+
+	// Like Player::LoadSavegame
+	Game_Map::LoadDeferredDatabase();
+	Main_Data::game_screen->SetSaveData(screen);
+
+	REQUIRE_FALSE(LazyDatabase::HasPendingSections());
+	REQUIRE(lcf::ReaderUtil::GetElement(lcf::Data::animations, screen.battleanim_id));
+	REQUIRE_EQ(Game_Map::GetCommonEvents().size(), 3);
+
+	Main_Data::game_screen.reset();
+	Game_Map::Quit();
+	lcf::Data::Clear();
+}
+
+TEST_CASE("Invalid") {
+	// Falls back to liblcf, which reports the error
+	std::istringstream is("invalid");
+	LazyDatabase::Load(is);
+	REQUIRE_FALSE(LazyDatabase::HasPendingSections());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,242 @@
+#include "maniac_patch.h"
+#include "game_interpreter.h"
+#include "rand.h"
+#include "mock_game.h"
+#include "doctest.h"
+#include <random>
+
+namespace {
+
+constexpr int num_vars = 16;
+
+// Builds encoded Maniac expressions
+class ExpressionBuilder {
+public:
+	explicit ExpressionBuilder(uint32_t seed) : rng(seed) {}
+
+	void Const(int32_t value) {
+		bytes.push_back(3);
+		for (int i = 0; i < 4; ++i) {
+			bytes.push_back((static_cast<uint32_t>(value) >> (i * 8)) & 0xFF);
+		}
+	}
+
+	void Random(int depth) {
+		const int kind = depth > 5 ? rng() % 2 : rng() % 12;
+		switch (kind) {
+			case 0:
+				Number();
+				break;
+			case 1:
+				// Var, Switch, VarIndirect, SwitchIndirect
+				bytes.push_back(Pick({ 8, 9, 13, 14 }));
+				Index(depth);
+				break;
+			case 2:
+				// Negate, Not, Flip
+				bytes.push_back(24 + rng() % 3);
+				Random(depth + 1);
+				break;
+			case 3:
+			case 4:
+				// Add to And
+				bytes.push_back(48 + rng() % 18);
+				Random(depth + 1);
+				Random(depth + 1);
+				break;
+			case 5:
+				// v[a] <op> c
+				bytes.push_back(48 + rng() % 18);
+				bytes.push_back(8);
+				bytes.push_back(1);
+				bytes.push_back(rng() % (num_vars + 2));
+				Number();
+				break;
+			case 6:
+				// Inplace operations, sometimes on a value that is not a lvalue
+				bytes.push_back(34 + rng() % 11);
+				if (rng() % 5 == 0) {
+					Random(depth + 1);
+				} else {
+					bytes.push_back(Pick({ 8, 9, 13, 14 }));
+					Index(depth);
+				}
+				Random(depth + 1);
+				break;
+			case 7:
+				// Ternary
+				bytes.push_back(72);
+				Random(depth + 1);
+				Random(depth + 1);
+				Random(depth + 1);
+				break;
+			case 8:
+			case 9: {
+				// rnd and the pure functions, unknown functions and wrong argument counts
+				int fn = Pick({ 0, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 40 });
+				int argc = (fn == 14) ? 1 : ((fn >= 9 && fn <= 11) || (fn >= 15 && fn <= 18)) ? 3 : 2;
+				if (rng() % 10 == 0) {
+					argc = rng() % 4;
+				}
+				bytes.push_back(78);
+				bytes.push_back(fn);
+				bytes.push_back(argc);
+				for (int i = 0; i < argc; ++i) {
+					Random(depth + 1);
+				}
+				break;
+			}
+			case 10:
+				// Null and unsupported operations
+				bytes.push_back(Pick({ 0, 19, 66 }));
+				bytes.push_back(rng() % 256);
+				break;
+			case 11:
+				// Functions with long argument count
+				bytes.push_back(78);
+				bytes.push_back(rng() % 19);
+				bytes.push_back(0x80 | (rng() % 4));
+				break;
+		}
+	}
+
+	std::vector<int32_t> Finish(bool truncate) {
+		if (truncate && !bytes.empty()) {
+			bytes.resize(rng() % bytes.size());
+		}
+		while (bytes.size() % 4 != 0) {
+			bytes.push_back(0);
+		}
+		std::vector<int32_t> op_codes(bytes.size() / 4);
+		for (size_t i = 0; i < op_codes.size(); ++i) {
+			op_codes[i] = static_cast<int32_t>(bytes[i * 4] | (bytes[i * 4 + 1] << 8)
+				| (bytes[i * 4 + 2] << 16) | (static_cast<uint32_t>(bytes[i * 4 + 3]) << 24));
+		}
+		bytes.clear();
+		return op_codes;
+	}
+
+	std::mt19937 rng;
+
+private:
+	int Pick(std::initializer_list<int> values) {
+		return *(values.begin() + rng() % values.size());
+	}
+
+	void Number() {
+		switch (rng() % 3) {
+			case 0:
+				bytes.push_back(1);
+				bytes.push_back(rng() % 256);
+				break;
+			case 1:
+				bytes.push_back(2);
+				bytes.push_back(rng() % 256);
+				bytes.push_back(rng() % 256);
+				break;
+			default:
+				Const(static_cast<int32_t>(rng()));
+				break;
+		}
+	}
+
+	// A variable or switch id that is mostly in range
+	void Index(int depth) {
+		if (rng() % 2 == 0) {
+			bytes.push_back(1);
+			bytes.push_back(rng() % (num_vars + 2));
+		} else {
+			// (expr & 15) + 1
+			bytes.push_back(48);
+			bytes.push_back(54);
+			Random(depth + 1);
+			bytes.push_back(1);
+			bytes.push_back(15);
+			bytes.push_back(1);
+			bytes.push_back(1);
+		}
+	}
+
+	std::vector<uint8_t> bytes;
+};
+
+void InitState(std::mt19937& rng) {
+	lcf::Data::variables.resize(num_vars);
+	lcf::Data::switches.resize(num_vars);
+	Main_Data::game_variables->SetLowerLimit(num_vars);
+	Main_Data::game_variables->SetWarning(0);
+	Main_Data::game_switches->SetLowerLimit(num_vars);
+	Main_Data::game_switches->SetWarning(0);
+
+	for (int i = 1; i <= num_vars; ++i) {
+		Main_Data::game_variables->Set(i, static_cast<int>(rng() % 40) - 10);
+		Main_Data::game_switches->Set(i, rng() % 2 == 0);
+	}
+}
+
+}
+
+TEST_SUITE_BEGIN("ManiacExpression");
+
+TEST_CASE("VarPlusConst") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+	Game_Interpreter interpreter;
+	Main_Data::game_variables->SetWarning(0);
+	Main_Data::game_variables->Set(3, 40);
+
+	// v[3] + 2
+	std::vector<int32_t> op_codes = { 0x03010830, 0x00000201 };
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(op_codes), interpreter), 42);
+
+	Main_Data::game_variables->Set(3, -2);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(op_codes), interpreter), 0);
+}
+
+TEST_CASE("MatchesInterpreter") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+	Game_Interpreter interpreter;
+	ExpressionBuilder builder(1);
+
+	for (int t = 0; t < 5000; ++t) {
+		const bool multiple = builder.rng() % 3 == 0;
+		const int count = multiple ? 1 + builder.rng() % 3 : 1;
+		for (int i = 0; i < count; ++i) {
+			builder.Random(0);
+		}
+		const auto op_codes = builder.Finish(builder.rng() % 20 == 0);
+		const uint32_t seed = builder.rng();
+
+		std::mt19937 state_rng(seed);
+		InitState(state_rng);
+		Rand::SeedRandomNumberGenerator(seed);
+		std::vector<int32_t> expected;
+		if (multiple) {
+			expected = ManiacPatch::InterpretExpressions(MakeSpan(op_codes), interpreter);
+		} else {
+			expected.push_back(ManiacPatch::InterpretExpression(MakeSpan(op_codes), interpreter));
+		}
+		const auto expected_vars = Main_Data::game_variables->GetData();
+		const auto expected_switches = Main_Data::game_switches->GetData();
+
+		// The second run uses the cached program
+		for (int run = 0; run < 2; ++run) {
+			state_rng.seed(seed);
+			InitState(state_rng);
+			Rand::SeedRandomNumberGenerator(seed);
+			std::vector<int32_t> result;
+			if (multiple) {
+				result = ManiacPatch::ParseExpressions(MakeSpan(op_codes), interpreter);
+			} else {
+				result.push_back(ManiacPatch::ParseExpression(MakeSpan(op_codes), interpreter));
+			}
+
+			REQUIRE_EQ(result, expected);
+			REQUIRE(Main_Data::game_variables->GetData() == expected_vars);
+			REQUIRE(Main_Data::game_switches->GetData() == expected_switches);
+		}
+	}
+
+	ManiacPatch::ClearExpressionCache();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,87 @@
+#include "map_preloader.h"
+#include "game_map.h"
+#include "doctest.h"
+#include <lcf/rpg/map.h>
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+static lcf::rpg::Event MakeTeleportEvent(int trigger, std::vector<int> targets) {
+	lcf::rpg::Event ev;
+	lcf::rpg::EventPage page;
+	page.trigger = trigger;
+	for (int target_id: targets) {
+		lcf::rpg::EventCommand com;
+		com.code = static_cast<int>(Cmd::Teleport);
+		std::vector<int32_t> params = { target_id, 5, 5, 0 };
+		com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+		page.event_commands.push_back(com);
+	}
+	ev.pages.push_back(page);
+	return ev;
+}
+
+static lcf::rpg::Map MakeMap() {
+	lcf::rpg::Map map;
+	map.events.push_back(MakeTeleportEvent(lcf::rpg::EventPage::Trigger_parallel, { 4 }));
+	map.events.push_back(MakeTeleportEvent(lcf::rpg::EventPage::Trigger_action, { 3, 1 }));
+	map.events.push_back(MakeTeleportEvent(lcf::rpg::EventPage::Trigger_touched, { 2, 3 }));
+	return map;
+}
+
+TEST_SUITE_BEGIN("MapPreloader");
+
+TEST_CASE("CollectTeleportTargets") {
+	auto map = MakeMap();
+
+	// Map 1 is the current map, map 3 ranks as touch triggered
+	auto targets = MapPreloader::CollectTeleportTargets(map, 1);
+	REQUIRE_EQ(targets, std::vector<int>{ 3, 2, 4 });
+
+	REQUIRE(MapPreloader::CollectTeleportTargets(lcf::rpg::Map(), 1).empty());
+}
+
+TEST_CASE("Preload") {
+	Game_Map::MapFiles::Clear();
+	MapPreloader::SetLoader([](int map_id) {
+		auto map = std::make_shared<lcf::rpg::Map>();
+		map->width = map_id;
+		return MapPreloader::LoadResult{ Game_Map::ConstructMapName(map_id, false), std::move(map) };
+	});
+	MapPreloader::SetSimulatedLatency(3);
+	MapPreloader::SetBudget(2);
+
+	MapPreloader::Start(MakeMap(), 1);
+	REQUIRE_EQ(MapPreloader::GetPendingMaps(), std::vector<int>{ 3, 2 });
+
+	MapPreloader::Update();
+	MapPreloader::Update();
+	REQUIRE(MapPreloader::GetPreloadedMaps().empty());
+	REQUIRE(Game_Map::MapFiles::Find(Game_Map::ConstructMapName(3, false)) == nullptr);
+
+	// One map per frame
+	MapPreloader::Update();
+	REQUIRE_EQ(MapPreloader::GetPreloadedMaps(), std::vector<int>{ 3 });
+	REQUIRE_EQ(Game_Map::MapFiles::Find(Game_Map::ConstructMapName(3, false))->width, 3);
+	REQUIRE(Game_Map::MapFiles::Find(Game_Map::ConstructMapName(2, false)) == nullptr);
+
+	MapPreloader::Update();
+	REQUIRE_EQ(MapPreloader::GetPreloadedMaps(), std::vector<int>{ 3, 2 });
+	REQUIRE_EQ(Game_Map::MapFiles::Find(Game_Map::ConstructMapName(2, false))->width, 2);
+	REQUIRE(MapPreloader::GetPendingMaps().empty());
+	REQUIRE(Game_Map::MapFiles::Find(Game_Map::ConstructMapName(4, false)) == nullptr);
+
+	MapPreloader::Clear();
+	MapPreloader::SetBudget(MapPreloader::default_budget);
+	MapPreloader::SetSimulatedLatency(0);
+	MapPreloader::SetLoader(nullptr);
+	Game_Map::MapFiles::Clear();
+}
+
+TEST_CASE("Disabled") {
+	MapPreloader::SetBudget(0);
+	MapPreloader::Start(MakeMap(), 1);
+	REQUIRE(MapPreloader::GetPendingMaps().empty());
+	MapPreloader::SetBudget(MapPreloader::default_budget);
+}
+
+TEST_SUITE_END();
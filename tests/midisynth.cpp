@@ -0,0 +1,101 @@
+#include "doctest.h"
+
+#ifdef WANT_FMMIDI
+
+#include "midisynth.h"
+#include <vector>
+
+TEST_SUITE_BEGIN("FmMidi Synth");
+
+static midisynth::FMPARAMETER make_param(int alg, int seed) {
+	midisynth::FMPARAMETER p;
+	p.ALG = alg;
+	p.FB = seed % 8;
+	p.LFO = (seed * 3) % 8;
+	auto op = [&](auto& o, int n) {
+		o.AR = (seed + n * 7) % 32;
+		o.DR = (seed * 5 + n) % 32;
+		o.SR = (seed * 3 + n * 11) % 32;
+		o.RR = (seed + n) % 16;
+		o.SL = (seed * 7 + n) % 16;
+		o.TL = (seed * 13 + n * 29) % 128;
+		o.KS = n % 4;
+		o.ML = (seed + n * 5) % 16;
+		o.DT = (seed + n) % 8;
+		o.AMS = (seed + n) % 4;
+	};
+	op(p.op1, 1);
+	op(p.op2, 2);
+	op(p.op3, 3);
+	op(p.op4, 4);
+	return p;
+}
+
+TEST_CASE("Block rendering matches per-sample rendering") {
+	constexpr int samples = 44100;
+	constexpr float rate = 44100.0f;
+
+	for (int alg = 0; alg < 8; ++alg) {
+		for (int seed = 0; seed < 4; ++seed) {
+			auto p = make_param(alg, seed + alg);
+			midisynth::fm_sound_generator ref(p, 48 + seed * 7, 1.0f);
+			midisynth::fm_sound_generator blk(p, 48 + seed * 7, 1.0f);
+			for (auto* fm : { &ref, &blk }) {
+				fm->set_rate(rate);
+				if (seed & 1) {
+					fm->set_vibrato(0.5f, 5.0f);
+				}
+				if (seed & 2) {
+					fm->set_tremolo(64, 3.0f);
+				}
+			}
+
+			std::vector<int_least32_t> a(samples), b(samples);
+			int pos = 0;
+			// Odd chunk sizes to cross block boundaries and envelope transitions
+			for (int chunk : { 1, 77, 128, 129, 1000, 3333 }) {
+				for (int i = 0; i < chunk; ++i) {
+					a[pos + i] = ref.get_next();
+				}
+				blk.get_block(&b[pos], chunk);
+				pos += chunk;
+			}
+			ref.key_off();
+			blk.key_off();
+			int rest = samples - pos;
+			for (int i = 0; i < rest; ++i) {
+				a[pos + i] = ref.get_next();
+			}
+			blk.get_block(&b[pos], rest);
+
+			CHECK_EQ(a, b);
+			CHECK_EQ(ref.is_finished(), blk.is_finished());
+		}
+	}
+}
+
+TEST_CASE("Polyphony limit steals voices") {
+	midisynth::fm_note_factory factory;
+	midisynth::synthesizer synth(&factory);
+	synth.set_polyphony(4);
+
+	for (int note = 60; note < 68; ++note) {
+		synth.note_on(0, note, 100);
+	}
+	CHECK_EQ(synth.get_num_notes(), 4);
+
+	// Released notes are stolen before held ones
+	synth.note_off(0, 64, 64);
+	synth.note_on(1, 40, 100);
+	CHECK_EQ(synth.get_num_notes(), 4);
+	CHECK_EQ(synth.get_channel(1)->get_num_notes(), 1);
+	CHECK_EQ(synth.get_channel(0)->get_num_notes(), 3);
+
+	synth.set_polyphony(0);
+	synth.note_on(2, 50, 100);
+	CHECK_EQ(synth.get_num_notes(), 5);
+}
+
+TEST_SUITE_END();
+
+#endif
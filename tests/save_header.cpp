@@ -0,0 +1,61 @@
+#include "save_header.h"
+#include "doctest.h"
+#include <lcf/lsd/reader.h>
+#include <sstream>
+
+static std::string MakeSave() {
+	lcf::rpg::Save save;
+	save.title.hero_name = "Alex";
+	save.title.hero_level = 42;
+	save.title.hero_hp = 999;
+	save.title.face1_name = "Actor1";
+	save.title.face1_id = 3;
+	save.title.timestamp = 45000.5;
+	save.system.variables.resize(10000, 7);
+
+	std::stringstream ss;
+	lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k, "UTF-8");
+	return ss.str();
+}
+
+TEST_SUITE_BEGIN("SaveHeader");
+
+TEST_CASE("Load") {
+	const auto data = MakeSave();
+	std::istringstream is(data);
+
+	auto save = SaveHeader::Load(is, "UTF-8");
+	REQUIRE(save);
+	REQUIRE_EQ(save->title.hero_name, "Alex");
+	REQUIRE_EQ(save->title.hero_level, 42);
+	REQUIRE_EQ(save->title.hero_hp, 999);
+	REQUIRE_EQ(save->title.face1_name, "Actor1");
+	REQUIRE_EQ(save->title.face1_id, 3);
+	REQUIRE_EQ(save->title.timestamp, 45000.5);
+	REQUIRE(save->system.variables.empty());
+}
+
+TEST_CASE("Invalid") {
+	std::istringstream empty("");
+	REQUIRE_FALSE(SaveHeader::Load(empty, "UTF-8"));
+
+	std::istringstream other("\x0bLcfDataBase\x0b\x01\x00");
+	REQUIRE_FALSE(SaveHeader::Load(other, "UTF-8"));
+
+	const auto data = MakeSave();
+	std::istringstream truncated(data.substr(0, 20));
+	REQUIRE_FALSE(SaveHeader::Load(truncated, "UTF-8"));
+}
+
+TEST_CASE("Truncated after title") {
+	const auto data = MakeSave();
+
+	// Cut inside of the variables
+	std::istringstream truncated(data.substr(0, data.size() / 2));
+	REQUIRE_FALSE(SaveHeader::Load(truncated, "UTF-8"));
+
+	std::istringstream complete(data);
+	REQUIRE(SaveHeader::Load(complete, "UTF-8"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,64 @@
+#include "save_writer.h"
+#include "doctest.h"
+#include <lcf/lsd/reader.h>
+#include <sstream>
+#include <vector>
+
+static lcf::rpg::Save MakeSave(int num_vars) {
+	lcf::rpg::Save save;
+	save.title.hero_level = 12;
+	for (int i = 0; i < num_vars; ++i) {
+		save.system.variables.push_back(i * 3);
+	}
+	return save;
+}
+
+TEST_SUITE_BEGIN("SaveWriter");
+
+TEST_CASE("Serialize") {
+	std::vector<int> order;
+	std::string data;
+
+	SaveWriter::Serialize(MakeSave(1000), lcf::EngineVersion::e2k, "UTF-8", [&](bool success, std::string_view d) {
+		REQUIRE(success);
+		order.push_back(1);
+		data = std::string(d);
+	});
+	SaveWriter::Serialize(MakeSave(10), lcf::EngineVersion::e2k3, "UTF-8", [&](bool success, std::string_view) {
+		REQUIRE(success);
+		order.push_back(2);
+	});
+
+	// Callbacks only run from Update or Wait
+	REQUIRE(order.empty());
+	REQUIRE_EQ(SaveWriter::GetPendingCount(), 2);
+
+	SaveWriter::Wait();
+	REQUIRE_EQ(order, std::vector<int>{ 1, 2 });
+	REQUIRE_EQ(SaveWriter::GetPendingCount(), 0);
+
+	std::istringstream is(data);
+	auto save = lcf::LSD_Reader::Load(is, "UTF-8");
+	REQUIRE(save);
+	REQUIRE_EQ(save->title.hero_level, 12);
+	REQUIRE_EQ(save->system.variables.size(), 1000);
+	REQUIRE_EQ(save->system.variables[999], 999 * 3);
+
+	SaveWriter::Quit();
+}
+
+TEST_CASE("Update") {
+	bool called = false;
+	SaveWriter::Serialize(MakeSave(10), lcf::EngineVersion::e2k, "UTF-8", [&](bool, std::string_view) {
+		called = true;
+	});
+
+	while (!called) {
+		SaveWriter::Update();
+	}
+	REQUIRE_EQ(SaveWriter::GetPendingCount(), 0);
+
+	SaveWriter::Quit();
+}
+
+TEST_SUITE_END();
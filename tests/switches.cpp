@@ -123,6 +123,41 @@ TEST_CASE("FlipRange") {
 	REQUIRE_FALSE(s.Get(n + 1));
 }
 
+TEST_CASE("RangeWordBoundaries") {
+	auto s = make();
+
+	// Crosses several words with a partial first and last word
+	s.SetRange(60, 200, true);
+	REQUIRE_EQ(s.GetSize(), 200);
+	REQUIRE_FALSE(s.Get(59));
+	REQUIRE(s.Get(60));
+	REQUIRE(s.Get(64));
+	REQUIRE(s.Get(65));
+	REQUIRE(s.Get(200));
+	REQUIRE_EQ(s.CountRange(1, 200), 141);
+
+	s.FlipRange(64, 129);
+	REQUIRE(s.Get(63));
+	REQUIRE_FALSE(s.Get(64));
+	REQUIRE_FALSE(s.Get(129));
+	REQUIRE(s.Get(130));
+	REQUIRE_EQ(s.CountRange(1, 200), 141 - 66);
+	REQUIRE_EQ(s.CountRange(64, 129), 0);
+	REQUIRE_EQ(s.CountRange(-5, 1000), 141 - 66);
+
+	// Growing does not turn on switches outside the range
+	s.SetRange(250, 300, false);
+	REQUIRE_EQ(s.GetSize(), 300);
+	REQUIRE_EQ(s.CountRange(201, 300), 0);
+
+	auto data = s.GetData();
+	REQUIRE_EQ(data.size(), 300);
+	Game_Switches s2;
+	s2.SetData(data);
+	REQUIRE(s2.GetData() == data);
+	REQUIRE_EQ(s2.CountRange(1, 300), 141 - 66);
+}
+
 TEST_CASE("GetSize") {
 	auto s = make();
 	REQUIRE_EQ(s.GetSizeWithLimit(), max_switches);
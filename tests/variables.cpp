@@ -555,6 +555,70 @@ TEST_CASE("Overflow/Underflow") {
 	REQUIRE(v.Get(1) == _min);
 }
 
+TEST_CASE("Overflow/Underflow Range") {
+	lcf::Data::variables.resize(max_vars);
+
+	auto _min = std::numeric_limits<Game_Variables::Var_t>::min();
+	auto _max = std::numeric_limits<Game_Variables::Var_t>::max();
+
+	Game_Variables v(_min, _max);
+	v.SetWarning(0);
+
+	// Enough variables for the vectorized loops
+	constexpr int n = 37;
+	auto reset = [&]() {
+		for (int i = 1; i <= n; ++i) {
+			v.Set(i, (i % 2) ? _max : _min);
+		}
+	};
+
+	reset();
+	v.AddRange(1, n, 1);
+	REQUIRE_EQ(v.Get(1), _max);
+	REQUIRE_EQ(v.Get(2), _min + 1);
+
+	reset();
+	v.AddRange(1, n, -1);
+	REQUIRE_EQ(v.Get(1), _max - 1);
+	REQUIRE_EQ(v.Get(2), _min);
+
+	reset();
+	v.SubRange(1, n, -1);
+	REQUIRE_EQ(v.Get(1), _max);
+	REQUIRE_EQ(v.Get(2), _min + 1);
+
+	reset();
+	v.SubRange(1, n, 1);
+	REQUIRE_EQ(v.Get(1), _max - 1);
+	REQUIRE_EQ(v.Get(2), _min);
+
+	reset();
+	v.MultRange(1, n, -2);
+	REQUIRE_EQ(v.Get(1), _min);
+	REQUIRE_EQ(v.Get(2), _max);
+
+	reset();
+	v.Set(n + 1, 2);
+	v.MultRangeVariable(1, n, n + 1);
+	REQUIRE_EQ(v.Get(1), _max);
+	REQUIRE_EQ(v.Get(n), _max);
+	REQUIRE_EQ(v.Get(2), _min);
+
+	reset();
+	v.AddArray(1, n - 1, 2);
+	REQUIRE_EQ(v.Get(1), -1);
+	REQUIRE_EQ(v.Get(n - 1), -1);
+	REQUIRE_EQ(v.Get(n), _max);
+
+	for (int i = 1; i <= n; ++i) {
+		v.Set(i, _min + 1);
+	}
+	v.SubArray(1, 10, 11);
+	REQUIRE_EQ(v.Get(1), 0);
+	v.AddArray(11, 20, 21);
+	REQUIRE_EQ(v.Get(11), _min);
+}
+
 TEST_CASE("Enumerate") {
 	auto s = make();
 